@@ -258,6 +258,152 @@ namespace {
     ->Args({4900, 4900, 3})
     ->Args({5000, 5000, 3})
     ->Threads(1);
+
+    /**
+     * the register blocked kernels, func_pos 3 to 8, on long and wide catalogs where the matrix streams
+     * from DRAM
+     */
+    void blocked_gemv_args(benchmark::internal::Benchmark *bench) {
+        for (long const pos: {3, 4, 5, 6, 7, 8}) {
+            bench->Args({100000, 128, pos});
+            bench->Args({20000, 1024, pos});
+            bench->Args({5000, 4096, pos});
+            bench->Args({1000, 65536, pos});
+        }
+    }
+
+    BENCHMARK_REGISTER_F(CPUFixture, BatchedDotProduct)
+    ->Apply(blocked_gemv_args)
+    ->Threads(1);
+
+    BENCHMARK_DEFINE_F(CPUFixture, MatrixProduct)(benchmark::State &st) {
+        size_t const dim{static_cast<size_t>(st.range(0))};
+        size_t const pos{static_cast<size_t>(st.range(1))};
+
+        cobraml::core::func_pos = pos;
+
+        cobraml::core::Matrix const mat_a = from_vector(
+            create_vector(dim, dim), cobraml::core::CPU);
+
+        cobraml::core::Matrix const mat_b = from_vector(
+            create_vector(dim, dim), cobraml::core::CPU);
+
+        cobraml::core::Matrix res(dim, dim, cobraml::core::CPU, cobraml::core::FLOAT64);
+
+        constexpr double alpha1{1};
+
+        for (auto _: st) {
+            gemm(mat_a, mat_b, res, alpha1, alpha1);
+        }
+
+        st.counters["rows"] = dim;
+        st.counters["columns"] = dim;
+        st.counters["type"] = pos;
+    }
+
+    BENCHMARK_REGISTER_F(CPUFixture, MatrixProduct)
+    ->Args({128, 0})
+    ->Args({256, 0})
+    ->Args({512, 0})
+    ->Args({1024, 0})
+
+    ->Args({128, 1})
+    ->Args({256, 1})
+    ->Args({512, 1})
+    ->Args({1024, 1})
+    ->Args({2048, 1})
+    ->Threads(1);
+
+    BENCHMARK_DEFINE_F(CPUFixture, AcceleratedDotProduct)(benchmark::State &st) {
+        size_t const rows{static_cast<size_t>(st.range(0))};
+        size_t const col{static_cast<size_t>(st.range(1))};
+        auto const level{static_cast<cobraml::core::SimdLevel>(st.range(2))};
+
+        if (cobraml::core::detected_simd_level() < level) {
+            st.SkipWithError("instruction set not supported on this host");
+            return;
+        }
+
+        cobraml::core::set_simd_level(level);
+
+        cobraml::core::Matrix const mat = from_vector(
+            create_vector(rows, col), cobraml::core::CPU_X);
+
+        cobraml::core::Matrix const vec = from_vector(
+            create_vector(1, col), cobraml::core::CPU_X);
+
+        cobraml::core::Matrix res(1, rows, cobraml::core::CPU_X, cobraml::core::FLOAT64);
+
+        constexpr double alpha1{1};
+
+        for (auto _: st) {
+            gemv(mat, vec, res, alpha1, alpha1);
+        }
+
+        cobraml::core::set_simd_level(cobraml::core::detected_simd_level());
+
+        st.counters["rows"] = rows;
+        st.counters["columns"] = col;
+        st.counters["type"] = static_cast<double>(level);
+    }
+
+    BENCHMARK_REGISTER_F(CPUFixture, AcceleratedDotProduct)
+    ->Args({1000, 1000, cobraml::core::SSE})
+    ->Args({2000, 2000, cobraml::core::SSE})
+    ->Args({5000, 5000, cobraml::core::SSE})
+
+    ->Args({1000, 1000, cobraml::core::AVX2})
+    ->Args({2000, 2000, cobraml::core::AVX2})
+    ->Args({5000, 5000, cobraml::core::AVX2})
+
+    ->Args({1000, 1000, cobraml::core::AVX512})
+    ->Args({2000, 2000, cobraml::core::AVX512})
+    ->Args({5000, 5000, cobraml::core::AVX512})
+    ->Threads(1);
+
+    BENCHMARK_DEFINE_F(CPUFixture, MultiQueryDotProduct)(benchmark::State &st) {
+        size_t const rows{static_cast<size_t>(st.range(0))};
+        size_t const col{static_cast<size_t>(st.range(1))};
+        size_t const query_count{static_cast<size_t>(st.range(2))};
+        bool const batched{st.range(3) == 1};
+
+        cobraml::core::Matrix const mat = from_vector(
+            create_vector(rows, col), cobraml::core::CPU);
+
+        cobraml::core::Matrix const queries = from_vector(
+            create_vector(query_count, col), cobraml::core::CPU);
+
+        cobraml::core::Matrix res(query_count, rows, cobraml::core::CPU, cobraml::core::FLOAT64);
+
+        constexpr double alpha1{1};
+
+        for (auto _: st) {
+            if (batched) {
+                gemv_batched(mat, queries, res, alpha1, alpha1);
+                continue;
+            }
+
+            for (size_t q = 0; q < query_count; ++q) {
+                cobraml::core::Matrix row = res[q];
+                gemv(mat, queries[q], row, alpha1, alpha1);
+            }
+        }
+
+        st.counters["rows"] = rows;
+        st.counters["columns"] = col;
+        st.counters["queries"] = query_count;
+        st.counters["type"] = batched;
+    }
+
+    BENCHMARK_REGISTER_F(CPUFixture, MultiQueryDotProduct)
+    ->Args({5000, 5000, 8, 0})
+    ->Args({5000, 5000, 32, 0})
+    ->Args({20000, 1000, 32, 0})
+
+    ->Args({5000, 5000, 8, 1})
+    ->Args({5000, 5000, 32, 1})
+    ->Args({20000, 1000, 32, 1})
+    ->Threads(1);
 }
 
 BENCHMARK_MAIN();
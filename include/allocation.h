@@ -0,0 +1,110 @@
+//
+// Created by sriram on 2/14/25.
+//
+
+#ifndef ALLOCATION_H
+#define ALLOCATION_H
+
+#include <cstddef>
+#include "enums.h"
+
+namespace cobraml::core {
+    class Array;
+
+    enum AllocatorKind {
+        STANDARD, // every buffer is allocated from and returned to the system
+        POOLED    // freed buffers are cached in size class free lists and reused
+    };
+
+    /**
+     * how the memory of a new Array or Matrix is initialized
+     */
+    enum AllocationPolicy {
+        ZEROED,        // zeroed on the calling thread
+        UNINITIALIZED, // left as the allocator returns it, for buffers that are fully written before being read
+        FIRST_TOUCH    // zeroed in parallel with the row partition of the gemv kernels, so pages land on the
+                       // NUMA node of the thread that streams them
+    };
+
+    struct AllocatorStats {
+        size_t hits;            // allocations served from a free list
+        size_t misses;          // allocations that went to the system
+        size_t bytes_retained;  // bytes sitting in free lists, ready for reuse
+    };
+
+    /**
+     * how the standard allocator backs buffers at or above the huge page threshold
+     */
+    enum HugePageMode {
+        NO_HUGE_PAGES,          // large buffers are allocated like any other
+        TRANSPARENT_HUGE_PAGES, // 2 MB aligned anonymous mappings advised with MADV_HUGEPAGE
+        HUGETLBFS_PAGES         // explicit MAP_HUGETLB mappings from the reserved pool, falls back to
+                                // TRANSPARENT_HUGE_PAGES when the pool is exhausted
+    };
+
+    struct HugePageStats {
+        size_t buffers;            // live buffers on the huge page path
+        size_t bytes;              // bytes mapped for those buffers
+        size_t hugetlbfs_buffers;  // live buffers backed by reserved hugetlbfs pages
+        size_t fallback_buffers;   // hugetlbfs requests served with transparent huge pages, since start up
+    };
+
+    /**
+     * configures the huge page path of the standard allocator, buffers already allocated are unaffected
+     *
+     * @param mode how buffers at or above the threshold are backed
+     * @param threshold the smallest buffer in bytes taking the huge page path
+     */
+    void set_huge_page_mode(HugePageMode mode, size_t threshold);
+
+    /**
+     * @return how large buffers are currently backed
+     */
+    HugePageMode get_huge_page_mode();
+
+    /**
+     * @return the smallest buffer in bytes taking the huge page path
+     */
+    size_t get_huge_page_threshold();
+
+    /**
+     * @return counters of the huge page path of the standard allocator
+     */
+    HugePageStats get_huge_page_stats();
+
+    /**
+     * reads /proc/self/smaps to find how much of the memory behind an array is currently backed by huge
+     * pages, transparent huge pages are only assigned once pages are touched
+     *
+     * @param array the array to inspect
+     * @return the huge page backed bytes of the mapping holding the array, 0 for buffers off the huge page path
+     */
+    size_t huge_page_bytes(const Array &array);
+
+    /**
+     * selects the allocator used by buffers created on a device from now on, existing buffers keep the
+     * allocator they were created with
+     *
+     * @param device the device
+     * @param kind the allocator
+     */
+    void set_allocator_kind(Device device, AllocatorKind kind);
+
+    /**
+     * @return the allocator new buffers on the device are created with
+     */
+    AllocatorKind get_allocator_kind(Device device);
+
+    /**
+     * @return the counters of the pooled allocator of a device, counted since start up
+     */
+    AllocatorStats get_allocator_stats(Device device);
+
+    /**
+     * returns the memory retained by the pooled allocator of a device to the system, blocks cached by
+     * threads other than the caller are released when those threads exit
+     */
+    void release_retained_memory(Device device);
+}
+
+#endif //ALLOCATION_H
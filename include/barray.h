@@ -4,17 +4,48 @@
 
 #ifndef BARRAY_H
 #define BARRAY_H
+#include <functional>
 #include <memory>
 #include <vector>
+#include "allocation.h"
 #include "enums.h"
 
 namespace cobraml::core {
+    class Buffer;
+
     class Array {
 
     protected:
         struct ArrayImpl;
         std::unique_ptr<ArrayImpl> impl;
 
+        /**
+         * constructor that wraps an existing buffer instead of allocating one
+         * @param buffer the buffer, it must hold at least total_items elements of dtype
+         * @param total_items the number of elements in the array
+         * @param device the device of the buffer
+         * @param dtype the dtype of the array being constructed
+         */
+        Array(std::shared_ptr<Buffer> buffer, size_t total_items, Device device, Dtype dtype);
+
+        /**
+         * constructor that adopts memory the library did not allocate, nothing is copied
+         * @param data the memory, it must hold at least total_items elements of dtype
+         * @param total_items the number of elements in the array
+         * @param device the device of the memory
+         * @param dtype the dtype of the array being constructed
+         * @param release called once when the last array using the memory is destroyed
+         */
+        Array(void *data, size_t total_items, Device device, Dtype dtype, std::function<void()> release);
+
+        /**
+         * zeroes the array from the threads that own each block of rows in the gemv kernels
+         *
+         * @param rows the number of rows the array is split into
+         * @param row_bytes the size of one row in bytes
+         */
+        void first_touch(size_t rows, size_t row_bytes) const;
+
         void increment_offset(unsigned long inc);
         void set_length(unsigned long len);
 
@@ -25,12 +56,26 @@ namespace cobraml::core {
          */
         [[nodiscard]] void *get_raw_buffer() const;
 
+        /**
+         * get the raw pointer backing an array in order to write to it, state cached on the buffer
+         * such as row norms is dropped
+         *
+         * @return a raw void pointer to the buffer data
+         */
+        [[nodiscard]] void *get_writable_buffer() const;
+
+        /**
+         * stops caching row norms on the buffer, for memory that may be written outside the library
+         */
+        void disable_norm_cache() const;
+
         /**
          * replace a segment of the array buffer with a different buffer
          * @param source the replacement data
          * @param items how many items we are extracting
+         * @param start the element the segment starts at
          */
-        void replace_segment(const void * source, size_t items) const;
+        void replace_segment(const void * source, size_t items, size_t start = 0) const;
 
         template<typename T>
         void copy_vector(const std::vector<T> &vec) {
@@ -52,29 +97,272 @@ namespace cobraml::core {
 
         /**
          * Generalized Matrix Vector Multiplication.
-         * Performs y=αAx+βy
+         * Performs y=αAx+βy, or y=αAᵀx+βy when transpose is set
          *
          * @param matrix A
          * @param vector x
-         * @param rows
-         * @param columns
+         * @param rows rows of A as stored
+         * @param columns columns of A as stored
+         * @param leading_dimension elements between the starts of consecutive rows of A
          * @param alpha α
          * @param beta β
+         * @param transpose whether to multiply by Aᵀ
          */
         void gemv(
             const Array &matrix,
             const Array &vector,
             size_t rows,
             size_t columns,
+            size_t leading_dimension,
+            const void * alpha,
+            const void * beta,
+            bool transpose);
+
+        /**
+         * Generalized Matrix Matrix Multiplication.
+         * Performs C=αAB+βC
+         *
+         * @param matrix_a A
+         * @param matrix_b B
+         * @param rows rows of A and C
+         * @param shared columns of A and rows of B
+         * @param columns columns of B and C
+         * @param alpha α
+         * @param beta β
+         */
+        void gemm(
+            const Array &matrix_a,
+            const Array &matrix_b,
+            size_t rows,
+            size_t shared,
+            size_t columns,
+            const void * alpha,
+            const void * beta);
+
+        /**
+         * Batched Generalized Matrix Vector Multiplication.
+         * Performs Y=αXAᵀ+βY
+         *
+         * @param matrix A
+         * @param queries X, one query vector per row
+         * @param rows rows of A
+         * @param columns columns of A and X
+         * @param query_count rows of X
+         * @param alpha α
+         * @param beta β
+         */
+        void gemv_batched(
+            const Array &matrix,
+            const Array &queries,
+            size_t rows,
+            size_t columns,
+            size_t query_count,
+            const void * alpha,
+            const void * beta);
+
+        /**
+         * Selects the k largest entries of αAx, this array receives the scores
+         *
+         * @param matrix A
+         * @param vector x
+         * @param indices receives the selected row indices, must be INT64
+         * @param rows rows of A
+         * @param columns columns of A
+         * @param k how many rows to select
+         * @param alpha α
+         */
+        void gemv_topk(
+            const Array &matrix,
+            const Array &vector,
+            Array &indices,
+            size_t rows,
+            size_t columns,
+            size_t k,
+            const void * alpha);
+
+        /**
+         * Cosine similarity Matrix Vector Multiplication.
+         * Performs y=α(Ax / (‖Aᵢ‖‖x‖))+βy, the row norms of A are computed on first use and cached
+         * alongside its buffer until the buffer is written again
+         *
+         * @param matrix A
+         * @param vector x
+         * @param rows rows of A
+         * @param columns columns of A
+         * @param alpha α
+         * @param beta β
+         */
+        void gemv_cosine(
+            const Array &matrix,
+            const Array &vector,
+            size_t rows,
+            size_t columns,
+            const void * alpha,
+            const void * beta);
+
+        /**
+         * per row int8 quantization of source into this INT8 array
+         *
+         * @param source the FLOAT32 data to quantize
+         * @param scales receives one FLOAT32 scale per row
+         * @param zero_points receives one INT32 zero point per row
+         * @param rows rows of source
+         * @param columns columns of source
+         */
+        void quantize(
+            const Array &source,
+            const Array &scales,
+            const Array &zero_points,
+            size_t rows,
+            size_t columns);
+
+        /**
+         * reverses quantize, writing the FLOAT32 approximation of source into this array
+         */
+        void dequantize(
+            const Array &source,
+            const Array &scales,
+            const Array &zero_points,
+            size_t rows,
+            size_t columns);
+
+        /**
+         * Quantized Matrix Vector Multiplication.
+         * Performs y=αAx+βy where A is INT8 with per row scales and zero points and x, y are FLOAT32
+         */
+        void quantized_gemv(
+            const Array &matrix,
+            const Array &scales,
+            const Array &zero_points,
+            const Array &vector,
+            size_t rows,
+            size_t columns,
+            float alpha,
+            float beta);
+
+        /**
+         * Sparse Matrix Vector Multiplication.
+         * Performs y=αAx+βy where A is stored in CSR form
+         *
+         * @param row_pointers INT64 offsets of the rows into values, rows + 1 of them
+         * @param column_indices INT64 column of every nonzero
+         * @param values the nonzeros
+         * @param vector x
+         * @param rows rows of A
+         * @param alpha α
+         * @param beta β
+         */
+        void sparse_gemv(
+            const Array &row_pointers,
+            const Array &column_indices,
+            const Array &values,
+            const Array &vector,
+            size_t rows,
             const void * alpha,
             const void * beta);
 
+        /**
+         * General Matrix Vector Multiplication against a sparse x.
+         * Performs y=αAx+βy, or y=αAᵀx+βy when transpose is set
+         *
+         * @param matrix A
+         * @param indices INT64 position of every nonzero of x
+         * @param values the nonzeros of x
+         * @param rows rows of A
+         * @param columns columns of A
+         * @param leading_dimension the distance in elements between the starts of consecutive rows of A
+         * @param nonzeros the number of nonzeros of x
+         * @param alpha α
+         * @param beta β
+         * @param transpose multiply by Aᵀ
+         */
+        void sparse_query_gemv(
+            const Array &matrix,
+            const Array &indices,
+            const Array &values,
+            size_t rows,
+            size_t columns,
+            size_t leading_dimension,
+            size_t nonzeros,
+            const void * alpha,
+            const void * beta,
+            bool transpose);
+
+        /**
+         * dot product of the first length elements of this array and other
+         * @param dest receives the result, a single element of the dtype
+         */
+        void dot(const Array &other, size_t length, void *dest) const;
+
+        /**
+         * this = αx + this over the first length elements
+         */
+        void axpy(const Array &x, size_t length, const void *alpha);
+
+        /**
+         * this = α * this over the first length elements
+         */
+        void scal(size_t length, const void *alpha);
+
+        /**
+         * @param dest receives the euclidean norm of the first length elements, a single element of the dtype
+         */
+        void nrm2(size_t length, void *dest) const;
+
+        /**
+         * @param dest receives the sum of magnitudes of the first length elements, a single element of the dtype
+         */
+        void asum(size_t length, void *dest) const;
+
+        /**
+         * @return the index of the first of the first length elements with the largest magnitude
+         */
+        [[nodiscard]] size_t iamax(size_t length) const;
+
+        /**
+         * reduces every row of matrix into this array
+         *
+         * @param matrix A
+         * @param rows rows of A, the length of this array
+         * @param columns columns of A
+         * @param leading_dimension the distance in elements between the starts of consecutive rows of A
+         * @param reduction the reduction, this array is INT64 for ARGMAX and of the dtype of A otherwise
+         */
+        void reduce_rows(
+            const Array &matrix, size_t rows, size_t columns, size_t leading_dimension, Reduction reduction);
+
+        /**
+         * reduces every column of matrix into this array
+         *
+         * @param matrix A
+         * @param rows rows of A
+         * @param columns columns of A, the length of this array
+         * @param leading_dimension the distance in elements between the starts of consecutive rows of A
+         * @param reduction the reduction, this array is INT64 for ARGMAX and of the dtype of A otherwise
+         */
+        void reduce_columns(
+            const Array &matrix, size_t rows, size_t columns, size_t leading_dimension, Reduction reduction);
+
     public:
-        Array(size_t total_items, Device device, Dtype dtype);
+        /**
+         * @param total_items the number of elements in the array
+         * @param device the device of the array being constructed
+         * @param dtype the dtype of the array being constructed
+         * @param policy how the elements are initialized, FIRST_TOUCH partitions the array element by element
+         */
+        Array(size_t total_items, Device device, Dtype dtype, AllocationPolicy policy = ZEROED);
         virtual ~Array();
         Array();
         Array(const Array &other);
         Array& operator=(const Array& other);
+
+        /**
+         * takes over the buffer of other without touching its reference count, other is left empty as if
+         * default constructed
+         */
+        Array(Array &&other) noexcept;
+        Array& operator=(Array &&other) noexcept;
+
         [[nodiscard]] size_t len() const;
         virtual void deep_copy(Array &other);
 
@@ -96,8 +384,31 @@ namespace cobraml::core {
         template<typename T>
         friend const T *get_buffer(const Array &arr);
 
+        friend size_t huge_page_bytes(const Array &array);
+
+        template<typename T>
+        friend Array from_vector(const std::vector<T> &vec, Device device, Dtype dtype);
+
+        /**
+         * adopts the storage of vec instead of copying it, vec is left empty
+         */
         template<typename T>
-        friend Array from_vector(std::vector<T> vec, Device device, Dtype dtype);
+        friend Array from_vector(std::vector<T> &&vec, Device device, Dtype dtype);
+
+        /**
+         * constructs an array over memory owned outside the library, such as a buffer handed over by another
+         * library. Nothing is copied unless data is misaligned for dtype, then it is copied into a new buffer
+         * and release is called before returning. The owner may keep writing wrapped memory, so row norms are
+         * never cached for it.
+         *
+         * @param data the memory, it must hold at least total_items elements of dtype
+         * @param total_items the number of elements in the array
+         * @param device the device of the memory
+         * @param dtype the dtype of data
+         * @param release called once when the last array using the memory is destroyed
+         * @return the array
+         */
+        friend Array wrap(void *data, size_t total_items, Device device, Dtype dtype, std::function<void()> release);
 
         Array operator[](size_t index) const;
 
@@ -144,12 +455,42 @@ namespace cobraml::core {
         return static_cast<T *>(arr.get_raw_buffer());
     }
 
+    /**
+     * checks whether data meets the alignment the kernels assume for dtype, the natural alignment of its
+     * element type
+     */
+    bool is_aligned(const void *data, Dtype dtype);
+
+    Array wrap(void *data, size_t total_items, Device device, Dtype dtype, std::function<void()> release);
+
+    /**
+     * as above, owner is kept alive until the last array using the memory is destroyed
+     */
+    inline Array wrap(
+        void *data, size_t const total_items, Device const device, Dtype const dtype, std::shared_ptr<const void> owner) {
+        return wrap(data, total_items, device, dtype, [owner]() mutable { owner.reset(); });
+    }
+
     template<typename T>
-    Array from_vector(std::vector<T> vec, Device const device, Dtype const dtype) {
-        Array ret(vec.size(), device, dtype);
+    Array from_vector(const std::vector<T> &vec, Device const device, Dtype const dtype) {
+        Array ret(vec.size(), device, dtype, UNINITIALIZED);
         ret.copy_vector(vec);
         return ret;
     }
+
+    template<typename T>
+    Array from_vector(std::vector<T> &&vec, Device const device, Dtype const dtype) {
+        // the copying overload reports mismatched dtypes
+        if (vec.empty() || dtype != get_dtype_from_type<T>::type) {
+            return from_vector(static_cast<const std::vector<T> &>(vec), device, dtype);
+        }
+
+        auto owner{std::make_shared<std::vector<T>>(std::move(vec))};
+        void *data{owner->data()};
+        size_t const total_items{owner->size()};
+
+        return {data, total_items, device, dtype, [owner]() mutable { owner.reset(); }};
+    }
 }
 
 #endif //BARRAY_H
@@ -0,0 +1,59 @@
+/*
+ * Created by sriram on 2/27/25.
+ */
+
+#ifndef CML_C_API_H
+#define CML_C_API_H
+
+#include <stddef.h>
+#include "dlpack/dlpack.h"
+
+/*
+ * Stable C interface for hosts that cannot link against C++, such as Python through ctypes or Rust through
+ * bindgen. Matrices cross the boundary as DLPack tensors, nothing is copied in either direction unless an
+ * imported tensor is misaligned for its dtype.
+ *
+ * Every function returning int returns 0 on success and -1 on failure, cml_last_error then describes the
+ * failure. Out parameters are only written on success.
+ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * an owning handle to a matrix, release it with cml_matrix_free
+ */
+typedef struct CmlMatrix CmlMatrix;
+
+/*
+ * the message of the last failure on the calling thread, it stays valid until the next call made on that thread
+ */
+const char *cml_last_error(void);
+
+/*
+ * imports a CPU tensor with one or two dimensions, it must be row major and compact. On success the matrix owns
+ * the tensor and calls its deleter once the memory is no longer used, on failure the tensor still belongs to
+ * the caller.
+ *
+ * accelerated selects the CPU_X kernels when non zero
+ */
+int cml_matrix_from_dlpack(DLManagedTensor *tensor, int accelerated, CmlMatrix **matrix);
+
+/*
+ * exports a matrix as a two dimensional tensor sharing its memory, the memory stays alive until both the
+ * tensor's deleter has been called and every matrix using it has been freed
+ */
+int cml_matrix_to_dlpack(const CmlMatrix *matrix, DLManagedTensor **tensor);
+
+int cml_matrix_shape(const CmlMatrix *matrix, size_t *rows, size_t *columns);
+
+/*
+ * frees the handle, null is ignored
+ */
+void cml_matrix_free(CmlMatrix *matrix);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CML_C_API_H */
@@ -0,0 +1,49 @@
+//
+// Created by sriram on 2/27/25.
+//
+
+#ifndef DLPACK_EXCHANGE_H
+#define DLPACK_EXCHANGE_H
+
+#include "dlpack/dlpack.h"
+#include "matrix.h"
+
+/**
+ * Zero copy exchange of matrices with other frameworks through DLPack. Tensors are always two dimensional and
+ * row major, a matrix with a single row is exported with shape (1, columns).
+ *
+ *   Dtype      DLDataType
+ *   INT8       kDLInt 8
+ *   INT16      kDLInt 16
+ *   INT32      kDLInt 32
+ *   INT64      kDLInt 64
+ *   FLOAT32    kDLFloat 32
+ *   FLOAT64    kDLFloat 64
+ *   FLOAT16    kDLFloat 16
+ *   BFLOAT16   kDLBfloat 16
+ */
+namespace cobraml::core {
+
+    /**
+     * exports a matrix without copying it, the tensor shares the matrix's buffer. The consumer may write through
+     * the tensor, so row norms are no longer cached for the buffer.
+     *
+     * @param matrix a CPU or CPU_X matrix, views made by slice are exported with strides
+     * @return a tensor that keeps the buffer alive until its deleter is called
+     */
+    DLManagedTensor *to_dlpack(const Matrix &matrix);
+
+    /**
+     * imports a tensor without copying it, unless its data is misaligned for its dtype. The returned matrix
+     * takes ownership of the tensor and calls its deleter once the last matrix sharing the memory is destroyed.
+     * Row norms are not cached for imported memory, its producer may still write to it.
+     * If this throws the tensor is left untouched and still belongs to the caller.
+     *
+     * @param tensor a CPU tensor with one or two dimensions, it must be row major and compact
+     * @param device CPU or CPU_X
+     * @return the matrix, a one dimensional tensor becomes a single row
+     */
+    Matrix from_dlpack(DLManagedTensor *tensor, Device device = CPU);
+}
+
+#endif //DLPACK_EXCHANGE_H
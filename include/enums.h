@@ -6,6 +6,7 @@
 #define ENUMS_H
 #include <cstdint>
 #include <stdexcept>
+#include "half.h"
 
 namespace cobraml::core {
     enum Device {
@@ -21,6 +22,8 @@ namespace cobraml::core {
         INT64,
         FLOAT32,
         FLOAT64,
+        FLOAT16,    // storage only, computed in FLOAT32
+        BFLOAT16,   // storage only, computed in FLOAT32
         INVALID
     };
 
@@ -34,16 +37,69 @@ namespace cobraml::core {
             case INT64: return 8;
             case FLOAT32: return 4;
             case FLOAT64: return 8;
+            case FLOAT16: return 2;
+            case BFLOAT16: return 2;
             case INVALID: return 0;
         }
 
         return 0;
     }
 
+    /**
+     * instruction set levels the CPU_X device can dispatch to, ordered from narrowest to widest
+     */
+    enum SimdLevel {
+        SCALAR, // no hand vectorized kernels, CPU_X behaves like CPU
+        SSE,    // SSE4.1
+        AVX2,   // AVX2 + FMA + F16C
+        AVX512  // AVX-512 F, BW, DQ and VL + F16C
+    };
+
+    /**
+     * reductions over the rows or the columns of a matrix
+     */
+    enum Reduction {
+        SUM,
+        MAX,
+        ARGMAX, // the index of the first maximum, always INT64
+        MEAN    // summed in double, integer dtypes are rounded toward zero
+    };
+
+    /**
+     * @return True if the dtype is a half precision storage type
+     */
+    constexpr bool is_half(Dtype const type) {
+        return type == FLOAT16 || type == BFLOAT16;
+    }
+
+    /**
+     * @return the dtype arithmetic on the given dtype is performed in, half precision storage computes in FLOAT32
+     */
+    constexpr Dtype compute_dtype(Dtype const type) {
+        return is_half(type) ? FLOAT32 : type;
+    }
+
     extern unsigned char func_pos;
 
+    /**
+     * @return the widest instruction set level supported by both the host CPU and this build
+     */
+    SimdLevel detected_simd_level();
+
+    /**
+     * @return the instruction set level CPU_X kernels currently dispatch to
+     */
+    SimdLevel get_simd_level();
+
+    /**
+     * restricts CPU_X kernels to a narrower instruction set level, mostly useful for testing and benchmarking
+     * @param level the level to dispatch to, it cannot exceed detected_simd_level()
+     */
+    void set_simd_level(SimdLevel level);
+
     std::string dtype_to_string(Dtype dtype);
     std::string device_to_string(Device device);
+    std::string simd_level_to_string(SimdLevel level);
 
     inline void is_invalid(Dtype const dtype) {
         if (dtype == INVALID)
@@ -84,6 +140,16 @@ namespace cobraml::core {
     struct get_dtype_from_type<double> {
         static constexpr Dtype type = FLOAT64;
     };
+
+    template<>
+    struct get_dtype_from_type<float16> {
+        static constexpr Dtype type = FLOAT16;
+    };
+
+    template<>
+    struct get_dtype_from_type<bfloat16> {
+        static constexpr Dtype type = BFLOAT16;
+    };
 }
 
 #endif //ENUMS_H
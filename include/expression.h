@@ -0,0 +1,444 @@
+//
+// Created by sriram on 2/22/25.
+//
+
+#ifndef EXPRESSION_H
+#define EXPRESSION_H
+
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include "matrix.h"
+#include "threading.h"
+
+// elements per unit of parallel work, long enough to vectorize and short enough to split a single vector
+#define EXPRESSION_TILE 4096
+
+/**
+ * Lazy element wise arithmetic over matrices. Operators on matrices and scalars build an expression tree
+ * instead of computing anything, assigning the tree to a matrix evaluates it in one parallel pass with no
+ * temporaries:
+ *
+ *     result = 0.7f * scores + 0.3f * popularity - bias;
+ *     result = clamp(result * 2.0f, 0.0f, 1.0f);
+ *
+ * Every matrix in an expression must share the dtype and device of the destination and either its shape or,
+ * to broadcast across the rows, a single row of the same length. Scalars must have the type of the destination's
+ * dtype, as alpha and beta do elsewhere. The destination may appear in its own
+ * expression. When it appears as itself every element is read right before it is written, when an operand only
+ * overlaps it, such as a slice or a broadcast row of the destination, the expression is evaluated into a scratch
+ * matrix first and then copied over. FLOAT16 and BFLOAT16 are not supported.
+ */
+namespace cobraml::core {
+
+    /**
+     * base of every expression node
+     */
+    template<typename Derived>
+    class Expression {
+    public:
+        [[nodiscard]] const Derived &self() const {
+            return static_cast<const Derived &>(*this);
+        }
+    };
+
+    namespace expression_ops {
+        struct Add {
+            template<typename T>
+            static T apply(const T lhs, const T rhs) { return static_cast<T>(lhs + rhs); }
+        };
+
+        struct Subtract {
+            template<typename T>
+            static T apply(const T lhs, const T rhs) { return static_cast<T>(lhs - rhs); }
+        };
+
+        struct Multiply {
+            template<typename T>
+            static T apply(const T lhs, const T rhs) { return static_cast<T>(lhs * rhs); }
+        };
+
+        struct Divide {
+            template<typename T>
+            static T apply(const T lhs, const T rhs) { return static_cast<T>(lhs / rhs); }
+        };
+
+        struct Maximum {
+            template<typename T>
+            static T apply(const T lhs, const T rhs) { return std::max(lhs, rhs); }
+        };
+
+        struct Minimum {
+            template<typename T>
+            static T apply(const T lhs, const T rhs) { return std::min(lhs, rhs); }
+        };
+
+        struct Negate {
+            template<typename T>
+            static T apply(const T operand) { return static_cast<T>(-operand); }
+        };
+    }
+
+    /**
+     * the typed form of an expression that the evaluation loop reads element by element
+     */
+    template<typename T>
+    struct MatrixAccess {
+        const T *data;
+        // 0 when a single row is broadcast over the destination
+        size_t row_stride;
+
+        T operator()(const size_t row, const size_t column) const {
+            return data[row * row_stride + column];
+        }
+    };
+
+    template<typename T>
+    struct ScalarAccess {
+        T value;
+
+        T operator()(size_t, size_t) const {
+            return value;
+        }
+    };
+
+    template<typename Op, typename Lhs, typename Rhs>
+    struct BinaryAccess {
+        Lhs lhs;
+        Rhs rhs;
+
+        auto operator()(const size_t row, const size_t column) const {
+            return Op::apply(lhs(row, column), rhs(row, column));
+        }
+    };
+
+    template<typename Op, typename Operand>
+    struct UnaryAccess {
+        Operand operand;
+
+        auto operator()(const size_t row, const size_t column) const {
+            return Op::apply(operand(row, column));
+        }
+    };
+
+    class MatrixOperand : public Expression<MatrixOperand> {
+        std::reference_wrapper<const Matrix> matrix;
+
+    public:
+        explicit MatrixOperand(const Matrix &matrix): matrix(matrix) {
+        }
+
+        void check(const Matrix::Shape shape, const Device device, const Dtype dtype) const {
+            const Matrix &operand{matrix.get()};
+
+            if (operand.get_dtype() != dtype) {
+                throw std::runtime_error("expression operands and destination share different dtypes");
+            }
+
+            if (operand.get_device() != device) {
+                throw std::runtime_error("expression operands and destination are not on the same device");
+            }
+
+            if (Matrix::Shape const current{operand.get_shape()};
+                current.columns != shape.columns || (current.rows != shape.rows && current.rows != 1)) {
+                throw std::runtime_error("expression operand shape does not match or broadcast to the destination");
+            }
+        }
+
+        /**
+         * whether the operand reads memory of dest other than the element being written, evaluating in place
+         * would then read elements that were already overwritten
+         */
+        [[nodiscard]] bool overlaps(const Matrix &dest) const {
+            const Matrix &operand{matrix.get()};
+
+            if (dest.rows == 0 || operand.rows == 0)
+                return false;
+
+            const auto *operand_begin{static_cast<const char *>(operand.get_raw_buffer())};
+            const auto *dest_begin{static_cast<const char *>(dest.get_raw_buffer())};
+
+            if (operand_begin == dest_begin && operand.rows == dest.rows &&
+                operand.leading_dimension == dest.leading_dimension) {
+                return false;
+            }
+
+            size_t const bytes{dtype_to_bytes(dest.get_dtype())};
+            const char *operand_end{
+                operand_begin + ((operand.rows - 1) * operand.leading_dimension + operand.columns) * bytes};
+            const char *dest_end{dest_begin + ((dest.rows - 1) * dest.leading_dimension + dest.columns) * bytes};
+
+            return std::less<>{}(operand_begin, dest_end) && std::less<>{}(dest_begin, operand_end);
+        }
+
+        template<typename T>
+        [[nodiscard]] MatrixAccess<T> bind() const {
+            const Matrix &operand{matrix.get()};
+            size_t const row_stride{operand.get_shape().rows == 1 ? 0 : operand.get_leading_dimension()};
+            return {get_buffer<T>(operand), row_stride};
+        }
+    };
+
+    template<typename S>
+    class ScalarOperand : public Expression<ScalarOperand<S>> {
+        S value;
+
+    public:
+        explicit ScalarOperand(const S value): value(value) {
+        }
+
+        void check(Matrix::Shape, Device, const Dtype dtype) const {
+            if (constexpr Dtype given{get_dtype_from_type<S>::type}; given != dtype) {
+                throw std::runtime_error(
+                    "expression scalar has a invalid dtype, expected " + dtype_to_string(dtype));
+            }
+        }
+
+        [[nodiscard]] bool overlaps(const Matrix &) const {
+            return false;
+        }
+
+        template<typename T>
+        [[nodiscard]] ScalarAccess<T> bind() const {
+            // check has already rejected every T other than S, the cast only lets the other dtypes compile
+            return {static_cast<T>(value)};
+        }
+    };
+
+    template<typename Op, typename Lhs, typename Rhs>
+    class BinaryExpression : public Expression<BinaryExpression<Op, Lhs, Rhs>> {
+        Lhs lhs;
+        Rhs rhs;
+
+    public:
+        BinaryExpression(const Lhs &lhs, const Rhs &rhs): lhs(lhs), rhs(rhs) {
+        }
+
+        void check(const Matrix::Shape shape, const Device device, const Dtype dtype) const {
+            lhs.check(shape, device, dtype);
+            rhs.check(shape, device, dtype);
+        }
+
+        [[nodiscard]] bool overlaps(const Matrix &dest) const {
+            return lhs.overlaps(dest) || rhs.overlaps(dest);
+        }
+
+        template<typename T>
+        [[nodiscard]] auto bind() const {
+            using LhsAccess = decltype(lhs.template bind<T>());
+            using RhsAccess = decltype(rhs.template bind<T>());
+            return BinaryAccess<Op, LhsAccess, RhsAccess>{lhs.template bind<T>(), rhs.template bind<T>()};
+        }
+    };
+
+    template<typename Op, typename Operand>
+    class UnaryExpression : public Expression<UnaryExpression<Op, Operand>> {
+        Operand operand;
+
+    public:
+        explicit UnaryExpression(const Operand &operand): operand(operand) {
+        }
+
+        void check(const Matrix::Shape shape, const Device device, const Dtype dtype) const {
+            operand.check(shape, device, dtype);
+        }
+
+        [[nodiscard]] bool overlaps(const Matrix &dest) const {
+            return operand.overlaps(dest);
+        }
+
+        template<typename T>
+        [[nodiscard]] auto bind() const {
+            using OperandAccess = decltype(operand.template bind<T>());
+            return UnaryAccess<Op, OperandAccess>{operand.template bind<T>()};
+        }
+    };
+
+    /**
+     * maps what may appear in an expression, a matrix, a scalar or another expression, to its node type
+     */
+    template<typename T, typename = void>
+    struct expression_operand {
+        static constexpr bool valid{false};
+        static constexpr bool scalar{false};
+    };
+
+    template<>
+    struct expression_operand<Matrix> {
+        static constexpr bool valid{true};
+        static constexpr bool scalar{false};
+        using type = MatrixOperand;
+
+        static type wrap(const Matrix &matrix) { return type{matrix}; }
+    };
+
+    template<typename S>
+    struct expression_operand<S, std::enable_if_t<std::is_arithmetic_v<S>>> {
+        static constexpr bool valid{true};
+        static constexpr bool scalar{true};
+        using type = ScalarOperand<S>;
+
+        static type wrap(const S value) { return type{value}; }
+    };
+
+    template<typename E>
+    struct expression_operand<E, std::enable_if_t<std::is_base_of_v<Expression<E>, E>>> {
+        static constexpr bool valid{true};
+        static constexpr bool scalar{false};
+        using type = E;
+
+        static const type &wrap(const E &expression) { return expression; }
+    };
+
+    template<typename Lhs, typename Rhs>
+    constexpr bool is_expression_pair_v{
+        expression_operand<Lhs>::valid && expression_operand<Rhs>::valid &&
+        !(expression_operand<Lhs>::scalar && expression_operand<Rhs>::scalar)
+    };
+
+    template<typename Op, typename Lhs, typename Rhs>
+    using binary_expression_t = BinaryExpression<
+        Op, typename expression_operand<Lhs>::type, typename expression_operand<Rhs>::type>;
+
+    template<typename Op, typename Lhs, typename Rhs>
+    binary_expression_t<Op, Lhs, Rhs> make_binary_expression(const Lhs &lhs, const Rhs &rhs) {
+        return {expression_operand<Lhs>::wrap(lhs), expression_operand<Rhs>::wrap(rhs)};
+    }
+
+    template<typename Lhs, typename Rhs, typename = std::enable_if_t<is_expression_pair_v<Lhs, Rhs>>>
+    binary_expression_t<expression_ops::Add, Lhs, Rhs> operator+(const Lhs &lhs, const Rhs &rhs) {
+        return make_binary_expression<expression_ops::Add>(lhs, rhs);
+    }
+
+    template<typename Lhs, typename Rhs, typename = std::enable_if_t<is_expression_pair_v<Lhs, Rhs>>>
+    binary_expression_t<expression_ops::Subtract, Lhs, Rhs> operator-(const Lhs &lhs, const Rhs &rhs) {
+        return make_binary_expression<expression_ops::Subtract>(lhs, rhs);
+    }
+
+    /**
+     * element wise, not a matrix product
+     */
+    template<typename Lhs, typename Rhs, typename = std::enable_if_t<is_expression_pair_v<Lhs, Rhs>>>
+    binary_expression_t<expression_ops::Multiply, Lhs, Rhs> operator*(const Lhs &lhs, const Rhs &rhs) {
+        return make_binary_expression<expression_ops::Multiply>(lhs, rhs);
+    }
+
+    template<typename Lhs, typename Rhs, typename = std::enable_if_t<is_expression_pair_v<Lhs, Rhs>>>
+    binary_expression_t<expression_ops::Divide, Lhs, Rhs> operator/(const Lhs &lhs, const Rhs &rhs) {
+        return make_binary_expression<expression_ops::Divide>(lhs, rhs);
+    }
+
+    /**
+     * element wise maximum of two operands
+     */
+    template<typename Lhs, typename Rhs, typename = std::enable_if_t<is_expression_pair_v<Lhs, Rhs>>>
+    binary_expression_t<expression_ops::Maximum, Lhs, Rhs> maximum(const Lhs &lhs, const Rhs &rhs) {
+        return make_binary_expression<expression_ops::Maximum>(lhs, rhs);
+    }
+
+    /**
+     * element wise minimum of two operands
+     */
+    template<typename Lhs, typename Rhs, typename = std::enable_if_t<is_expression_pair_v<Lhs, Rhs>>>
+    binary_expression_t<expression_ops::Minimum, Lhs, Rhs> minimum(const Lhs &lhs, const Rhs &rhs) {
+        return make_binary_expression<expression_ops::Minimum>(lhs, rhs);
+    }
+
+    /**
+     * limits every element of an operand to [low, high]
+     */
+    template<typename E, typename S, typename = std::enable_if_t<
+        !expression_operand<E>::scalar && expression_operand<E>::valid && std::is_arithmetic_v<S>>>
+    auto clamp(const E &operand, const S low, const S high) {
+        return minimum(maximum(operand, low), high);
+    }
+
+    template<typename E, typename = std::enable_if_t<!expression_operand<E>::scalar && expression_operand<E>::valid>>
+    UnaryExpression<expression_ops::Negate, typename expression_operand<E>::type> operator-(const E &operand) {
+        return UnaryExpression<expression_ops::Negate, typename expression_operand<E>::type>{
+            expression_operand<E>::wrap(operand)};
+    }
+
+    template<typename T, typename Access>
+    void evaluate_expression(
+        T *dest,
+        const Access &access,
+        const size_t rows,
+        const size_t columns,
+        const size_t leading_dimension) {
+        size_t const tiles{(columns + EXPRESSION_TILE - 1) / EXPRESSION_TILE};
+        set_num_threads(rows * columns);
+        size_t tile;
+
+#pragma omp parallel for default(none) shared(dest, access, rows, columns, leading_dimension, tiles) private(tile) schedule(static)
+        for (tile = 0; tile < rows * tiles; ++tile) {
+            size_t const row{tile / tiles};
+            size_t const begin{tile % tiles * EXPRESSION_TILE};
+            size_t const end{std::min<size_t>(begin + EXPRESSION_TILE, columns)};
+            T *out = dest + row * leading_dimension;
+
+#pragma omp simd
+            for (size_t column = begin; column < end; ++column) {
+                out[column] = access(row, column);
+            }
+        }
+    }
+
+    template<typename E>
+    Matrix &Matrix::operator=(const Expression<E> &expression) {
+        const E &tree{expression.self()};
+        tree.check(get_shape(), get_device(), get_dtype());
+
+        if (tree.overlaps(*this)) {
+            Matrix scratch(rows, columns, get_device(), get_dtype(), UNINITIALIZED);
+            scratch = expression;
+            return *this = MatrixOperand{scratch};
+        }
+
+        void *dest{get_writable_buffer()};
+
+        switch (get_dtype()) {
+            case FLOAT64: {
+                evaluate_expression(static_cast<double *>(dest), tree.template bind<double>(), rows, columns,
+                    leading_dimension);
+                return *this;
+            }
+            case FLOAT32: {
+                evaluate_expression(static_cast<float *>(dest), tree.template bind<float>(), rows, columns,
+                    leading_dimension);
+                return *this;
+            }
+            case INT8: {
+                evaluate_expression(static_cast<int8_t *>(dest), tree.template bind<int8_t>(), rows, columns,
+                    leading_dimension);
+                return *this;
+            }
+            case INT16: {
+                evaluate_expression(static_cast<int16_t *>(dest), tree.template bind<int16_t>(), rows, columns,
+                    leading_dimension);
+                return *this;
+            }
+            case INT32: {
+                evaluate_expression(static_cast<int32_t *>(dest), tree.template bind<int32_t>(), rows, columns,
+                    leading_dimension);
+                return *this;
+            }
+            case INT64: {
+                evaluate_expression(static_cast<int64_t *>(dest), tree.template bind<int64_t>(), rows, columns,
+                    leading_dimension);
+                return *this;
+            }
+            case FLOAT16:
+            case BFLOAT16: {
+                throw std::runtime_error("expressions are not supported on half precision storage");
+            }
+            case INVALID: {
+                throw std::runtime_error("cannot evaluate an expression on invalid type");
+            }
+        }
+
+        return *this;
+    }
+}
+
+#endif //EXPRESSION_H
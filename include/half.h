@@ -0,0 +1,132 @@
+//
+// Created by sriram on 2/10/25.
+//
+
+#ifndef HALF_H
+#define HALF_H
+
+#include <cstdint>
+#include <cstring>
+
+namespace cobraml::core {
+
+    /**
+     * IEEE 754 binary16 storage type, 1 sign bit, 5 exponent bits and 10 mantissa bits.
+     * Only used for storage, all arithmetic happens in FLOAT32
+     */
+    struct float16 {
+        uint16_t bits;
+    };
+
+    /**
+     * bfloat16 storage type, the upper 16 bits of a FLOAT32.
+     * Only used for storage, all arithmetic happens in FLOAT32
+     */
+    struct bfloat16 {
+        uint16_t bits;
+    };
+
+    inline uint32_t float_to_bits(float const value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    inline float bits_to_float(uint32_t const bits) {
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    /**
+     * binary16 to FLOAT32, exact. Written without data dependent branches so it vectorizes
+     * https://fgiesen.wordpress.com/2012/03/28/half-to-float-done-quic/
+     *
+     * @param half the raw binary16 bits
+     * @return the FLOAT32 value
+     */
+    inline float half_bits_to_float(uint16_t const half) {
+        constexpr uint32_t shifted_exponent = 0x7c00u << 13;
+        uint32_t bits = (half & 0x7fffu) << 13;
+        uint32_t const exponent = bits & shifted_exponent;
+        bits += (127u - 15u) << 23;
+
+        // infinity and NaN keep the maximum exponent
+        bits += exponent == shifted_exponent ? (128u - 16u) << 23 : 0u;
+
+        // zero and subnormals are renormalized through a float subtraction
+        float const subnormal = bits_to_float(bits + (1u << 23)) - bits_to_float(113u << 23);
+        bits = exponent == 0 ? float_to_bits(subnormal) : bits;
+
+        return bits_to_float(bits | (static_cast<uint32_t>(half & 0x8000u) << 16));
+    }
+
+    /**
+     * FLOAT32 to binary16, rounding to nearest even, overflow becomes infinity
+     *
+     * @param value the FLOAT32 value
+     * @return the raw binary16 bits
+     */
+    inline uint16_t float_to_half_bits(float const value) {
+        constexpr uint32_t float_infinity = 255u << 23;
+        constexpr uint32_t half_max = (127u + 16u) << 23;
+        constexpr uint32_t denormal_magic = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+
+        uint32_t bits = float_to_bits(value);
+        uint32_t const sign = bits & 0x80000000u;
+        bits ^= sign;
+
+        uint32_t half;
+
+        if (bits >= half_max) {
+            half = bits > float_infinity ? 0x7e00u : 0x7c00u;
+        } else if (bits < (113u << 23)) {
+            half = float_to_bits(bits_to_float(bits) + bits_to_float(denormal_magic)) - denormal_magic;
+        } else {
+            uint32_t const mantissa_odd = (bits >> 13) & 1u;
+            bits += ((15u - 127u) << 23) + 0xfffu;
+            bits += mantissa_odd;
+            half = bits >> 13;
+        }
+
+        return static_cast<uint16_t>(half | (sign >> 16));
+    }
+
+    /**
+     * bfloat16 to FLOAT32, exact
+     */
+    inline float bfloat_bits_to_float(uint16_t const bfloat) {
+        return bits_to_float(static_cast<uint32_t>(bfloat) << 16);
+    }
+
+    /**
+     * FLOAT32 to bfloat16, rounding to nearest even, NaN stays NaN
+     */
+    inline uint16_t float_to_bfloat_bits(float const value) {
+        uint32_t const bits = float_to_bits(value);
+
+        if ((bits & 0x7fffffffu) > 0x7f800000u) {
+            return static_cast<uint16_t>((bits >> 16) | 0x40u);
+        }
+
+        return static_cast<uint16_t>((bits + 0x7fffu + ((bits >> 16) & 1u)) >> 16);
+    }
+
+    inline float16 to_float16(float const value) {
+        return float16{float_to_half_bits(value)};
+    }
+
+    inline bfloat16 to_bfloat16(float const value) {
+        return bfloat16{float_to_bfloat_bits(value)};
+    }
+
+    inline float to_float(float16 const value) {
+        return half_bits_to_float(value.bits);
+    }
+
+    inline float to_float(bfloat16 const value) {
+        return bfloat_bits_to_float(value.bits);
+    }
+}
+
+#endif //HALF_H
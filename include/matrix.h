@@ -18,15 +18,117 @@
  * Test and Update To Tensor
  * Create Tensor class
  */
+struct DLManagedTensor;
+
 namespace cobraml::core {
 
+    class QuantizedMatrix;
+    class SparseMatrix;
+
+    template<typename Derived>
+    class Expression;
+
+    /**
+     * A non owning handle on one row of a matrix, taking one does not allocate or touch reference counts.
+     * It stays valid while the matrix it was taken from, or another matrix sharing its buffer, is alive.
+     */
+    class RowView {
+        const void *data;
+        size_t columns;
+        Dtype dtype;
+
+    public:
+        RowView(const void *data, size_t const columns, Dtype const dtype): data(data), columns(columns), dtype(dtype) {
+        }
+
+        /**
+         * @return the number of elements in the row
+         */
+        [[nodiscard]] size_t len() const {
+            return columns;
+        }
+
+        /**
+         * @return the dtype of the row
+         */
+        [[nodiscard]] Dtype get_dtype() const {
+            return dtype;
+        }
+
+        /**
+         * @tparam T the type that the ptr should be cast too, it must match the Dtype
+         * @return the first element of the row
+         */
+        template<typename T>
+        [[nodiscard]] const T *get_buffer() const {
+            if (constexpr Dtype given = get_dtype_from_type<T>::type; given != dtype) {
+                throw std::runtime_error(
+                    "provided buffer type does not match row type: " + dtype_to_string(dtype));
+            }
+
+            return static_cast<const T *>(data);
+        }
+
+        /**
+         * @param index the column
+         * @return the element at index
+         */
+        template<typename T>
+        [[nodiscard]] T item(size_t const index) const {
+            if (index >= columns) {
+                throw std::out_of_range("index is out of range");
+            }
+
+            return get_buffer<T>()[index];
+        }
+    };
+
+    /**
+     * walks the rows of a matrix as RowView handles
+     */
+    class RowIterator {
+        const char *row;
+        size_t stride;
+        size_t columns;
+        Dtype dtype;
+
+    public:
+        RowIterator(const char *row, size_t const stride, size_t const columns, Dtype const dtype):
+            row(row), stride(stride), columns(columns), dtype(dtype) {
+        }
+
+        RowView operator*() const {
+            return {row, columns, dtype};
+        }
+
+        RowIterator &operator++() {
+            row += stride;
+            return *this;
+        }
+
+        bool operator==(const RowIterator &other) const {
+            return row == other.row;
+        }
+
+        bool operator!=(const RowIterator &other) const {
+            return row != other.row;
+        }
+    };
+
     class Matrix final : public Array{
         size_t rows;
         size_t columns;
+        // elements between the starts of consecutive rows, wider than columns for views made by slice
+        size_t leading_dimension;
 
         Matrix(Array const &other);
+        Matrix(std::shared_ptr<Buffer> buffer, size_t rows, size_t columns, Device device, Dtype dtype);
+        Matrix(void *data, size_t rows, size_t columns, Device device, Dtype dtype, std::function<void()> release);
 
         friend class Tensor;
+        friend class QuantizedMatrix;
+        friend class SparseMatrix;
+        friend class MatrixOperand;
     public:
         struct Shape {
             size_t rows;
@@ -40,14 +142,50 @@ namespace cobraml::core {
          * @param columns the # of columns in the matrix
          * @param device the device of the matrix being constructed
          * @param dtype the dtype of the matrix being constructed
+         * @param policy how the elements are initialized, FIRST_TOUCH partitions a matrix by rows and a
+         * vector by elements, the same way gemv partitions A and y
          */
-        Matrix(size_t rows, size_t columns, Device device, Dtype dtype);
+        Matrix(size_t rows, size_t columns, Device device, Dtype dtype, AllocationPolicy policy = ZEROED);
 
         Matrix();
         Matrix(Matrix const &other);
         Matrix& operator=(const Matrix& other);
+
+        /**
+         * takes over the buffer of other without touching its reference count, other is left empty as if
+         * default constructed
+         */
+        Matrix(Matrix &&other) noexcept;
+        Matrix& operator=(Matrix &&other) noexcept;
+
+        /**
+         * evaluates an element wise expression into this matrix in a single pass, see expression.h
+         * @param expression the expression, built from matrices and scalars by the arithmetic operators
+         * @return this matrix
+         */
+        template<typename E>
+        Matrix& operator=(const Expression<E> &expression);
+
         Matrix operator[] (size_t index) const;
 
+        /**
+         * unlike operator[], which returns a matrix sharing the buffer, the view does not allocate
+         *
+         * @param index the row
+         * @return a view of the row
+         */
+        [[nodiscard]] RowView row(size_t index) const;
+
+        /**
+         * @return an iterator over the rows as RowView handles, iterating does not allocate
+         */
+        [[nodiscard]] RowIterator begin() const;
+
+        /**
+         * @return the end of the rows
+         */
+        [[nodiscard]] RowIterator end() const;
+
         /**
          * @return True if matrix qualifies as a vector
          */
@@ -58,11 +196,43 @@ namespace cobraml::core {
          */
         [[nodiscard]] bool is_scalar() const;
 
+        /**
+         * @return True if the rows of the matrix are packed back to back, only views taken by slice may not be
+         */
+        [[nodiscard]] bool is_contiguous() const;
+
+        /**
+         * @return the number of elements between the starts of consecutive rows
+         */
+        [[nodiscard]] size_t get_leading_dimension() const;
+
+        /**
+         * a view of the rows [row_begin, row_end) and columns [column_begin, column_end), it shares the buffer
+         * of this matrix so writes through either are visible in both. Non contiguous views are accepted by gemv,
+         * gemv_sparse_query, reduce_rows, reduce_columns, expression assignment, save and DLPack export, and can
+         * be written through with deep_copy. The level 1 routines, gemv_cosine, gemv_topk, gemv_batched, gemm and
+         * quantize throw on them.
+         *
+         * @param row_begin the first row of the view
+         * @param row_end one past the last row of the view
+         * @param column_begin the first column of the view
+         * @param column_end one past the last column of the view
+         * @return the view
+         */
+        [[nodiscard]] Matrix slice(size_t row_begin, size_t row_end, size_t column_begin, size_t column_end) const;
+
         /**
         * @return the shape of the matrix
         */
         [[nodiscard]] Shape get_shape() const;
 
+        /**
+         * copies the elements of other into this matrix one row at a time, so a view only writes the elements
+         * it covers and not the rest of its parent. other is read with its own leading dimension.
+         * @param other a matrix of the same shape, data type and device
+         */
+        void deep_copy(Array &other) override;
+
         /**
          * prints the contents of the matrix in tabular format
          * @param hide_middle hide the center elements of an array
@@ -75,7 +245,8 @@ namespace cobraml::core {
 
         /**
          * Generalized Matrix Vector Multiplication.
-         * Performs y=αAx+βy
+         * Performs y=αAx+βy. When A is stored as FLOAT16 or BFLOAT16 it is widened to FLOAT32 while it is
+         * streamed, x, y, α and β must then be FLOAT32
          *
          * @param matrix A
          * @param vector x
@@ -86,9 +257,239 @@ namespace cobraml::core {
         template<typename T>
         friend void gemv(const Matrix &matrix, const Matrix &vector, Matrix &result, T alpha, T beta);
 
+        /**
+         * Generalized Matrix Vector Multiplication with an optional transpose.
+         * Performs y=αAᵀx+βy when transpose is set, otherwise y=αAx+βy. Aᵀ is never materialized, A is
+         * streamed in its row major layout while every thread accumulates the columns of its rows
+         *
+         * @param matrix A of shape (rows, columns)
+         * @param vector x, of length rows when transposed
+         * @param result y, of length columns when transposed
+         * @param alpha α
+         * @param beta β
+         * @param transpose whether to multiply by Aᵀ
+         */
+        template<typename T>
+        friend void gemv(const Matrix &matrix, const Matrix &vector, Matrix &result, T alpha, T beta, bool transpose);
+
+        /**
+         * Generalized Matrix Vector Multiplication against a sparse query.
+         * Performs y=αAx+βy where x is given by its nonzeros, only the columns of A named in indices are
+         * read so the work scales with the nonzeros of x instead of columns. Sorted indices keep the reads
+         * of every row moving forward through memory
+         *
+         * @param matrix A
+         * @param indices the column of every nonzero of x, an INT64 vector
+         * @param values the nonzeros of x, a vector of the same length as indices
+         * @param result y
+         * @param alpha α
+         * @param beta β
+         */
+        template<typename T>
+        friend void gemv_sparse_query(
+            const Matrix &matrix, const Matrix &indices, const Matrix &values, Matrix &result, T alpha, T beta);
+
+        /**
+         * Generalized Matrix Vector Multiplication against a sparse query with an optional transpose.
+         * Performs y=αAᵀx+βy when transpose is set, otherwise y=αAx+βy. Transposed, indices name rows of A,
+         * so a catalog stored feature major is scored by streaming only the rows of the touched features
+         *
+         * @param matrix A of shape (rows, columns)
+         * @param indices the position of every nonzero of x, rows of A when transposed
+         * @param values the nonzeros of x, a vector of the same length as indices
+         * @param result y, of length columns when transposed
+         * @param alpha α
+         * @param beta β
+         * @param transpose whether to multiply by Aᵀ
+         */
+        template<typename T>
+        friend void gemv_sparse_query(
+            const Matrix &matrix,
+            const Matrix &indices,
+            const Matrix &values,
+            Matrix &result,
+            T alpha,
+            T beta,
+            bool transpose);
+
+        /**
+         * Cosine similarity Matrix Vector Multiplication.
+         * Performs y=α(Ax / (‖Aᵢ‖‖x‖))+βy, rows or vectors with a zero norm score 0.
+         * The row norms of A are computed once and cached until A is written, so repeated scoring
+         * costs the same as gemv. Only FLOAT32 and FLOAT64 are supported
+         *
+         * @param matrix A
+         * @param vector x
+         * @param result y
+         * @param alpha α
+         * @param beta β
+         */
+        template<typename T>
+        friend void gemv_cosine(const Matrix &matrix, const Matrix &vector, Matrix &result, T alpha, T beta);
+
+        /**
+         * Fused gemv and top k selection.
+         * Finds the k rows of A with the largest αAx without materializing the full score vector,
+         * results are ordered by descending score with ties going to the lower row index
+         *
+         * @param matrix A of shape (rows, columns)
+         * @param vector x of shape (1, columns)
+         * @param indices receives the selected row indices, an INT64 vector of shape (1, k)
+         * @param scores receives the selected scores, shape (1, k)
+         * @param alpha α
+         */
+        template<typename T>
+        friend void gemv_topk(const Matrix &matrix, const Matrix &vector, Matrix &indices, Matrix &scores, T alpha);
+
+        /**
+         * Batched Generalized Matrix Vector Multiplication.
+         * Performs y=αAx+βy for every query x, the rows of A are loaded once and applied to all queries
+         *
+         * @param matrix A of shape (rows, columns)
+         * @param queries one query vector x per row, shape (k, columns)
+         * @param result one result vector y per row, shape (k, rows)
+         * @param alpha α
+         * @param beta β
+         */
+        template<typename T>
+        friend void gemv_batched(const Matrix &matrix, const Matrix &queries, Matrix &result, T alpha, T beta);
+
+        /**
+         * Generalized Matrix Matrix Multiplication.
+         * Performs C=αAB+βC
+         *
+         * @param matrix_a A of shape (m, k)
+         * @param matrix_b B of shape (k, n)
+         * @param result C of shape (m, n)
+         * @param alpha α
+         * @param beta β
+         */
+        template<typename T>
+        friend void gemm(const Matrix &matrix_a, const Matrix &matrix_b, Matrix &result, T alpha, T beta);
+
+        /**
+         * Dot product, xᵀy. Level 1 routines treat a contiguous matrix as its rows * columns elements,
+         * views taken by slice are rejected. FLOAT16 and BFLOAT16 storage is computed in FLOAT32, so T, α and
+         * the results are then float and written elements are rounded back to the storage dtype
+         *
+         * @param x a contiguous matrix
+         * @param y a contiguous matrix of the same shape as x
+         * @return the dot product, accumulated in T
+         */
+        template<typename T>
+        friend T dot(const Matrix &x, const Matrix &y);
+
+        /**
+         * y = αx + y
+         *
+         * @param alpha α
+         * @param x a contiguous matrix
+         * @param y a contiguous matrix of the same shape as x
+         */
+        template<typename T>
+        friend void axpy(T alpha, const Matrix &x, Matrix &y);
+
+        /**
+         * x = αx
+         *
+         * @param alpha α
+         * @param x a contiguous matrix
+         */
+        template<typename T>
+        friend void scal(T alpha, Matrix &x);
+
+        /**
+         * Euclidean norm, ‖x‖₂. The squares are summed in double, for integer dtypes the norm is rounded
+         * toward zero
+         *
+         * @param x a contiguous matrix
+         * @return the norm
+         */
+        template<typename T>
+        friend T nrm2(const Matrix &x);
+
+        /**
+         * Sum of magnitudes, Σ|xᵢ|
+         *
+         * @param x a contiguous matrix
+         * @return the sum, accumulated in T
+         */
+        template<typename T>
+        friend T asum(const Matrix &x);
+
+        /**
+         * @param x a contiguous matrix
+         * @return the row major index of the first element with the largest magnitude
+         */
+        friend size_t iamax(const Matrix &x);
+
+        /**
+         * reduces every row of a matrix to one element, views taken by slice are accepted
+         *
+         * @param matrix A of shape (rows, columns)
+         * @param reduction SUM, MAX, ARGMAX or MEAN
+         * @return a vector of shape (1, rows), INT64 for ARGMAX and of the dtype of A otherwise
+         */
+        friend Matrix reduce_rows(const Matrix &matrix, Reduction reduction);
+
+        /**
+         * reduces every column of a matrix to one element, views taken by slice are accepted. Every thread
+         * accumulates its rows into a partial row, so A is streamed row by row and never strided down a column
+         *
+         * @param matrix A of shape (rows, columns)
+         * @param reduction SUM, MAX, ARGMAX or MEAN
+         * @return a vector of shape (1, columns), INT64 for ARGMAX and of the dtype of A otherwise
+         */
+        friend Matrix reduce_columns(const Matrix &matrix, Reduction reduction);
+
         template<typename T>
         friend Matrix from_vector(const std::vector<std::vector<T>> &mat, Device device);
 
+        /**
+         * as above, a single row is adopted instead of copied
+         */
+        template<typename T>
+        friend Matrix from_vector(std::vector<std::vector<T>> &&mat, Device device);
+
+        /**
+         * adopts row major storage instead of copying it, values is left empty
+         *
+         * @param values the rows * columns elements in row major order
+         * @param rows the # of rows in the matrix
+         * @param columns the # of columns in the matrix
+         * @param device the device of the matrix being constructed
+         * @return the matrix
+         */
+        template<typename T>
+        friend Matrix from_vector(std::vector<T> &&values, size_t rows, size_t columns, Device device);
+
+        /**
+         * constructs a row major matrix over memory owned outside the library, adopting or copying data exactly as
+         * the array overload of wrap does.
+         *
+         * @param data the memory, it must hold at least rows * columns elements of dtype
+         * @param rows the # of rows in the matrix
+         * @param columns the # of columns in the matrix
+         * @param device the device of the memory
+         * @param dtype the dtype of data
+         * @param release called once when the last matrix using the memory is destroyed
+         * @return the matrix
+         */
+        friend Matrix wrap(
+            void *data, size_t rows, size_t columns, Device device, Dtype dtype, std::function<void()> release);
+
+        friend DLManagedTensor *to_dlpack(const Matrix &matrix);
+
+        friend void save(const Matrix &matrix, const std::string &path);
+        friend Matrix load(const std::string &path, Device device);
+
+        friend QuantizedMatrix quantize(const Matrix &matrix);
+        friend Matrix dequantize(const QuantizedMatrix &matrix);
+        friend void gemv(const QuantizedMatrix &matrix, const Matrix &vector, Matrix &result, float alpha, float beta);
+
+        template<typename T>
+        friend void gemv(const SparseMatrix &matrix, const Matrix &vector, Matrix &result, T alpha, T beta);
+
         template<typename T>
         friend T to_scalar(const Matrix &matrix);
     };
@@ -101,7 +502,7 @@ namespace cobraml::core {
         const size_t rows{mat.size()};
         const size_t columns{mat[0].size()};
 
-        Matrix ret(rows, columns, device, dtype);
+        Matrix ret(rows, columns, device, dtype, UNINITIALIZED);
 
         if (rows == 1) {
             ret.copy_vector(mat[0]);
@@ -115,13 +516,136 @@ namespace cobraml::core {
                 throw std::runtime_error("matrix is not rectangular");
             }
 
-            ret[count].copy_vector(row);
+            ret.replace_segment(row.data(), columns, count * columns);
             ++count;
         }
 
         return ret;
     }
 
+    template<typename T>
+    Matrix from_vector(std::vector<std::vector<T>> &&mat, Device const device) {
+        if (mat.size() != 1) {
+            return from_vector(static_cast<const std::vector<std::vector<T>> &>(mat), device);
+        }
+
+        size_t const columns{mat[0].size()};
+        return from_vector(std::move(mat[0]), 1, columns, device);
+    }
+
+    template<typename T>
+    Matrix from_vector(std::vector<T> &&values, size_t const rows, size_t const columns, Device const device) {
+        constexpr Dtype dtype{get_dtype_from_type<T>::type};
+        is_invalid(dtype);
+
+        if (rows == 0 || columns == 0) {
+            throw std::runtime_error("matrix must have at least one row and one column");
+        }
+
+        if (values.size() != rows * columns) {
+            throw std::runtime_error("cannot set matrix with vector of different size");
+        }
+
+        auto owner{std::make_shared<std::vector<T>>(std::move(values))};
+        void *data{owner->data()};
+
+        return {data, rows, columns, device, dtype, [owner]() mutable { owner.reset(); }};
+    }
+
+    Matrix wrap(void *data, size_t rows, size_t columns, Device device, Dtype dtype, std::function<void()> release);
+
+    /**
+     * as above, owner is kept alive until the last matrix using the memory is destroyed
+     */
+    inline Matrix wrap(
+        void *data,
+        size_t const rows,
+        size_t const columns,
+        Device const device,
+        Dtype const dtype,
+        std::shared_ptr<const void> owner) {
+        return wrap(data, rows, columns, device, dtype, [owner]() mutable { owner.reset(); });
+    }
+
+    size_t iamax(const Matrix &x);
+
+    Matrix reduce_rows(const Matrix &matrix, Reduction reduction);
+
+    Matrix reduce_columns(const Matrix &matrix, Reduction reduction);
+
+    /**
+     * the checks shared by the level 1 routines
+     */
+    template<typename T>
+    void check_level1(const Matrix &x, const char *name) {
+        if (!x.is_contiguous()) {
+            throw std::runtime_error(std::string(name) + " requires a contiguous matrix");
+        }
+
+        const Dtype current{compute_dtype(x.get_dtype())};
+        if (constexpr Dtype given = get_dtype_from_type<T>::type; given != current) {
+            throw std::runtime_error(
+                std::string(name) + " has a invalid dtype, expected " + dtype_to_string(current));
+        }
+    }
+
+    /**
+     * the checks shared by the level 1 routines that take two matrices
+     */
+    template<typename T>
+    void check_level1(const Matrix &x, const Matrix &y, const char *name) {
+        check_level1<T>(x, name);
+        check_level1<T>(y, name);
+
+        if (x.get_dtype() != y.get_dtype()) {
+            throw std::runtime_error(std::string(name) + " requires matrices of the same dtype");
+        }
+
+        if (!(x.get_shape() == y.get_shape())) {
+            throw std::runtime_error(std::string(name) + " requires matrices of the same shape");
+        }
+
+        if (x.get_device() != y.get_device()) {
+            throw std::runtime_error(std::string(name) + " requires matrices on the same device");
+        }
+    }
+
+    template<typename T>
+    T dot(const Matrix &x, const Matrix &y) {
+        check_level1<T>(x, y, "dot");
+        T result{};
+        x.dot(y, x.rows * x.columns, &result);
+        return result;
+    }
+
+    template<typename T>
+    void axpy(const T alpha, const Matrix &x, Matrix &y) {
+        check_level1<T>(x, y, "axpy");
+        y.axpy(x, x.rows * x.columns, &alpha);
+    }
+
+    template<typename T>
+    void scal(const T alpha, Matrix &x) {
+        check_level1<T>(x, "scal");
+        x.scal(x.rows * x.columns, &alpha);
+    }
+
+    template<typename T>
+    T nrm2(const Matrix &x) {
+        check_level1<T>(x, "nrm2");
+        T result{};
+        x.nrm2(x.rows * x.columns, &result);
+        return result;
+    }
+
+    template<typename T>
+    T asum(const Matrix &x) {
+        check_level1<T>(x, "asum");
+        T result{};
+        x.asum(x.rows * x.columns, &result);
+        return result;
+    }
+
     template<typename T>
     T to_scalar(const Matrix &matrix) {
 
@@ -141,6 +665,135 @@ namespace cobraml::core {
 
     template<typename T>
     void gemv(const Matrix &matrix, const Matrix &vector, Matrix &result, const T alpha, const T beta) {
+        gemv(matrix, vector, result, alpha, beta, false);
+    }
+
+    template<typename T>
+    void gemv(const Matrix &matrix, const Matrix &vector, Matrix &result, const T alpha, const T beta,
+              const bool transpose) {
+        if (!vector.is_vector()) {
+            throw std::runtime_error("vector is a matrix");
+        }
+
+        if (!result.is_vector()) {
+            throw std::runtime_error("result is a matrix");
+        }
+
+        size_t const inner{transpose ? matrix.rows : matrix.columns};
+        size_t const outer{transpose ? matrix.columns : matrix.rows};
+
+        if (inner != vector.columns) {
+            throw std::runtime_error(transpose
+                                         ? "vector and matrix have different rows lengths"
+                                         : "vector and matrix have different columns lengths");
+        }
+
+        if (outer != result.columns) {
+            throw std::runtime_error(transpose
+                                         ? "result must be size 1, columns(matrix)"
+                                         : "result must be size 1, rows(matrix)");
+        }
+
+        if (matrix.get_device() != vector.get_device() || matrix.get_device() != result.get_device()) {
+            throw std::runtime_error("vector, matrix and result are not on the same device");
+        }
+
+        const Dtype current{compute_dtype(matrix.get_dtype())};
+        if (current != vector.get_dtype() || current != result.get_dtype()) {
+            throw std::runtime_error("vector, matrix and result share different dtypes");
+        }
+
+        if (constexpr Dtype given = get_dtype_from_type<T>::type; given != current) {
+            throw std::runtime_error(
+                "alpha and beta has a invalid dtype, expected " + dtype_to_string(current));
+        }
+
+        result.gemv(matrix, vector, matrix.rows, matrix.columns, matrix.leading_dimension, &alpha, &beta, transpose);
+    }
+
+    template<typename T>
+    void gemv_sparse_query(
+        const Matrix &matrix, const Matrix &indices, const Matrix &values, Matrix &result, const T alpha,
+        const T beta) {
+        gemv_sparse_query(matrix, indices, values, result, alpha, beta, false);
+    }
+
+    template<typename T>
+    void gemv_sparse_query(
+        const Matrix &matrix,
+        const Matrix &indices,
+        const Matrix &values,
+        Matrix &result,
+        const T alpha,
+        const T beta,
+        const bool transpose) {
+        if (!indices.is_vector() || !values.is_vector()) {
+            throw std::runtime_error("indices and values must be vectors");
+        }
+
+        if (!result.is_vector()) {
+            throw std::runtime_error("result is a matrix");
+        }
+
+        if (indices.columns != values.columns) {
+            throw std::runtime_error("indices and values have different lengths");
+        }
+
+        size_t const inner{transpose ? matrix.rows : matrix.columns};
+        size_t const outer{transpose ? matrix.columns : matrix.rows};
+
+        if (outer != result.columns) {
+            throw std::runtime_error(transpose
+                                         ? "result must be size 1, columns(matrix)"
+                                         : "result must be size 1, rows(matrix)");
+        }
+
+        if (matrix.get_device() != indices.get_device() ||
+            matrix.get_device() != values.get_device() ||
+            matrix.get_device() != result.get_device()) {
+            throw std::runtime_error("indices, values, matrix and result are not on the same device");
+        }
+
+        if (indices.get_dtype() != INT64) {
+            throw std::runtime_error("indices must be INT64");
+        }
+
+        const Dtype current{matrix.get_dtype()};
+        if (current != values.get_dtype() || current != result.get_dtype()) {
+            throw std::runtime_error("values, matrix and result share different dtypes");
+        }
+
+        if (constexpr Dtype given = get_dtype_from_type<T>::type; given != current) {
+            throw std::runtime_error(
+                "alpha and beta has a invalid dtype, expected " + dtype_to_string(current));
+        }
+
+        const int64_t *positions{get_buffer<int64_t>(indices)};
+        for (size_t i = 0; i < indices.columns; ++i) {
+            if (positions[i] < 0 || static_cast<size_t>(positions[i]) >= inner) {
+                throw std::out_of_range("query index is out of range");
+            }
+        }
+
+        result.sparse_query_gemv(
+            matrix,
+            indices,
+            values,
+            matrix.rows,
+            matrix.columns,
+            matrix.leading_dimension,
+            indices.columns,
+            &alpha,
+            &beta,
+            transpose);
+    }
+
+    template<typename T>
+    void gemv_cosine(const Matrix &matrix, const Matrix &vector, Matrix &result, const T alpha, const T beta) {
+        if (!matrix.is_contiguous()) {
+            throw std::runtime_error("gemv_cosine requires a contiguous matrix");
+        }
+
         if (!vector.is_vector()) {
             throw std::runtime_error("vector is a matrix");
         }
@@ -166,12 +819,127 @@ namespace cobraml::core {
         }
 
         const Dtype current{matrix.get_dtype()};
+        if (current != FLOAT32 && current != FLOAT64) {
+            throw std::runtime_error("cosine similarity requires a floating point dtype");
+        }
+
+        if (constexpr Dtype given = get_dtype_from_type<T>::type; given != current) {
+            throw std::runtime_error(
+                "alpha and beta has a invalid dtype, expected " + dtype_to_string(current));
+        }
+
+        result.gemv_cosine(matrix, vector, matrix.rows, matrix.columns, &alpha, &beta);
+    }
+
+    template<typename T>
+    void gemv_topk(const Matrix &matrix, const Matrix &vector, Matrix &indices, Matrix &scores, const T alpha) {
+        if (!matrix.is_contiguous()) {
+            throw std::runtime_error("gemv_topk requires a contiguous matrix");
+        }
+
+        if (!vector.is_vector()) {
+            throw std::runtime_error("vector is a matrix");
+        }
+
+        if (!indices.is_vector() || !scores.is_vector()) {
+            throw std::runtime_error("indices and scores must be vectors");
+        }
+
+        if (matrix.columns != vector.columns) {
+            throw std::runtime_error("vector and matrix have different columns lengths");
+        }
+
+        if (indices.columns != scores.columns) {
+            throw std::runtime_error("indices and scores have different lengths");
+        }
+
+        if (indices.columns == 0 || indices.columns > matrix.rows) {
+            throw std::runtime_error("k must be between 1 and rows(matrix)");
+        }
+
+        if (matrix.get_device() != vector.get_device() ||
+            matrix.get_device() != indices.get_device() ||
+            matrix.get_device() != scores.get_device()) {
+            throw std::runtime_error("vector, matrix, indices and scores are not on the same device");
+        }
+
+        if (matrix.get_dtype() != vector.get_dtype() || matrix.get_dtype() != scores.get_dtype()) {
+            throw std::runtime_error("vector, matrix and scores share different dtypes");
+        }
+
+        if (indices.get_dtype() != INT64) {
+            throw std::runtime_error("indices must be of dtype INT64");
+        }
+
+        const Dtype current{matrix.get_dtype()};
+        if (constexpr Dtype given = get_dtype_from_type<T>::type; given != current) {
+            throw std::runtime_error(
+                "alpha has a invalid dtype, expected " + dtype_to_string(current));
+        }
+
+        scores.gemv_topk(matrix, vector, indices, matrix.rows, matrix.columns, indices.columns, &alpha);
+    }
+
+    template<typename T>
+    void gemv_batched(const Matrix &matrix, const Matrix &queries, Matrix &result, const T alpha, const T beta) {
+        if (!matrix.is_contiguous() || !queries.is_contiguous() || !result.is_contiguous()) {
+            throw std::runtime_error("gemv_batched requires contiguous matrices");
+        }
+
+        if (matrix.columns != queries.columns) {
+            throw std::runtime_error("queries and matrix have different columns lengths");
+        }
+
+        if (queries.rows != result.rows || matrix.rows != result.columns) {
+            throw std::runtime_error("result must be size rows(queries), rows(matrix)");
+        }
+
+        if (matrix.get_device() != queries.get_device() || matrix.get_device() != result.get_device()) {
+            throw std::runtime_error("queries, matrix and result are not on the same device");
+        }
+
+        if (matrix.get_dtype() != queries.get_dtype() || matrix.get_dtype() != result.get_dtype()) {
+            throw std::runtime_error("queries, matrix and result share different dtypes");
+        }
+
+        const Dtype current{matrix.get_dtype()};
+        if (constexpr Dtype given = get_dtype_from_type<T>::type; given != current) {
+            throw std::runtime_error(
+                "alpha and beta has a invalid dtype, expected " + dtype_to_string(current));
+        }
+
+        result.gemv_batched(matrix, queries, matrix.rows, matrix.columns, queries.rows, &alpha, &beta);
+    }
+
+    template<typename T>
+    void gemm(const Matrix &matrix_a, const Matrix &matrix_b, Matrix &result, const T alpha, const T beta) {
+        if (!matrix_a.is_contiguous() || !matrix_b.is_contiguous() || !result.is_contiguous()) {
+            throw std::runtime_error("gemm requires contiguous matrices");
+        }
+
+        if (matrix_a.columns != matrix_b.rows) {
+            throw std::runtime_error("columns of matrix_a must match rows of matrix_b");
+        }
+
+        if (matrix_a.rows != result.rows || matrix_b.columns != result.columns) {
+            throw std::runtime_error("result must be size rows(matrix_a), columns(matrix_b)");
+        }
+
+        if (matrix_a.get_device() != matrix_b.get_device() || matrix_a.get_device() != result.get_device()) {
+            throw std::runtime_error("matrix_a, matrix_b and result are not on the same device");
+        }
+
+        if (matrix_a.get_dtype() != matrix_b.get_dtype() || matrix_a.get_dtype() != result.get_dtype()) {
+            throw std::runtime_error("matrix_a, matrix_b and result share different dtypes");
+        }
+
+        const Dtype current{matrix_a.get_dtype()};
         if (constexpr Dtype given = get_dtype_from_type<T>::type; given != current) {
             throw std::runtime_error(
                 "alpha and beta has a invalid dtype, expected " + dtype_to_string(current));
         }
 
-        result.gemv(matrix, vector, matrix.rows, matrix.columns, &alpha, &beta);
+        result.gemm(matrix_a, matrix_b, matrix_a.rows, matrix_a.columns, matrix_b.columns, &alpha, &beta);
     }
 }
 
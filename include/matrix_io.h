@@ -0,0 +1,46 @@
+//
+// Created by sriram on 2/12/25.
+//
+
+#ifndef MATRIX_IO_H
+#define MATRIX_IO_H
+
+#include <string>
+#include "matrix.h"
+
+/**
+ * On disk matrix format, all fields are native endian:
+ *
+ *   offset  size  field
+ *   0       8     magic "CBRAMTX\0"
+ *   8       4     format version, currently 1
+ *   12      4     Dtype
+ *   16      8     rows
+ *   24      8     columns
+ *   32      8     byte offset of the data section, a multiple of 64
+ *   40      24    reserved, zero
+ *
+ * The data section holds rows * columns elements in row major order.
+ */
+namespace cobraml::core {
+
+    /**
+     * writes a matrix to path, replacing any existing file
+     *
+     * @param matrix the matrix to write
+     * @param path the destination file
+     */
+    void save(const Matrix &matrix, const std::string &path);
+
+    /**
+     * maps a file written by save into memory without copying it, pages are read from disk as they are
+     * first touched. The mapping is private, writes to the returned matrix never reach the file.
+     *
+     * @param path the file to load
+     * @param device CPU or CPU_X
+     * @return a matrix backed by the mapping, it is unmapped once the last matrix sharing it is destroyed
+     */
+    Matrix load(const std::string &path, Device device);
+}
+
+#endif //MATRIX_IO_H
@@ -0,0 +1,88 @@
+//
+// Created by sriram on 2/8/25.
+//
+
+#ifndef QUANTIZED_MATRIX_H
+#define QUANTIZED_MATRIX_H
+
+#include "matrix.h"
+
+namespace cobraml::core {
+
+    /**
+     * An INT8 matrix quantized per row. Row i is reconstructed as (q - zero_points[i]) * scales[i],
+     * storing it takes a quarter of the memory and bandwidth of a FLOAT32 matrix.
+     */
+    class QuantizedMatrix {
+        Matrix data;
+        Matrix scales;
+        Matrix zero_points;
+
+    public:
+        /**
+         * constructor that creates a zero quantized matrix of shape (rows, columns)
+         * @param rows the # of rows in the matrix
+         * @param columns the # of columns in the matrix
+         * @param device the device of the matrix being constructed
+         */
+        QuantizedMatrix(size_t rows, size_t columns, Device device);
+
+        /**
+        * @return the shape of the matrix
+        */
+        [[nodiscard]] Matrix::Shape get_shape() const;
+
+        /**
+        * @return the Device of the matrix
+        */
+        [[nodiscard]] Device get_device() const;
+
+        /**
+         * @return the INT8 quantized values of shape (rows, columns)
+         */
+        [[nodiscard]] const Matrix &get_data() const;
+
+        /**
+         * @return the FLOAT32 scale of every row, shape (1, rows)
+         */
+        [[nodiscard]] const Matrix &get_scales() const;
+
+        /**
+         * @return the INT32 zero point of every row, shape (1, rows)
+         */
+        [[nodiscard]] const Matrix &get_zero_points() const;
+
+        /**
+         * quantizes a FLOAT32 matrix row by row, the range of every row is mapped onto [-128, 127]
+         *
+         * @param matrix the matrix to quantize
+         * @return the quantized matrix
+         */
+        friend QuantizedMatrix quantize(const Matrix &matrix);
+
+        /**
+         * @param matrix the quantized matrix
+         * @return the FLOAT32 approximation of the matrix
+         */
+        friend Matrix dequantize(const QuantizedMatrix &matrix);
+
+        /**
+         * Quantized Matrix Vector Multiplication.
+         * Performs y=αAx+βy, x is quantized to INT8 on the fly, products are accumulated in INT32 and
+         * rescaled to FLOAT32 once per row
+         *
+         * @param matrix A
+         * @param vector x, a FLOAT32 vector
+         * @param result y, a FLOAT32 vector
+         * @param alpha α
+         * @param beta β
+         */
+        friend void gemv(const QuantizedMatrix &matrix, const Matrix &vector, Matrix &result, float alpha, float beta);
+    };
+
+    QuantizedMatrix quantize(const Matrix &matrix);
+    Matrix dequantize(const QuantizedMatrix &matrix);
+    void gemv(const QuantizedMatrix &matrix, const Matrix &vector, Matrix &result, float alpha, float beta);
+}
+
+#endif //QUANTIZED_MATRIX_H
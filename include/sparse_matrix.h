@@ -0,0 +1,241 @@
+//
+// Created by sriram on 2/20/25.
+//
+
+#ifndef SPARSE_MATRIX_H
+#define SPARSE_MATRIX_H
+
+#include <algorithm>
+#include <numeric>
+#include "matrix.h"
+
+namespace cobraml::core {
+
+    /**
+     * A matrix in compressed sparse row (CSR) form. The nonzeros of row i are
+     * values[row_pointers[i], row_pointers[i + 1]), in the columns held at the same positions of
+     * column_indices, sorted by column. All three arrays are ordinary matrices, so they are allocated,
+     * pooled and placed like any other buffer on the device.
+     */
+    class SparseMatrix {
+        size_t rows;
+        size_t columns;
+        size_t nonzeros;
+        Matrix row_pointers;
+        Matrix column_indices;
+        Matrix values;
+
+        template<typename T>
+        SparseMatrix(
+            size_t rows,
+            size_t columns,
+            const std::vector<int64_t> &pointers,
+            const std::vector<int64_t> &indices,
+            const std::vector<T> &nonzero_values,
+            Device device);
+
+    public:
+        /**
+        * @return the shape of the matrix
+        */
+        [[nodiscard]] Matrix::Shape get_shape() const;
+
+        /**
+        * @return the Device of the matrix
+        */
+        [[nodiscard]] Device get_device() const;
+
+        /**
+         * @return the dtype of the nonzeros
+         */
+        [[nodiscard]] Dtype get_dtype() const;
+
+        /**
+         * @return the number of stored nonzeros
+         */
+        [[nodiscard]] size_t get_nonzeros() const;
+
+        /**
+         * @return the INT64 row offsets, shape (1, rows + 1)
+         */
+        [[nodiscard]] const Matrix &get_row_pointers() const;
+
+        /**
+         * @return the INT64 column of every nonzero, shape (1, max(nonzeros, 1))
+         */
+        [[nodiscard]] const Matrix &get_column_indices() const;
+
+        /**
+         * @return the nonzeros, shape (1, max(nonzeros, 1))
+         */
+        [[nodiscard]] const Matrix &get_values() const;
+
+        /**
+         * builds a CSR matrix from coordinate (COO) triplets, the triplets may come in any order and
+         * duplicates of the same (row, column) are summed
+         *
+         * @param rows the # of rows in the matrix
+         * @param columns the # of columns in the matrix
+         * @param row_indices the row of every triplet
+         * @param column_indices the column of every triplet
+         * @param values the value of every triplet
+         * @param device the device of the matrix being constructed
+         * @return the sparse matrix
+         */
+        template<typename T>
+        friend SparseMatrix from_triplets(
+            size_t rows,
+            size_t columns,
+            const std::vector<size_t> &row_indices,
+            const std::vector<size_t> &column_indices,
+            const std::vector<T> &values,
+            Device device);
+
+        /**
+         * Sparse Matrix Vector Multiplication.
+         * Performs y=αAx+βy, the nonzeros are split evenly between the threads so a few very long rows do
+         * not leave the other threads idle
+         *
+         * @param matrix A
+         * @param vector x
+         * @param result y
+         * @param alpha α
+         * @param beta β
+         */
+        template<typename T>
+        friend void gemv(const SparseMatrix &matrix, const Matrix &vector, Matrix &result, T alpha, T beta);
+    };
+
+    template<typename T>
+    SparseMatrix::SparseMatrix(
+        size_t const rows,
+        size_t const columns,
+        const std::vector<int64_t> &pointers,
+        const std::vector<int64_t> &indices,
+        const std::vector<T> &nonzero_values,
+        Device const device):
+        rows(rows),
+        columns(columns),
+        nonzeros(nonzero_values.size()),
+        row_pointers(1, rows + 1, device, INT64, UNINITIALIZED),
+        // an empty matrix still gets one slot, arrays cannot be empty
+        column_indices(1, std::max<size_t>(nonzero_values.size(), 1), device, INT64),
+        values(1, std::max<size_t>(nonzero_values.size(), 1), device, get_dtype_from_type<T>::type) {
+        row_pointers.copy_vector(pointers);
+
+        if (nonzeros > 0) {
+            column_indices.copy_vector(indices);
+            values.copy_vector(nonzero_values);
+        }
+    }
+
+    template<typename T>
+    SparseMatrix from_triplets(
+        size_t const rows,
+        size_t const columns,
+        const std::vector<size_t> &row_indices,
+        const std::vector<size_t> &column_indices,
+        const std::vector<T> &values,
+        Device const device) {
+        constexpr Dtype dtype{get_dtype_from_type<T>::type};
+        is_invalid(dtype);
+
+        if (rows == 0 || columns == 0) {
+            throw std::runtime_error("sparse matrix must have at least one row and one column");
+        }
+
+        if (row_indices.size() != values.size() || column_indices.size() != values.size()) {
+            throw std::runtime_error("row indices, column indices and values have different lengths");
+        }
+
+        std::vector<int64_t> pointers(rows + 1, 0);
+
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (row_indices[i] >= rows || column_indices[i] >= columns) {
+                throw std::out_of_range("triplet is out of range");
+            }
+
+            ++pointers[row_indices[i] + 1];
+        }
+
+        std::partial_sum(pointers.begin(), pointers.end(), pointers.begin());
+
+        // bucket the triplets by row, then sort every row by column
+        std::vector<size_t> order(values.size());
+        std::vector<int64_t> next(pointers.begin(), pointers.end() - 1);
+
+        for (size_t i = 0; i < values.size(); ++i) {
+            order[static_cast<size_t>(next[row_indices[i]]++)] = i;
+        }
+
+        std::vector<int64_t> indices;
+        std::vector<T> nonzero_values;
+        indices.reserve(values.size());
+        nonzero_values.reserve(values.size());
+
+        for (size_t row = 0; row < rows; ++row) {
+            auto const begin{order.begin() + pointers[row]};
+            auto const end{order.begin() + pointers[row + 1]};
+
+            std::stable_sort(begin, end, [&](size_t const lhs, size_t const rhs) {
+                return column_indices[lhs] < column_indices[rhs];
+            });
+
+            pointers[row] = static_cast<int64_t>(indices.size());
+
+            for (auto it = begin; it != end; ++it) {
+                auto const column{static_cast<int64_t>(column_indices[*it])};
+
+                if (static_cast<int64_t>(indices.size()) > pointers[row] && indices.back() == column) {
+                    nonzero_values.back() = static_cast<T>(nonzero_values.back() + values[*it]);
+                    continue;
+                }
+
+                indices.push_back(column);
+                nonzero_values.push_back(values[*it]);
+            }
+        }
+
+        pointers[rows] = static_cast<int64_t>(indices.size());
+
+        return {rows, columns, pointers, indices, nonzero_values, device};
+    }
+
+    template<typename T>
+    void gemv(const SparseMatrix &matrix, const Matrix &vector, Matrix &result, const T alpha, const T beta) {
+        if (!vector.is_vector()) {
+            throw std::runtime_error("vector is a matrix");
+        }
+
+        if (!result.is_vector()) {
+            throw std::runtime_error("result is a matrix");
+        }
+
+        if (matrix.columns != vector.get_shape().columns) {
+            throw std::runtime_error("vector and matrix have different columns lengths");
+        }
+
+        if (matrix.rows != result.get_shape().columns) {
+            throw std::runtime_error("result must be size 1, rows(matrix)");
+        }
+
+        if (matrix.get_device() != vector.get_device() || matrix.get_device() != result.get_device()) {
+            throw std::runtime_error("vector, matrix and result are not on the same device");
+        }
+
+        const Dtype current{matrix.get_dtype()};
+        if (current != vector.get_dtype() || current != result.get_dtype()) {
+            throw std::runtime_error("vector, matrix and result share different dtypes");
+        }
+
+        if (constexpr Dtype given = get_dtype_from_type<T>::type; given != current) {
+            throw std::runtime_error(
+                "alpha and beta has a invalid dtype, expected " + dtype_to_string(current));
+        }
+
+        result.sparse_gemv(
+            matrix.row_pointers, matrix.column_indices, matrix.values, vector, matrix.rows, &alpha, &beta);
+    }
+}
+
+#endif //SPARSE_MATRIX_H
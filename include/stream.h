@@ -0,0 +1,200 @@
+//
+// Created by sriram on 2/24/25.
+//
+
+#ifndef STREAM_H
+#define STREAM_H
+
+#include <functional>
+#include <future>
+#include <memory>
+#include "matrix.h"
+#include "sparse_matrix.h"
+
+/**
+ * Asynchronous execution. Work enqueued on a stream runs in order on a worker thread shared with the other
+ * streams, separate streams run concurrently. The pool grows to one worker per stream with pending work, up to
+ * one per hardware thread (at least two). Past that busy streams take turns, one task at a time, so work on a
+ * stream must not block on an event of another stream.
+ *
+ * Every operation still runs its own OpenMP team of get_thread_count() threads, when several streams are
+ * busy at once lower the thread count so the teams fit on the machine, and leave pinning off since every
+ * team would be pinned to the same cpus.
+ */
+namespace cobraml::core {
+
+    /**
+     * completes when its operation finishes, get() rethrows the exception the operation threw
+     */
+    using Event = std::shared_future<void>;
+
+    class Stream {
+    public:
+        struct StreamImpl;
+
+    private:
+        std::shared_ptr<StreamImpl> impl;
+
+    public:
+        Stream();
+
+        /**
+         * waits for the work already enqueued
+         */
+        ~Stream();
+
+        Stream(const Stream &other) = delete;
+        Stream &operator=(const Stream &other) = delete;
+
+        /**
+         * runs work after everything enqueued before it on this stream. An exception thrown by work is
+         * stored in the returned event, later work still runs
+         *
+         * @param work the operation
+         * @return an event that completes when work finishes
+         */
+        Event enqueue(std::function<void()> work);
+
+        /**
+         * as enqueue, for work that produces a value
+         *
+         * @param work the operation
+         * @return a future holding the value work returned, or the exception it threw
+         */
+        template<typename R>
+        std::shared_future<R> enqueue(std::function<R()> work) {
+            auto promise{std::make_shared<std::promise<R>>()};
+            std::shared_future<R> result{promise->get_future().share()};
+
+            enqueue([promise, work = std::move(work)]() {
+                try {
+                    promise->set_value(work());
+                } catch (...) {
+                    promise->set_exception(std::current_exception());
+                }
+            });
+
+            return result;
+        }
+
+        /**
+         * blocks until all work enqueued so far has finished
+         */
+        void synchronize() const;
+    };
+
+    /**
+     * @return the worker threads the stream pool currently holds
+     */
+    size_t stream_workers();
+
+    /**
+     * The *_async operations enqueue the operation of the same name. The matrices are captured by handle,
+     * they share their buffers with the arguments, so the results land in the matrices passed in and the
+     * inputs must not be written until the event completes. Invalid arguments are reported through the event.
+     */
+    template<typename T>
+    Event gemv_async(
+        Stream &stream, const Matrix &matrix, const Matrix &vector, Matrix &result, const T alpha, const T beta,
+        const bool transpose = false) {
+        return stream.enqueue([matrix, vector, result, alpha, beta, transpose]() mutable {
+            gemv(matrix, vector, result, alpha, beta, transpose);
+        });
+    }
+
+    template<typename T>
+    Event gemv_batched_async(
+        Stream &stream, const Matrix &matrix, const Matrix &queries, Matrix &result, const T alpha, const T beta) {
+        return stream.enqueue([matrix, queries, result, alpha, beta]() mutable {
+            gemv_batched(matrix, queries, result, alpha, beta);
+        });
+    }
+
+    template<typename T>
+    Event gemv_topk_async(
+        Stream &stream, const Matrix &matrix, const Matrix &vector, Matrix &indices, Matrix &scores, const T alpha) {
+        return stream.enqueue([matrix, vector, indices, scores, alpha]() mutable {
+            gemv_topk(matrix, vector, indices, scores, alpha);
+        });
+    }
+
+    template<typename T>
+    Event gemm_async(
+        Stream &stream, const Matrix &matrix_a, const Matrix &matrix_b, Matrix &result, const T alpha, const T beta) {
+        return stream.enqueue([matrix_a, matrix_b, result, alpha, beta]() mutable {
+            gemm(matrix_a, matrix_b, result, alpha, beta);
+        });
+    }
+
+    template<typename T>
+    Event gemv_sparse_query_async(
+        Stream &stream,
+        const Matrix &matrix,
+        const Matrix &indices,
+        const Matrix &values,
+        Matrix &result,
+        const T alpha,
+        const T beta,
+        const bool transpose = false) {
+        return stream.enqueue([matrix, indices, values, result, alpha, beta, transpose]() mutable {
+            gemv_sparse_query(matrix, indices, values, result, alpha, beta, transpose);
+        });
+    }
+
+    template<typename T>
+    Event gemv_async(
+        Stream &stream, const SparseMatrix &matrix, const Matrix &vector, Matrix &result, const T alpha, const T beta) {
+        return stream.enqueue([matrix, vector, result, alpha, beta]() mutable {
+            gemv(matrix, vector, result, alpha, beta);
+        });
+    }
+
+    template<typename T>
+    Event axpy_async(Stream &stream, const T alpha, const Matrix &x, Matrix &y) {
+        return stream.enqueue([alpha, x, y]() mutable {
+            axpy(alpha, x, y);
+        });
+    }
+
+    template<typename T>
+    Event scal_async(Stream &stream, const T alpha, Matrix &x) {
+        return stream.enqueue([alpha, x]() mutable {
+            scal(alpha, x);
+        });
+    }
+
+    /**
+     * The operations below return a value, it is delivered through the returned future
+     */
+    template<typename T>
+    std::shared_future<T> dot_async(Stream &stream, const Matrix &x, const Matrix &y) {
+        return stream.enqueue(std::function<T()>{[x, y]() { return dot<T>(x, y); }});
+    }
+
+    template<typename T>
+    std::shared_future<T> nrm2_async(Stream &stream, const Matrix &x) {
+        return stream.enqueue(std::function<T()>{[x]() { return nrm2<T>(x); }});
+    }
+
+    template<typename T>
+    std::shared_future<T> asum_async(Stream &stream, const Matrix &x) {
+        return stream.enqueue(std::function<T()>{[x]() { return asum<T>(x); }});
+    }
+
+    inline std::shared_future<size_t> iamax_async(Stream &stream, const Matrix &x) {
+        return stream.enqueue(std::function<size_t()>{[x]() { return iamax(x); }});
+    }
+
+    inline std::shared_future<Matrix> reduce_rows_async(Stream &stream, const Matrix &matrix, Reduction reduction) {
+        return stream.enqueue(std::function<Matrix()>{
+            [matrix, reduction]() { return reduce_rows(matrix, reduction); }});
+    }
+
+    inline std::shared_future<Matrix> reduce_columns_async(
+        Stream &stream, const Matrix &matrix, Reduction reduction) {
+        return stream.enqueue(std::function<Matrix()>{
+            [matrix, reduction]() { return reduce_columns(matrix, reduction); }});
+    }
+}
+
+#endif //STREAM_H
@@ -0,0 +1,68 @@
+//
+// Created by sriram on 2/16/25.
+//
+
+#ifndef THREADING_H
+#define THREADING_H
+
+#include <cstddef>
+
+namespace cobraml::core {
+
+    /**
+     * sets the number of threads the kernels use
+     *
+     * @param count the thread count, 0 restores default_thread_count()
+     */
+    void set_thread_count(size_t count);
+
+    /**
+     * @return the number of threads the kernels use
+     */
+    size_t get_thread_count();
+
+    /**
+     * The thread count used when none is set. In order of precedence: the THREAD_COUNT build option,
+     * OMP_NUM_THREADS, and otherwise one thread per physical core the process may run on, SMT siblings
+     * only add contention to the bandwidth bound kernels.
+     *
+     * @return the default thread count
+     */
+    size_t default_thread_count();
+
+    /**
+     * pins kernel thread i to the i-th cpu of the process affinity mask, taken at start up. Disabling
+     * pinning restores that mask. The calling thread is kernel thread 0 and gets pinned as well.
+     *
+     * @param enabled whether to pin
+     */
+    void set_thread_pinning(bool enabled);
+
+    /**
+     * @return whether kernel threads are pinned
+     */
+    bool get_thread_pinning();
+
+    /**
+     * kernels with less work than the threshold run single threaded, spawning a team costs more than
+     * it saves for them
+     *
+     * @param work the threshold, in elements or multiply adds
+     */
+    void set_parallel_threshold(size_t work);
+
+    /**
+     * @return the parallel threshold in elements or multiply adds
+     */
+    size_t get_parallel_threshold();
+
+    /**
+     * sizes the OpenMP team of the next parallel region from the work it does: one thread below the
+     * parallel threshold and get_thread_count() threads otherwise, pinned when pinning is enabled
+     *
+     * @param work the number of elements or multiply adds the kernel performs
+     */
+    void set_num_threads(size_t work);
+}
+
+#endif //THREADING_H
@@ -0,0 +1,61 @@
+//
+// Created by sriram on 2/18/25.
+//
+
+#ifndef TUNING_H
+#define TUNING_H
+
+#include <string>
+#include "enums.h"
+
+/**
+ * The CPU gemv picks one of several kernels per (dtype, rows bucket, columns bucket, thread count),
+ * buckets are powers of two. Shapes nobody tuned use the default kernel.
+ */
+namespace cobraml::core {
+
+    /**
+     * when enabled, the first gemv on an untuned shape times every kernel on a scratch result and
+     * remembers the fastest
+     *
+     * @param enabled whether to tune on first use
+     */
+    void set_autotuning(bool enabled);
+
+    /**
+     * @return whether untuned shapes are tuned on first use
+     */
+    bool get_autotuning();
+
+    /**
+     * loads the tuning entries stored at path, if the file exists, and writes every later result back
+     * to it. Results found by autotuning are saved on a best effort basis, a file that cannot be written
+     * never fails a gemv.
+     *
+     * @param path the tuning file, an empty path stops persisting
+     */
+    void set_tuning_file(const std::string &path);
+
+    /**
+     * times every gemv kernel on random data of the given shape and records the fastest for the current
+     * thread count
+     *
+     * @param dtype one of the integer or FLOAT32, FLOAT64 dtypes
+     * @param rows rows of the matrix
+     * @param columns columns of the matrix
+     * @throws std::runtime_error if the tuning file cannot be written, the result is still recorded
+     */
+    void calibrate_gemv(Dtype dtype, size_t rows, size_t columns);
+
+    /**
+     * @return the name of the kernel gemv uses for the shape at the current thread count
+     */
+    std::string tuned_gemv_kernel(Dtype dtype, size_t rows, size_t columns);
+
+    /**
+     * forgets every tuning entry, the tuning file is left untouched
+     */
+    void clear_tuning();
+}
+
+#endif //TUNING_H
@@ -0,0 +1,354 @@
+//
+// Created by sriram on 2/2/25.
+//
+
+#ifndef ACCELERATED_KERNELS_H
+#define ACCELERATED_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * Shared declarations for the instruction set specific translation units. Each of those units is
+ * compiled with its own -m flags, so everything defined here must end up with internal linkage,
+ * otherwise the linker may hand an AVX-512 copy of a function to a baseline caller.
+ */
+namespace cobraml::core {
+    void set_num_threads(size_t work);
+
+    template<typename NumType>
+    using gemv_kernel = void (*)(
+        const NumType *matrix,
+        const NumType *vector,
+        NumType *dest,
+        NumType alpha,
+        NumType beta,
+        size_t rows,
+        size_t columns,
+        size_t leading_dimension);
+
+    using quantized_gemv_kernel = void (*)(
+        const int8_t *matrix,
+        const float *scales,
+        const int32_t *zero_points,
+        const int8_t *vector,
+        int32_t vector_sum,
+        float vector_scale,
+        float *dest,
+        float alpha,
+        float beta,
+        size_t rows,
+        size_t columns);
+
+    /**
+     * gemv over a FLOAT16 or BFLOAT16 matrix passed as raw bits, everything else is FLOAT32
+     */
+    using half_gemv_kernel = void (*)(
+        const uint16_t *matrix,
+        const float *vector,
+        float *dest,
+        float alpha,
+        float beta,
+        size_t rows,
+        size_t columns,
+        size_t leading_dimension);
+
+    /**
+     * the set of kernels one instruction set level provides, a level may leave an entry empty
+     */
+    struct KernelTable {
+        gemv_kernel<double> gemv_f64;
+        gemv_kernel<float> gemv_f32;
+        gemv_kernel<int8_t> gemv_i8;
+        gemv_kernel<int16_t> gemv_i16;
+        gemv_kernel<int32_t> gemv_i32;
+        gemv_kernel<int64_t> gemv_i64;
+        quantized_gemv_kernel quantized_gemv;
+        half_gemv_kernel gemv_f16;
+        half_gemv_kernel gemv_bf16;
+    };
+
+    KernelTable sse_kernels();
+    KernelTable avx2_kernels();
+    KernelTable avx512_kernels();
+
+#define SIMD_ROW_BLOCK 4
+
+    /**
+     * the gemv epilogue y = αp + βy, y is not read when β is 0 so it may start out uninitialized
+     */
+    template<typename NumType, typename PartialType>
+    static void simd_store(NumType &dest, const PartialType partial, const NumType alpha, const NumType beta) {
+        if (beta == 0) {
+            dest = static_cast<NumType>(partial * alpha);
+            return;
+        }
+
+        dest = static_cast<NumType>(dest * beta + partial * alpha);
+    }
+
+    /**
+     * Register blocked gemv shared by every instruction set level. Vec describes one register
+     * worth of NumType: zero() returns an empty accumulator, load() reads lanes elements,
+     * fma(acc, a, b) returns acc + a * b and sum() reduces an accumulator to a scalar.
+     * Vec must live in an anonymous namespace so every instantiation has internal linkage.
+     * Consecutive rows of the matrix start leading_dimension elements apart.
+     */
+    template<typename Vec>
+    static void simd_gemv(
+        const typename Vec::type *matrix,
+        const typename Vec::type *vector,
+        typename Vec::type *dest,
+        const typename Vec::type alpha,
+        const typename Vec::type beta,
+        const size_t rows,
+        const size_t columns,
+        const size_t leading_dimension) {
+        using NumType = typename Vec::type;
+        set_num_threads(rows * columns);
+        size_t start;
+
+#pragma omp parallel for default(none) shared(alpha, beta, matrix, vector, dest, rows, columns, leading_dimension) private(start) schedule(static)
+        for (start = 0; start < rows; start += SIMD_ROW_BLOCK) {
+            if (start + SIMD_ROW_BLOCK > rows) {
+                for (size_t row = start; row < rows; ++row) {
+                    const NumType *r0 = matrix + row * leading_dimension;
+                    auto acc0 = Vec::zero();
+
+                    size_t i = 0;
+                    for (; i + Vec::lanes <= columns; i += Vec::lanes) {
+                        acc0 = Vec::fma(acc0, Vec::load(r0 + i), Vec::load(vector + i));
+                    }
+
+                    NumType partial = Vec::sum(acc0);
+                    for (; i < columns; ++i) {
+                        partial = static_cast<NumType>(partial + r0[i] * vector[i]);
+                    }
+
+                    simd_store(dest[row], partial, alpha, beta);
+                }
+
+                continue;
+            }
+
+            const NumType *r0 = matrix + start * leading_dimension;
+            const NumType *r1 = r0 + leading_dimension;
+            const NumType *r2 = r1 + leading_dimension;
+            const NumType *r3 = r2 + leading_dimension;
+
+            auto acc0 = Vec::zero();
+            auto acc1 = Vec::zero();
+            auto acc2 = Vec::zero();
+            auto acc3 = Vec::zero();
+
+            size_t i = 0;
+            for (; i + Vec::lanes <= columns; i += Vec::lanes) {
+                auto const x = Vec::load(vector + i);
+                acc0 = Vec::fma(acc0, Vec::load(r0 + i), x);
+                acc1 = Vec::fma(acc1, Vec::load(r1 + i), x);
+                acc2 = Vec::fma(acc2, Vec::load(r2 + i), x);
+                acc3 = Vec::fma(acc3, Vec::load(r3 + i), x);
+            }
+
+            NumType partial[SIMD_ROW_BLOCK]{Vec::sum(acc0), Vec::sum(acc1), Vec::sum(acc2), Vec::sum(acc3)};
+
+            for (; i < columns; ++i) {
+                partial[0] = static_cast<NumType>(partial[0] + r0[i] * vector[i]);
+                partial[1] = static_cast<NumType>(partial[1] + r1[i] * vector[i]);
+                partial[2] = static_cast<NumType>(partial[2] + r2[i] * vector[i]);
+                partial[3] = static_cast<NumType>(partial[3] + r3[i] * vector[i]);
+            }
+
+            for (size_t r = 0; r < SIMD_ROW_BLOCK; ++r) {
+                simd_store(dest[start + r], partial[r], alpha, beta);
+            }
+        }
+    }
+
+    /**
+     * Quantized gemv shared by every instruction set level. Vec follows the simd_gemv contract for int8
+     * operands but must accumulate widened products in int32 lanes (multiply add instructions), its sum()
+     * returns the exact int32 dot product.
+     */
+    template<typename Vec>
+    static void simd_quantized_gemv(
+        const int8_t *matrix,
+        const float *scales,
+        const int32_t *zero_points,
+        const int8_t *vector,
+        const int32_t vector_sum,
+        const float vector_scale,
+        float *dest,
+        const float alpha,
+        const float beta,
+        const size_t rows,
+        const size_t columns) {
+        set_num_threads(rows * columns);
+        size_t start;
+
+#pragma omp parallel for default(none) shared(matrix, scales, zero_points, vector, vector_sum, vector_scale, dest, alpha, beta, rows, columns) private(start) schedule(static)
+        for (start = 0; start < rows; start += SIMD_ROW_BLOCK) {
+            size_t const block = rows - start < SIMD_ROW_BLOCK ? rows - start : SIMD_ROW_BLOCK;
+            int32_t partial[SIMD_ROW_BLOCK]{};
+
+            if (block == SIMD_ROW_BLOCK) {
+                const int8_t *r0 = matrix + start * columns;
+                const int8_t *r1 = r0 + columns;
+                const int8_t *r2 = r1 + columns;
+                const int8_t *r3 = r2 + columns;
+
+                auto acc0 = Vec::zero();
+                auto acc1 = Vec::zero();
+                auto acc2 = Vec::zero();
+                auto acc3 = Vec::zero();
+
+                size_t i = 0;
+                for (; i + Vec::lanes <= columns; i += Vec::lanes) {
+                    auto const x = Vec::load(vector + i);
+                    acc0 = Vec::fma(acc0, Vec::load(r0 + i), x);
+                    acc1 = Vec::fma(acc1, Vec::load(r1 + i), x);
+                    acc2 = Vec::fma(acc2, Vec::load(r2 + i), x);
+                    acc3 = Vec::fma(acc3, Vec::load(r3 + i), x);
+                }
+
+                partial[0] = Vec::sum(acc0);
+                partial[1] = Vec::sum(acc1);
+                partial[2] = Vec::sum(acc2);
+                partial[3] = Vec::sum(acc3);
+
+                for (; i < columns; ++i) {
+                    partial[0] += r0[i] * vector[i];
+                    partial[1] += r1[i] * vector[i];
+                    partial[2] += r2[i] * vector[i];
+                    partial[3] += r3[i] * vector[i];
+                }
+            } else {
+                for (size_t r = 0; r < block; ++r) {
+                    const int8_t *row = matrix + (start + r) * columns;
+                    auto acc = Vec::zero();
+
+                    size_t i = 0;
+                    for (; i + Vec::lanes <= columns; i += Vec::lanes) {
+                        acc = Vec::fma(acc, Vec::load(row + i), Vec::load(vector + i));
+                    }
+
+                    partial[r] = Vec::sum(acc);
+                    for (; i < columns; ++i) {
+                        partial[r] += row[i] * vector[i];
+                    }
+                }
+            }
+
+            for (size_t r = 0; r < block; ++r) {
+                size_t const row = start + r;
+                int64_t const centered = static_cast<int64_t>(partial[r]) -
+                                         static_cast<int64_t>(zero_points[row]) * vector_sum;
+                float const dot = static_cast<float>(centered) * scales[row] * vector_scale;
+                simd_store(dest[row], dot, alpha, beta);
+            }
+        }
+    }
+
+    /**
+     * Mixed precision gemv shared by every instruction set level. Vec follows the simd_gemv contract for
+     * FLOAT32 and adds widen(), which loads lanes half precision values as FLOAT32, and widen_scalar()
+     * for the column tail.
+     */
+    template<typename Vec>
+    static void simd_half_gemv(
+        const uint16_t *matrix,
+        const float *vector,
+        float *dest,
+        const float alpha,
+        const float beta,
+        const size_t rows,
+        const size_t columns,
+        const size_t leading_dimension) {
+        set_num_threads(rows * columns);
+        size_t start;
+
+#pragma omp parallel for default(none) shared(alpha, beta, matrix, vector, dest, rows, columns, leading_dimension) private(start) schedule(static)
+        for (start = 0; start < rows; start += SIMD_ROW_BLOCK) {
+            size_t const block = rows - start < SIMD_ROW_BLOCK ? rows - start : SIMD_ROW_BLOCK;
+            float partial[SIMD_ROW_BLOCK]{};
+
+            if (block == SIMD_ROW_BLOCK) {
+                const uint16_t *r0 = matrix + start * leading_dimension;
+                const uint16_t *r1 = r0 + leading_dimension;
+                const uint16_t *r2 = r1 + leading_dimension;
+                const uint16_t *r3 = r2 + leading_dimension;
+
+                auto acc0 = Vec::zero();
+                auto acc1 = Vec::zero();
+                auto acc2 = Vec::zero();
+                auto acc3 = Vec::zero();
+
+                size_t i = 0;
+                for (; i + Vec::lanes <= columns; i += Vec::lanes) {
+                    auto const x = Vec::load(vector + i);
+                    acc0 = Vec::fma(acc0, Vec::widen(r0 + i), x);
+                    acc1 = Vec::fma(acc1, Vec::widen(r1 + i), x);
+                    acc2 = Vec::fma(acc2, Vec::widen(r2 + i), x);
+                    acc3 = Vec::fma(acc3, Vec::widen(r3 + i), x);
+                }
+
+                partial[0] = Vec::sum(acc0);
+                partial[1] = Vec::sum(acc1);
+                partial[2] = Vec::sum(acc2);
+                partial[3] = Vec::sum(acc3);
+
+                for (; i < columns; ++i) {
+                    partial[0] += Vec::widen_scalar(r0[i]) * vector[i];
+                    partial[1] += Vec::widen_scalar(r1[i]) * vector[i];
+                    partial[2] += Vec::widen_scalar(r2[i]) * vector[i];
+                    partial[3] += Vec::widen_scalar(r3[i]) * vector[i];
+                }
+            } else {
+                for (size_t r = 0; r < block; ++r) {
+                    const uint16_t *row = matrix + (start + r) * leading_dimension;
+                    auto acc = Vec::zero();
+
+                    size_t i = 0;
+                    for (; i + Vec::lanes <= columns; i += Vec::lanes) {
+                        acc = Vec::fma(acc, Vec::widen(row + i), Vec::load(vector + i));
+                    }
+
+                    partial[r] = Vec::sum(acc);
+                    for (; i < columns; ++i) {
+                        partial[r] += Vec::widen_scalar(row[i]) * vector[i];
+                    }
+                }
+            }
+
+            for (size_t r = 0; r < block; ++r) {
+                simd_store(dest[start + r], partial[r], alpha, beta);
+            }
+        }
+    }
+
+    /**
+     * bfloat16 is the upper half of a FLOAT32, widening is a shift
+     */
+    static inline float bfloat_to_float(uint16_t const bits) {
+        uint32_t const widened = static_cast<uint32_t>(bits) << 16;
+        float value;
+        std::memcpy(&value, &widened, sizeof(value));
+        return value;
+    }
+
+    /**
+     * sums the lanes of a register after it has been spilled to memory
+     */
+    template<typename Acc, typename Lane, typename NumType, size_t count>
+    static NumType spill_sum(const Lane (&lanes)[count]) {
+        Acc total = 0;
+        for (size_t i = 0; i < count; ++i) {
+            total = static_cast<Acc>(total + static_cast<Acc>(lanes[i]));
+        }
+
+        return static_cast<NumType>(total);
+    }
+}
+
+#endif //ACCELERATED_KERNELS_H
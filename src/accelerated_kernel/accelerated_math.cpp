@@ -0,0 +1,251 @@
+//
+// Created by sriram on 2/2/25.
+//
+
+#include "accelerated_math.h"
+#include <array>
+#include <atomic>
+#include "accelerated_kernels.h"
+
+namespace cobraml::core {
+
+    static bool cpu_supports(SimdLevel const level) {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_cpu_init();
+        switch (level) {
+            case SCALAR: return true;
+            case SSE: return __builtin_cpu_supports("sse4.1");
+            case AVX2: {
+                return __builtin_cpu_supports("avx2") &&
+                       __builtin_cpu_supports("fma") &&
+                       __builtin_cpu_supports("f16c");
+            }
+            case AVX512: {
+                return __builtin_cpu_supports("avx512f") &&
+                       __builtin_cpu_supports("avx512bw") &&
+                       __builtin_cpu_supports("avx512dq") &&
+                       __builtin_cpu_supports("avx512vl") &&
+                       __builtin_cpu_supports("f16c");
+            }
+        }
+        return false;
+#else
+        return level == SCALAR;
+#endif
+    }
+
+    static const std::array<KernelTable, 4> &kernel_tables() {
+        static const std::array<KernelTable, 4> tables{
+            KernelTable{},
+            sse_kernels(),
+            avx2_kernels(),
+            avx512_kernels(),
+        };
+
+        return tables;
+    }
+
+    static std::atomic<SimdLevel> &active_level() {
+        static std::atomic<SimdLevel> level{detected_simd_level()};
+        return level;
+    }
+
+    SimdLevel detected_simd_level() {
+        static const SimdLevel detected = [] {
+            // a level is only usable if the host supports it and this build compiled its kernels
+            for (SimdLevel level: {AVX512, AVX2, SSE}) {
+                if (cpu_supports(level) && kernel_tables()[level].gemv_f32 != nullptr)
+                    return level;
+            }
+
+            return SCALAR;
+        }();
+
+        return detected;
+    }
+
+    SimdLevel get_simd_level() {
+        return active_level().load();
+    }
+
+    void set_simd_level(SimdLevel const level) {
+        if (detected_simd_level() < level) {
+            throw std::runtime_error(
+                simd_level_to_string(level) + " is not supported on this host, the widest available level is " +
+                simd_level_to_string(detected_simd_level()));
+        }
+
+        active_level().store(level);
+    }
+
+    void AcceleratedMath::gemv(
+        const void *matrix,
+        const void *vector,
+        void *dest,
+        const void *alpha,
+        const void *beta,
+        size_t const rows,
+        size_t const columns,
+        size_t const leading_dimension,
+        bool const transpose,
+        Dtype const dtype) {
+
+        const SimdLevel level{get_simd_level()};
+
+        // the transposed kernel is a column axpy the compiler already vectorizes
+        if (level == SCALAR || transpose) {
+            StandardMath::gemv(matrix, vector, dest, alpha, beta, rows, columns, leading_dimension, transpose, dtype);
+            return;
+        }
+
+        const KernelTable &table{kernel_tables()[level]};
+
+        switch (dtype) {
+            case FLOAT64: {
+                table.gemv_f64(
+                    static_cast<const double *>(matrix),
+                    static_cast<const double *>(vector),
+                    static_cast<double *>(dest),
+                    *static_cast<const double *>(alpha),
+                    *static_cast<const double *>(beta),
+                    rows,
+                    columns,
+                    leading_dimension);
+                return;
+            }
+            case FLOAT32: {
+                table.gemv_f32(
+                    static_cast<const float *>(matrix),
+                    static_cast<const float *>(vector),
+                    static_cast<float *>(dest),
+                    *static_cast<const float *>(alpha),
+                    *static_cast<const float *>(beta),
+                    rows,
+                    columns,
+                    leading_dimension);
+                return;
+            }
+            case INT8: {
+                table.gemv_i8(
+                    static_cast<const int8_t *>(matrix),
+                    static_cast<const int8_t *>(vector),
+                    static_cast<int8_t *>(dest),
+                    *static_cast<const int8_t *>(alpha),
+                    *static_cast<const int8_t *>(beta),
+                    rows,
+                    columns,
+                    leading_dimension);
+                return;
+            }
+            case INT16: {
+                table.gemv_i16(
+                    static_cast<const int16_t *>(matrix),
+                    static_cast<const int16_t *>(vector),
+                    static_cast<int16_t *>(dest),
+                    *static_cast<const int16_t *>(alpha),
+                    *static_cast<const int16_t *>(beta),
+                    rows,
+                    columns,
+                    leading_dimension);
+                return;
+            }
+            case INT32: {
+                table.gemv_i32(
+                    static_cast<const int32_t *>(matrix),
+                    static_cast<const int32_t *>(vector),
+                    static_cast<int32_t *>(dest),
+                    *static_cast<const int32_t *>(alpha),
+                    *static_cast<const int32_t *>(beta),
+                    rows,
+                    columns,
+                    leading_dimension);
+                return;
+            }
+            case INT64: {
+                table.gemv_i64(
+                    static_cast<const int64_t *>(matrix),
+                    static_cast<const int64_t *>(vector),
+                    static_cast<int64_t *>(dest),
+                    *static_cast<const int64_t *>(alpha),
+                    *static_cast<const int64_t *>(beta),
+                    rows,
+                    columns,
+                    leading_dimension);
+                return;
+            }
+            case FLOAT16: {
+                if (table.gemv_f16 == nullptr) {
+                    StandardMath::gemv(matrix, vector, dest, alpha, beta, rows, columns, leading_dimension, false, dtype);
+                    return;
+                }
+
+                table.gemv_f16(
+                    static_cast<const uint16_t *>(matrix),
+                    static_cast<const float *>(vector),
+                    static_cast<float *>(dest),
+                    *static_cast<const float *>(alpha),
+                    *static_cast<const float *>(beta),
+                    rows,
+                    columns,
+                    leading_dimension);
+                return;
+            }
+            case BFLOAT16: {
+                if (table.gemv_bf16 == nullptr) {
+                    StandardMath::gemv(matrix, vector, dest, alpha, beta, rows, columns, leading_dimension, false, dtype);
+                    return;
+                }
+
+                table.gemv_bf16(
+                    static_cast<const uint16_t *>(matrix),
+                    static_cast<const float *>(vector),
+                    static_cast<float *>(dest),
+                    *static_cast<const float *>(alpha),
+                    *static_cast<const float *>(beta),
+                    rows,
+                    columns,
+                    leading_dimension);
+                return;
+            }
+            case INVALID: {
+                throw std::runtime_error("cannot calculate gemmv on invalid type");
+            }
+        }
+    }
+
+    void AcceleratedMath::quantized_gemv(
+        const int8_t *matrix,
+        const float *scales,
+        const int32_t *zero_points,
+        const float *vector,
+        float *dest,
+        float const alpha,
+        float const beta,
+        size_t const rows,
+        size_t const columns) {
+
+        const SimdLevel level{get_simd_level()};
+
+        if (level == SCALAR) {
+            StandardMath::quantized_gemv(matrix, scales, zero_points, vector, dest, alpha, beta, rows, columns);
+            return;
+        }
+
+        std::vector<int8_t> quantized(columns);
+        int32_t vector_sum;
+        float const vector_scale = quantize_vector(vector, quantized.data(), columns, vector_sum);
+
+        kernel_tables()[level].quantized_gemv(
+            matrix,
+            scales,
+            zero_points,
+            quantized.data(),
+            vector_sum,
+            vector_scale,
+            dest,
+            alpha,
+            beta,
+            rows,
+            columns);
+    }
+}
@@ -0,0 +1,43 @@
+//
+// Created by sriram on 2/2/25.
+//
+
+#ifndef ACCELERATED_MATH_H
+#define ACCELERATED_MATH_H
+
+#include "../standard_kernel/standard_math.h"
+
+namespace cobraml::core {
+
+    /**
+     * CPU_X kernels. Hot paths are hand vectorized for SSE4.1, AVX2 + FMA and AVX-512, the widest
+     * level the host supports is picked from CPUID at startup so the build does not depend on -march.
+     * Operations without a hand written kernel fall through to StandardMath.
+     */
+    class AcceleratedMath final : public StandardMath {
+        void gemv(
+            const void *matrix,
+            const void *vector,
+            void *dest,
+            const void *alpha,
+            const void *beta,
+            size_t rows,
+            size_t columns,
+            size_t leading_dimension,
+            bool transpose,
+            Dtype dtype) override;
+
+        void quantized_gemv(
+            const int8_t *matrix,
+            const float *scales,
+            const int32_t *zero_points,
+            const float *vector,
+            float *dest,
+            float alpha,
+            float beta,
+            size_t rows,
+            size_t columns) override;
+    };
+}
+
+#endif //ACCELERATED_MATH_H
@@ -0,0 +1,220 @@
+//
+// Created by sriram on 2/2/25.
+//
+// Compiled with -mavx2 -mfma -mf16c, only reached when the host reports all three at runtime.
+//
+
+#include "accelerated_kernels.h"
+
+#if defined(__AVX2__) && defined(__FMA__) && defined(__F16C__)
+
+#include <immintrin.h>
+
+namespace cobraml::core {
+    namespace {
+        struct F64 {
+            using type = double;
+            static constexpr size_t lanes = 4;
+            static __m256d zero() { return _mm256_setzero_pd(); }
+            static __m256d load(const double *p) { return _mm256_loadu_pd(p); }
+            static __m256d fma(__m256d const acc, __m256d const a, __m256d const b) { return _mm256_fmadd_pd(a, b, acc); }
+
+            static double sum(__m256d const acc) {
+                double lanes_out[lanes];
+                _mm256_storeu_pd(lanes_out, acc);
+                return spill_sum<double, double, double>(lanes_out);
+            }
+        };
+
+        struct F32 {
+            using type = float;
+            static constexpr size_t lanes = 8;
+            static __m256 zero() { return _mm256_setzero_ps(); }
+            static __m256 load(const float *p) { return _mm256_loadu_ps(p); }
+            static __m256 fma(__m256 const acc, __m256 const a, __m256 const b) { return _mm256_fmadd_ps(a, b, acc); }
+
+            static float sum(__m256 const acc) {
+                float lanes_out[lanes];
+                _mm256_storeu_ps(lanes_out, acc);
+                return spill_sum<float, float, float>(lanes_out);
+            }
+        };
+
+        /**
+         * int8 has no multiply instruction, both operands are sign extended to int16 and the
+         * products accumulate in int16 lanes, which wraps identically once narrowed back to int8
+         */
+        struct I8 {
+            using type = int8_t;
+            static constexpr size_t lanes = 32;
+
+            struct Acc {
+                __m256i lo;
+                __m256i hi;
+            };
+
+            static Acc zero() { return {_mm256_setzero_si256(), _mm256_setzero_si256()}; }
+
+            static __m256i load(const int8_t *p) {
+                return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            }
+
+            static Acc fma(Acc const acc, __m256i const a, __m256i const b) {
+                __m256i const a_lo = _mm256_cvtepi8_epi16(_mm256_castsi256_si128(a));
+                __m256i const a_hi = _mm256_cvtepi8_epi16(_mm256_extracti128_si256(a, 1));
+                __m256i const b_lo = _mm256_cvtepi8_epi16(_mm256_castsi256_si128(b));
+                __m256i const b_hi = _mm256_cvtepi8_epi16(_mm256_extracti128_si256(b, 1));
+                return {
+                    _mm256_add_epi16(acc.lo, _mm256_mullo_epi16(a_lo, b_lo)),
+                    _mm256_add_epi16(acc.hi, _mm256_mullo_epi16(a_hi, b_hi))
+                };
+            }
+
+            static int8_t sum(Acc const acc) {
+                int16_t lanes_out[32];
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes_out), acc.lo);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes_out + 16), acc.hi);
+                return spill_sum<int, int16_t, int8_t>(lanes_out);
+            }
+        };
+
+        struct I16 {
+            using type = int16_t;
+            static constexpr size_t lanes = 16;
+            static __m256i zero() { return _mm256_setzero_si256(); }
+
+            static __m256i load(const int16_t *p) {
+                return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            }
+
+            static __m256i fma(__m256i const acc, __m256i const a, __m256i const b) {
+                return _mm256_add_epi16(acc, _mm256_mullo_epi16(a, b));
+            }
+
+            static int16_t sum(__m256i const acc) {
+                int16_t lanes_out[lanes];
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes_out), acc);
+                return spill_sum<int, int16_t, int16_t>(lanes_out);
+            }
+        };
+
+        struct I32 {
+            using type = int32_t;
+            static constexpr size_t lanes = 8;
+            static __m256i zero() { return _mm256_setzero_si256(); }
+
+            static __m256i load(const int32_t *p) {
+                return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            }
+
+            static __m256i fma(__m256i const acc, __m256i const a, __m256i const b) {
+                return _mm256_add_epi32(acc, _mm256_mullo_epi32(a, b));
+            }
+
+            static int32_t sum(__m256i const acc) {
+                int32_t lanes_out[lanes];
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes_out), acc);
+                return spill_sum<uint32_t, int32_t, int32_t>(lanes_out);
+            }
+        };
+
+        /**
+         * AVX2 has no 64 bit low multiply, it is rebuilt from 32 bit partial products
+         * lo(a)lo(b) + ((hi(a)lo(b) + lo(a)hi(b)) << 32) which is exact modulo 2^64
+         */
+        struct I64 {
+            using type = int64_t;
+            static constexpr size_t lanes = 4;
+            static __m256i zero() { return _mm256_setzero_si256(); }
+
+            static __m256i load(const int64_t *p) {
+                return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            }
+
+            static __m256i fma(__m256i const acc, __m256i const a, __m256i const b) {
+                __m256i const low = _mm256_mul_epu32(a, b);
+                __m256i const cross = _mm256_add_epi64(
+                    _mm256_mul_epu32(_mm256_srli_epi64(a, 32), b),
+                    _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)));
+                return _mm256_add_epi64(acc, _mm256_add_epi64(low, _mm256_slli_epi64(cross, 32)));
+            }
+
+            static int64_t sum(__m256i const acc) {
+                int64_t lanes_out[lanes];
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes_out), acc);
+                return spill_sum<uint64_t, int64_t, int64_t>(lanes_out);
+            }
+        };
+
+        /**
+         * int8 dot products for quantized gemv, pairs of sign extended products are summed straight
+         * into int32 lanes by vpmaddwd so nothing wraps
+         */
+        struct Q8 {
+            using type = int8_t;
+            static constexpr size_t lanes = 32;
+            static __m256i zero() { return _mm256_setzero_si256(); }
+
+            static __m256i load(const int8_t *p) {
+                return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            }
+
+            static __m256i fma(__m256i const acc, __m256i const a, __m256i const b) {
+                __m256i const lo = _mm256_madd_epi16(
+                    _mm256_cvtepi8_epi16(_mm256_castsi256_si128(a)),
+                    _mm256_cvtepi8_epi16(_mm256_castsi256_si128(b)));
+                __m256i const hi = _mm256_madd_epi16(
+                    _mm256_cvtepi8_epi16(_mm256_extracti128_si256(a, 1)),
+                    _mm256_cvtepi8_epi16(_mm256_extracti128_si256(b, 1)));
+                return _mm256_add_epi32(acc, _mm256_add_epi32(lo, hi));
+            }
+
+            static int32_t sum(__m256i const acc) {
+                int32_t lanes_out[8];
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes_out), acc);
+                return spill_sum<int64_t, int32_t, int32_t>(lanes_out);
+            }
+        };
+
+        struct F16 : F32 {
+            static __m256 widen(const uint16_t *p) {
+                return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)));
+            }
+
+            static float widen_scalar(uint16_t const bits) { return _cvtsh_ss(bits); }
+        };
+
+        struct BF16 : F32 {
+            static __m256 widen(const uint16_t *p) {
+                __m256i const bits = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)));
+                return _mm256_castsi256_ps(_mm256_slli_epi32(bits, 16));
+            }
+
+            static float widen_scalar(uint16_t const bits) { return bfloat_to_float(bits); }
+        };
+    }
+
+    KernelTable avx2_kernels() {
+        KernelTable table{};
+        table.gemv_f64 = simd_gemv<F64>;
+        table.gemv_f32 = simd_gemv<F32>;
+        table.gemv_i8 = simd_gemv<I8>;
+        table.gemv_i16 = simd_gemv<I16>;
+        table.gemv_i32 = simd_gemv<I32>;
+        table.gemv_i64 = simd_gemv<I64>;
+        table.quantized_gemv = simd_quantized_gemv<Q8>;
+        table.gemv_f16 = simd_half_gemv<F16>;
+        table.gemv_bf16 = simd_half_gemv<BF16>;
+        return table;
+    }
+}
+
+#else
+
+namespace cobraml::core {
+    KernelTable avx2_kernels() {
+        return KernelTable{};
+    }
+}
+
+#endif
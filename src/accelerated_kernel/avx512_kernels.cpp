@@ -0,0 +1,198 @@
+//
+// Created by sriram on 2/2/25.
+//
+// Compiled with -mavx512f -mavx512bw -mavx512dq -mavx512vl -mfma -mf16c, only reached when the host
+// reports all of them at runtime.
+//
+
+#include "accelerated_kernels.h"
+
+#if defined(__AVX512F__) && defined(__AVX512BW__) && defined(__AVX512DQ__) && defined(__F16C__)
+
+#include <immintrin.h>
+
+namespace cobraml::core {
+    namespace {
+        struct F64 {
+            using type = double;
+            static constexpr size_t lanes = 8;
+            static __m512d zero() { return _mm512_setzero_pd(); }
+            static __m512d load(const double *p) { return _mm512_loadu_pd(p); }
+            static __m512d fma(__m512d const acc, __m512d const a, __m512d const b) { return _mm512_fmadd_pd(a, b, acc); }
+
+            static double sum(__m512d const acc) {
+                double lanes_out[lanes];
+                _mm512_storeu_pd(lanes_out, acc);
+                return spill_sum<double, double, double>(lanes_out);
+            }
+        };
+
+        struct F32 {
+            using type = float;
+            static constexpr size_t lanes = 16;
+            static __m512 zero() { return _mm512_setzero_ps(); }
+            static __m512 load(const float *p) { return _mm512_loadu_ps(p); }
+            static __m512 fma(__m512 const acc, __m512 const a, __m512 const b) { return _mm512_fmadd_ps(a, b, acc); }
+
+            static float sum(__m512 const acc) {
+                float lanes_out[lanes];
+                _mm512_storeu_ps(lanes_out, acc);
+                return spill_sum<float, float, float>(lanes_out);
+            }
+        };
+
+        /**
+         * int8 operands are sign extended to int16 and the products accumulate in int16 lanes,
+         * which wraps identically once narrowed back to int8
+         */
+        struct I8 {
+            using type = int8_t;
+            static constexpr size_t lanes = 64;
+
+            struct Acc {
+                __m512i lo;
+                __m512i hi;
+            };
+
+            static Acc zero() { return {_mm512_setzero_si512(), _mm512_setzero_si512()}; }
+            static __m512i load(const int8_t *p) { return _mm512_loadu_si512(p); }
+
+            static Acc fma(Acc const acc, __m512i const a, __m512i const b) {
+                __m512i const a_lo = _mm512_cvtepi8_epi16(_mm512_castsi512_si256(a));
+                __m512i const a_hi = _mm512_cvtepi8_epi16(_mm512_extracti64x4_epi64(a, 1));
+                __m512i const b_lo = _mm512_cvtepi8_epi16(_mm512_castsi512_si256(b));
+                __m512i const b_hi = _mm512_cvtepi8_epi16(_mm512_extracti64x4_epi64(b, 1));
+                return {
+                    _mm512_add_epi16(acc.lo, _mm512_mullo_epi16(a_lo, b_lo)),
+                    _mm512_add_epi16(acc.hi, _mm512_mullo_epi16(a_hi, b_hi))
+                };
+            }
+
+            static int8_t sum(Acc const acc) {
+                int16_t lanes_out[64];
+                _mm512_storeu_si512(lanes_out, acc.lo);
+                _mm512_storeu_si512(lanes_out + 32, acc.hi);
+                return spill_sum<int, int16_t, int8_t>(lanes_out);
+            }
+        };
+
+        struct I16 {
+            using type = int16_t;
+            static constexpr size_t lanes = 32;
+            static __m512i zero() { return _mm512_setzero_si512(); }
+            static __m512i load(const int16_t *p) { return _mm512_loadu_si512(p); }
+
+            static __m512i fma(__m512i const acc, __m512i const a, __m512i const b) {
+                return _mm512_add_epi16(acc, _mm512_mullo_epi16(a, b));
+            }
+
+            static int16_t sum(__m512i const acc) {
+                int16_t lanes_out[lanes];
+                _mm512_storeu_si512(lanes_out, acc);
+                return spill_sum<int, int16_t, int16_t>(lanes_out);
+            }
+        };
+
+        struct I32 {
+            using type = int32_t;
+            static constexpr size_t lanes = 16;
+            static __m512i zero() { return _mm512_setzero_si512(); }
+            static __m512i load(const int32_t *p) { return _mm512_loadu_si512(p); }
+
+            static __m512i fma(__m512i const acc, __m512i const a, __m512i const b) {
+                return _mm512_add_epi32(acc, _mm512_mullo_epi32(a, b));
+            }
+
+            static int32_t sum(__m512i const acc) {
+                int32_t lanes_out[lanes];
+                _mm512_storeu_si512(lanes_out, acc);
+                return spill_sum<uint32_t, int32_t, int32_t>(lanes_out);
+            }
+        };
+
+        struct I64 {
+            using type = int64_t;
+            static constexpr size_t lanes = 8;
+            static __m512i zero() { return _mm512_setzero_si512(); }
+            static __m512i load(const int64_t *p) { return _mm512_loadu_si512(p); }
+
+            static __m512i fma(__m512i const acc, __m512i const a, __m512i const b) {
+                return _mm512_add_epi64(acc, _mm512_mullo_epi64(a, b));
+            }
+
+            static int64_t sum(__m512i const acc) {
+                int64_t lanes_out[lanes];
+                _mm512_storeu_si512(lanes_out, acc);
+                return spill_sum<uint64_t, int64_t, int64_t>(lanes_out);
+            }
+        };
+
+        /**
+         * int8 dot products for quantized gemv, pairs of sign extended products are summed straight
+         * into int32 lanes by vpmaddwd so nothing wraps
+         */
+        struct Q8 {
+            using type = int8_t;
+            static constexpr size_t lanes = 64;
+            static __m512i zero() { return _mm512_setzero_si512(); }
+            static __m512i load(const int8_t *p) { return _mm512_loadu_si512(p); }
+
+            static __m512i fma(__m512i const acc, __m512i const a, __m512i const b) {
+                __m512i const lo = _mm512_madd_epi16(
+                    _mm512_cvtepi8_epi16(_mm512_castsi512_si256(a)),
+                    _mm512_cvtepi8_epi16(_mm512_castsi512_si256(b)));
+                __m512i const hi = _mm512_madd_epi16(
+                    _mm512_cvtepi8_epi16(_mm512_extracti64x4_epi64(a, 1)),
+                    _mm512_cvtepi8_epi16(_mm512_extracti64x4_epi64(b, 1)));
+                return _mm512_add_epi32(acc, _mm512_add_epi32(lo, hi));
+            }
+
+            static int32_t sum(__m512i const acc) {
+                int32_t lanes_out[16];
+                _mm512_storeu_si512(lanes_out, acc);
+                return spill_sum<int64_t, int32_t, int32_t>(lanes_out);
+            }
+        };
+
+        struct F16 : F32 {
+            static __m512 widen(const uint16_t *p) {
+                return _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)));
+            }
+
+            static float widen_scalar(uint16_t const bits) { return _cvtsh_ss(bits); }
+        };
+
+        struct BF16 : F32 {
+            static __m512 widen(const uint16_t *p) {
+                __m512i const bits = _mm512_cvtepu16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)));
+                return _mm512_castsi512_ps(_mm512_slli_epi32(bits, 16));
+            }
+
+            static float widen_scalar(uint16_t const bits) { return bfloat_to_float(bits); }
+        };
+    }
+
+    KernelTable avx512_kernels() {
+        KernelTable table{};
+        table.gemv_f64 = simd_gemv<F64>;
+        table.gemv_f32 = simd_gemv<F32>;
+        table.gemv_i8 = simd_gemv<I8>;
+        table.gemv_i16 = simd_gemv<I16>;
+        table.gemv_i32 = simd_gemv<I32>;
+        table.gemv_i64 = simd_gemv<I64>;
+        table.quantized_gemv = simd_quantized_gemv<Q8>;
+        table.gemv_f16 = simd_half_gemv<F16>;
+        table.gemv_bf16 = simd_half_gemv<BF16>;
+        return table;
+    }
+}
+
+#else
+
+namespace cobraml::core {
+    KernelTable avx512_kernels() {
+        return KernelTable{};
+    }
+}
+
+#endif
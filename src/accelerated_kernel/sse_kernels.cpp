@@ -0,0 +1,191 @@
+//
+// Created by sriram on 2/2/25.
+//
+// Compiled with -msse4.1, the fallback for hosts without AVX2. SSE has no fused multiply add so
+// products and sums are issued separately.
+//
+
+#include "accelerated_kernels.h"
+
+#if defined(__SSE4_1__)
+
+#include <immintrin.h>
+
+namespace cobraml::core {
+    namespace {
+        struct F64 {
+            using type = double;
+            static constexpr size_t lanes = 2;
+            static __m128d zero() { return _mm_setzero_pd(); }
+            static __m128d load(const double *p) { return _mm_loadu_pd(p); }
+            static __m128d fma(__m128d const acc, __m128d const a, __m128d const b) { return _mm_add_pd(acc, _mm_mul_pd(a, b)); }
+
+            static double sum(__m128d const acc) {
+                double lanes_out[lanes];
+                _mm_storeu_pd(lanes_out, acc);
+                return spill_sum<double, double, double>(lanes_out);
+            }
+        };
+
+        struct F32 {
+            using type = float;
+            static constexpr size_t lanes = 4;
+            static __m128 zero() { return _mm_setzero_ps(); }
+            static __m128 load(const float *p) { return _mm_loadu_ps(p); }
+            static __m128 fma(__m128 const acc, __m128 const a, __m128 const b) { return _mm_add_ps(acc, _mm_mul_ps(a, b)); }
+
+            static float sum(__m128 const acc) {
+                float lanes_out[lanes];
+                _mm_storeu_ps(lanes_out, acc);
+                return spill_sum<float, float, float>(lanes_out);
+            }
+        };
+
+        struct I8 {
+            using type = int8_t;
+            static constexpr size_t lanes = 16;
+
+            struct Acc {
+                __m128i lo;
+                __m128i hi;
+            };
+
+            static Acc zero() { return {_mm_setzero_si128(), _mm_setzero_si128()}; }
+            static __m128i load(const int8_t *p) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+
+            static Acc fma(Acc const acc, __m128i const a, __m128i const b) {
+                __m128i const a_lo = _mm_cvtepi8_epi16(a);
+                __m128i const a_hi = _mm_cvtepi8_epi16(_mm_srli_si128(a, 8));
+                __m128i const b_lo = _mm_cvtepi8_epi16(b);
+                __m128i const b_hi = _mm_cvtepi8_epi16(_mm_srli_si128(b, 8));
+                return {
+                    _mm_add_epi16(acc.lo, _mm_mullo_epi16(a_lo, b_lo)),
+                    _mm_add_epi16(acc.hi, _mm_mullo_epi16(a_hi, b_hi))
+                };
+            }
+
+            static int8_t sum(Acc const acc) {
+                int16_t lanes_out[16];
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes_out), acc.lo);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes_out + 8), acc.hi);
+                return spill_sum<int, int16_t, int8_t>(lanes_out);
+            }
+        };
+
+        struct I16 {
+            using type = int16_t;
+            static constexpr size_t lanes = 8;
+            static __m128i zero() { return _mm_setzero_si128(); }
+            static __m128i load(const int16_t *p) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+
+            static __m128i fma(__m128i const acc, __m128i const a, __m128i const b) {
+                return _mm_add_epi16(acc, _mm_mullo_epi16(a, b));
+            }
+
+            static int16_t sum(__m128i const acc) {
+                int16_t lanes_out[lanes];
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes_out), acc);
+                return spill_sum<int, int16_t, int16_t>(lanes_out);
+            }
+        };
+
+        struct I32 {
+            using type = int32_t;
+            static constexpr size_t lanes = 4;
+            static __m128i zero() { return _mm_setzero_si128(); }
+            static __m128i load(const int32_t *p) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+
+            static __m128i fma(__m128i const acc, __m128i const a, __m128i const b) {
+                return _mm_add_epi32(acc, _mm_mullo_epi32(a, b));
+            }
+
+            static int32_t sum(__m128i const acc) {
+                int32_t lanes_out[lanes];
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes_out), acc);
+                return spill_sum<uint32_t, int32_t, int32_t>(lanes_out);
+            }
+        };
+
+        struct I64 {
+            using type = int64_t;
+            static constexpr size_t lanes = 2;
+            static __m128i zero() { return _mm_setzero_si128(); }
+            static __m128i load(const int64_t *p) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+
+            static __m128i fma(__m128i const acc, __m128i const a, __m128i const b) {
+                __m128i const low = _mm_mul_epu32(a, b);
+                __m128i const cross = _mm_add_epi64(
+                    _mm_mul_epu32(_mm_srli_epi64(a, 32), b),
+                    _mm_mul_epu32(a, _mm_srli_epi64(b, 32)));
+                return _mm_add_epi64(acc, _mm_add_epi64(low, _mm_slli_epi64(cross, 32)));
+            }
+
+            static int64_t sum(__m128i const acc) {
+                int64_t lanes_out[lanes];
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes_out), acc);
+                return spill_sum<uint64_t, int64_t, int64_t>(lanes_out);
+            }
+        };
+
+        /**
+         * int8 dot products for quantized gemv, pairs of sign extended products are summed straight
+         * into int32 lanes by pmaddwd so nothing wraps
+         */
+        struct Q8 {
+            using type = int8_t;
+            static constexpr size_t lanes = 16;
+            static __m128i zero() { return _mm_setzero_si128(); }
+            static __m128i load(const int8_t *p) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+
+            static __m128i fma(__m128i const acc, __m128i const a, __m128i const b) {
+                __m128i const lo = _mm_madd_epi16(_mm_cvtepi8_epi16(a), _mm_cvtepi8_epi16(b));
+                __m128i const hi = _mm_madd_epi16(
+                    _mm_cvtepi8_epi16(_mm_srli_si128(a, 8)),
+                    _mm_cvtepi8_epi16(_mm_srli_si128(b, 8)));
+                return _mm_add_epi32(acc, _mm_add_epi32(lo, hi));
+            }
+
+            static int32_t sum(__m128i const acc) {
+                int32_t lanes_out[4];
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes_out), acc);
+                return spill_sum<int64_t, int32_t, int32_t>(lanes_out);
+            }
+        };
+
+        /**
+         * bfloat16 rows widened to FLOAT32 by zero extending to 32 bits and shifting into the upper half,
+         * FLOAT16 needs F16C and is left to the AVX2 level
+         */
+        struct BF16 : F32 {
+            static __m128 widen(const uint16_t *p) {
+                __m128i const bits = _mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(p)));
+                return _mm_castsi128_ps(_mm_slli_epi32(bits, 16));
+            }
+
+            static float widen_scalar(uint16_t const bits) { return bfloat_to_float(bits); }
+        };
+    }
+
+    KernelTable sse_kernels() {
+        KernelTable table{};
+        table.gemv_f64 = simd_gemv<F64>;
+        table.gemv_f32 = simd_gemv<F32>;
+        table.gemv_i8 = simd_gemv<I8>;
+        table.gemv_i16 = simd_gemv<I16>;
+        table.gemv_i32 = simd_gemv<I32>;
+        table.gemv_i64 = simd_gemv<I64>;
+        table.quantized_gemv = simd_quantized_gemv<Q8>;
+        table.gemv_bf16 = simd_half_gemv<BF16>;
+        return table;
+    }
+}
+
+#else
+
+namespace cobraml::core {
+    KernelTable sse_kernels() {
+        return KernelTable{};
+    }
+}
+
+#endif
@@ -0,0 +1,38 @@
+//
+// Created by sriram on 2/26/25.
+//
+
+#include "adopted_allocator.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace cobraml::core {
+
+    AdoptedAllocator::AdoptedAllocator(std::function<void()> release): release(std::move(release)) {
+    }
+
+    AdoptedAllocator::~AdoptedAllocator() {
+        free(nullptr);
+    }
+
+    void *AdoptedAllocator::malloc(std::size_t) {
+        throw std::runtime_error("an adopted allocator cannot allocate new memory");
+    }
+
+    void *AdoptedAllocator::calloc(std::size_t) {
+        throw std::runtime_error("an adopted allocator cannot allocate new memory");
+    }
+
+    void AdoptedAllocator::mem_copy(void *dest, const void *source, std::size_t const bytes) {
+        std::memcpy(dest, source, bytes);
+    }
+
+    void AdoptedAllocator::free(void *) {
+        if (!release)
+            return;
+
+        std::function<void()> const callback{std::move(release)};
+        release = nullptr;
+        callback();
+    }
+}
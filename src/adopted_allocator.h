@@ -0,0 +1,38 @@
+//
+// Created by sriram on 2/26/25.
+//
+
+#ifndef ADOPTED_ALLOCATOR_H
+#define ADOPTED_ALLOCATOR_H
+
+#include <functional>
+#include "allocator.h"
+
+namespace cobraml::core {
+
+    /**
+     * Owns a single block of memory allocated outside the library, such as the storage of a std::vector handed
+     * to from_vector. Buffers wrapping the block release it through the callback instead of freeing it.
+     * It cannot allocate, a new block needs a new allocator.
+     */
+    class AdoptedAllocator final : public Allocator {
+        std::function<void()> release;
+
+    public:
+        explicit AdoptedAllocator(std::function<void()> release);
+        ~AdoptedAllocator() override;
+        AdoptedAllocator(const AdoptedAllocator &) = delete;
+        AdoptedAllocator &operator=(const AdoptedAllocator &) = delete;
+
+        void *malloc(std::size_t bytes) override;
+        void *calloc(std::size_t bytes) override;
+        void mem_copy(void *dest, const void *source, std::size_t bytes) override;
+
+        /**
+         * runs the release callback, only the first call has an effect
+         */
+        void free(void *ptr) override;
+    };
+}
+
+#endif //ADOPTED_ALLOCATOR_H
@@ -4,7 +4,9 @@
 
 #include "allocator.h"
 #include "standard_kernel/standard_allocator.h"
+#include "standard_kernel/pool_allocator.h"
 #include <array>  // Add this line
+#include <atomic>
 
 namespace cobraml::core {
 
@@ -14,13 +16,62 @@ namespace cobraml::core {
         std::make_unique<StandardAllocator>(),
     };
 
+    std::array<std::unique_ptr<Allocator>, 3> pooled_allocators{
+        std::make_unique<PoolAllocator>(),
+        std::make_unique<PoolAllocator>(),
+        std::make_unique<PoolAllocator>(),
+    };
+
+    static std::array<std::atomic<AllocatorKind>, 3> allocator_kinds{STANDARD, STANDARD, STANDARD};
+
     Allocator * get_allocator(Device const device) {
+        if (allocator_kinds[device].load() == POOLED)
+            return pooled_allocators[device].get();
+
         return global_allocators[device].get();
     }
 
-    Buffer::Buffer(size_t const bytes, Device const device)
-        :  p_allocator(get_allocator(device)), device(device) {
-        p_buffer = p_allocator->calloc(bytes);
+    void set_allocator_kind(Device const device, AllocatorKind const kind) {
+        allocator_kinds[device].store(kind);
+    }
+
+    AllocatorKind get_allocator_kind(Device const device) {
+        return allocator_kinds[device].load();
+    }
+
+    AllocatorStats get_allocator_stats(Device const device) {
+        return pooled_allocators[device]->stats();
+    }
+
+    void release_retained_memory(Device const device) {
+        pooled_allocators[device]->release_retained();
+    }
+
+    void set_huge_page_mode(HugePageMode const mode, size_t const threshold) {
+        configure_huge_pages(mode, threshold);
+    }
+
+    HugePageMode get_huge_page_mode() {
+        return huge_page_mode();
+    }
+
+    size_t get_huge_page_threshold() {
+        return huge_page_threshold();
+    }
+
+    HugePageStats get_huge_page_stats() {
+        return huge_page_stats();
+    }
+
+    Buffer::Buffer(size_t const bytes, Device const device, AllocationPolicy const policy)
+        :  p_allocator(get_allocator(device)), device(device), cache_lock(), norm_cache{0, 0, 0, nullptr},
+           owned_allocator(nullptr) {
+        p_buffer = policy == ZEROED ? p_allocator->calloc(bytes) : p_allocator->malloc(bytes);
+    }
+
+    Buffer::Buffer(void *buffer, Device const device, std::unique_ptr<Allocator> allocator)
+        : p_buffer(buffer), p_allocator(allocator.get()), device(device), cache_lock(), norm_cache{0, 0, 0, nullptr},
+          owned_allocator(std::move(allocator)) {
     }
 
     Buffer::~Buffer() {
@@ -34,6 +85,35 @@ namespace cobraml::core {
     void Buffer::overwrite(const void *source, const size_t byte_count, const size_t offset) const {
         char * const dest = static_cast<char *>(this->p_buffer) + offset;
         p_allocator->mem_copy(dest, source, byte_count);
+        invalidate_norms();
+    }
+
+    std::shared_ptr<Buffer> Buffer::get_norms(size_t const offset, size_t const rows, size_t const columns) const {
+        std::lock_guard lock(cache_lock);
+
+        if (norm_cache.offset != offset || norm_cache.rows != rows || norm_cache.columns != columns)
+            return nullptr;
+
+        return norm_cache.norms;
+    }
+
+    void Buffer::set_norms(
+        size_t const offset, size_t const rows, size_t const columns, std::shared_ptr<Buffer> norms) const {
+        std::lock_guard lock(cache_lock);
+
+        if (norms_cacheable)
+            norm_cache = NormCache{offset, rows, columns, std::move(norms)};
+    }
+
+    void Buffer::invalidate_norms() const {
+        std::lock_guard lock(cache_lock);
+        norm_cache.norms = nullptr;
+    }
+
+    void Buffer::disable_norm_cache() const {
+        std::lock_guard lock(cache_lock);
+        norms_cacheable = false;
+        norm_cache.norms = nullptr;
     }
 
 }
@@ -6,6 +6,8 @@
 #define ALLOCATOR_H
 #include <cstddef>
 #include <memory>
+#include <mutex>
+#include "allocation.h"
 #include "enums.h"
 
 namespace cobraml::core {
@@ -17,9 +19,20 @@ namespace cobraml::core {
         virtual void *calloc(std::size_t bytes) = 0;
         virtual void mem_copy(void *dest, const void *source, std::size_t bytes) = 0;
         virtual void free(void *ptr) = 0;
+
+        /**
+         * @return reuse counters, allocators that do not cache memory report zeros
+         */
+        [[nodiscard]] virtual AllocatorStats stats() const { return {0, 0, 0}; }
+
+        /**
+         * hands cached memory back to the system, a no-op for allocators that do not cache memory
+         */
+        virtual void release_retained() {}
     };
 
     extern std::array<std::unique_ptr<Allocator>, 3> global_allocators;
+    extern std::array<std::unique_ptr<Allocator>, 3> pooled_allocators;
 
     Allocator * get_allocator(Device device);
 
@@ -28,9 +41,44 @@ namespace cobraml::core {
         Allocator * p_allocator;
         Device device;
 
+        /**
+         * L2 norms of the rows of a (rows, columns) matrix starting at byte offset, computed on demand by
+         * normalized kernels and dropped whenever the buffer is written
+         */
+        struct NormCache {
+            size_t offset;
+            size_t rows;
+            size_t columns;
+            std::shared_ptr<Buffer> norms;
+        };
+
+        mutable std::mutex cache_lock;
+        mutable NormCache norm_cache;
+        // cleared for memory that is written outside the library, where a cache could never be invalidated
+        mutable bool norms_cacheable = true;
+
+        /**
+         * set when the buffer wraps memory it did not allocate, the allocator is then specific to that
+         * memory and lives as long as the buffer
+         */
+        std::unique_ptr<Allocator> owned_allocator;
+
     public:
         Buffer() = delete;
-        explicit Buffer(size_t bytes, Device device);
+        /**
+         * allocates bytes on device, ZEROED buffers are zeroed while UNINITIALIZED and FIRST_TOUCH buffers are
+         * left for the caller to initialize
+         */
+        explicit Buffer(size_t bytes, Device device, AllocationPolicy policy = ZEROED);
+
+        /**
+         * wraps existing memory, it is released through allocator->free when the buffer is destroyed
+         *
+         * @param buffer the memory to wrap
+         * @param device the device the memory belongs to
+         * @param allocator releases the memory and performs copies into it
+         */
+        Buffer(void *buffer, Device device, std::unique_ptr<Allocator> allocator);
         ~Buffer();
         [[nodiscard]] void * get_p_buffer() const;
         Buffer(Buffer&) = delete;
@@ -43,6 +91,29 @@ namespace cobraml::core {
          * @param offset the starting position to start overwriting in the original buffer
          */
         void overwrite(const void * source, size_t byte_count, size_t offset = 0) const;
+
+        /**
+         * @param offset byte offset of the first row
+         * @param rows the number of rows
+         * @param columns the number of columns
+         * @return the cached row norms for that matrix, nullptr if none are cached
+         */
+        [[nodiscard]] std::shared_ptr<Buffer> get_norms(size_t offset, size_t rows, size_t columns) const;
+
+        /**
+         * caches row norms for the (rows, columns) matrix starting at offset, replacing any previous entry
+         */
+        void set_norms(size_t offset, size_t rows, size_t columns, std::shared_ptr<Buffer> norms) const;
+
+        /**
+         * drops cached row norms, must be called whenever the buffer contents change
+         */
+        void invalidate_norms() const;
+
+        /**
+         * stops caching row norms for good, for memory that may be written without going through the library
+         */
+        void disable_norm_cache() const;
     };
 }
 
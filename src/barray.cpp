@@ -3,8 +3,12 @@
 //
 
 #include "barray.h"
+#include <cstdint>
+#include <utility>
 #include "math_dis.h"
 #include "allocator.h"
+#include "adopted_allocator.h"
+#include "standard_kernel/standard_allocator.h"
 
 
 namespace cobraml::core {
@@ -16,10 +20,19 @@ namespace cobraml::core {
         std::shared_ptr<Buffer> buffer = nullptr;
         Math *m_dispatcher = nullptr;
 
-        ArrayImpl(Device const device, Dtype const dtype, size_t const total_items): len(total_items),
+        ArrayImpl(Device const device, Dtype const dtype, size_t const total_items, AllocationPolicy const policy):
+            len(total_items),
             device(device),
             dtype(dtype),
-            buffer(std::make_shared<Buffer>(total_items * dtype_to_bytes(dtype), device)),
+            buffer(std::make_shared<Buffer>(total_items * dtype_to_bytes(dtype), device, policy)),
+            m_dispatcher(get_math_kernels(device)) {
+        }
+
+        ArrayImpl(std::shared_ptr<Buffer> buffer, Device const device, Dtype const dtype, size_t const total_items):
+            len(total_items),
+            device(device),
+            dtype(dtype),
+            buffer(std::move(buffer)),
             m_dispatcher(get_math_kernels(device)) {
         }
 
@@ -34,9 +47,60 @@ namespace cobraml::core {
         ArrayImpl &operator=(const ArrayImpl &) = default;
     };
 
-    Array::Array(size_t total_items, Device device, Dtype dtype): impl(
-        std::make_unique<ArrayImpl>(device, dtype, total_items)) {
+    Array::Array(size_t total_items, Device device, Dtype dtype, AllocationPolicy const policy): impl(
+        std::make_unique<ArrayImpl>(device, dtype, total_items, policy)) {
         is_invalid(dtype);
+
+        if (policy == FIRST_TOUCH)
+            first_touch(total_items, dtype_to_bytes(dtype));
+    }
+
+    size_t huge_page_bytes(const Array &array) {
+        return mapped_huge_page_bytes(array.get_raw_buffer());
+    }
+
+    void Array::first_touch(size_t const rows, size_t const row_bytes) const {
+        impl->m_dispatcher->first_touch(get_raw_buffer(), rows, row_bytes, get_dtype());
+    }
+
+    Array::Array(std::shared_ptr<Buffer> buffer, size_t const total_items, Device const device, Dtype const dtype):
+        impl(std::make_unique<ArrayImpl>(std::move(buffer), device, dtype, total_items)) {
+        is_invalid(dtype);
+    }
+
+    Array::Array(
+        void *data, size_t const total_items, Device const device, Dtype const dtype, std::function<void()> release):
+        Array(std::make_shared<Buffer>(data, device, std::make_unique<AdoptedAllocator>(std::move(release))),
+              total_items, device, dtype) {
+    }
+
+    bool is_aligned(const void *data, Dtype const dtype) {
+        is_invalid(dtype);
+        return reinterpret_cast<uintptr_t>(data) % dtype_to_bytes(dtype) == 0;
+    }
+
+    Array wrap(
+        void *data, size_t const total_items, Device const device, Dtype const dtype, std::function<void()> release) {
+        if (data == nullptr)
+            throw std::runtime_error("cannot wrap a null pointer");
+
+        if (total_items == 0)
+            throw std::runtime_error("cannot wrap an empty buffer");
+
+        if (is_aligned(data, dtype)) {
+            Array ret{data, total_items, device, dtype, std::move(release)};
+            // the owner may keep writing the memory behind the library's back
+            ret.disable_norm_cache();
+            return ret;
+        }
+
+        Array ret(total_items, device, dtype, UNINITIALIZED);
+        ret.replace_segment(data, total_items);
+
+        if (release)
+            release();
+
+        return ret;
     }
 
     Dtype Array::get_dtype() const {
@@ -51,6 +115,15 @@ namespace cobraml::core {
         return static_cast<char *>(impl->buffer->get_p_buffer()) + impl->offset;
     }
 
+    void *Array::get_writable_buffer() const {
+        impl->buffer->invalidate_norms();
+        return get_raw_buffer();
+    }
+
+    void Array::disable_norm_cache() const {
+        impl->buffer->disable_norm_cache();
+    }
+
     Array::~Array() = default;
 
     Array::Array(): impl(std::make_unique<ArrayImpl>()) {
@@ -79,6 +152,17 @@ namespace cobraml::core {
         return *this;
     }
 
+    // the source keeps an empty impl so it stays usable like a default constructed array
+    Array::Array(Array &&other) noexcept : impl(std::exchange(other.impl, std::make_unique<ArrayImpl>())) {
+    }
+
+    Array &Array::operator=(Array &&other) noexcept {
+        if (this != &other)
+            impl = std::exchange(other.impl, std::make_unique<ArrayImpl>());
+
+        return *this;
+    }
+
     void Array::set_length(unsigned long const len) {
         if (len > impl->len) {
             throw std::runtime_error("cannot make length negative");
@@ -105,8 +189,11 @@ namespace cobraml::core {
         const Array &vector,
         size_t const rows,
         size_t const columns,
+        size_t const leading_dimension,
         const void *alpha,
-        const void *beta) {
+        const void *beta,
+        bool const transpose) {
+        this->impl->buffer->invalidate_norms();
         this->impl->m_dispatcher->gemv(
             matrix.get_raw_buffer(),
             vector.get_raw_buffer(),
@@ -115,11 +202,268 @@ namespace cobraml::core {
             beta,
             rows,
             columns,
+            leading_dimension,
+            transpose,
+            matrix.get_dtype());
+    }
+
+    void Array::gemm(
+        const Array &matrix_a,
+        const Array &matrix_b,
+        size_t const rows,
+        size_t const shared,
+        size_t const columns,
+        const void *alpha,
+        const void *beta) {
+        this->impl->buffer->invalidate_norms();
+        this->impl->m_dispatcher->gemm(
+            matrix_a.get_raw_buffer(),
+            matrix_b.get_raw_buffer(),
+            this->get_raw_buffer(),
+            alpha,
+            beta,
+            rows,
+            shared,
+            columns,
+            this->get_dtype());
+    }
+
+    void Array::gemv_batched(
+        const Array &matrix,
+        const Array &queries,
+        size_t const rows,
+        size_t const columns,
+        size_t const query_count,
+        const void *alpha,
+        const void *beta) {
+        this->impl->buffer->invalidate_norms();
+        this->impl->m_dispatcher->gemv_batched(
+            matrix.get_raw_buffer(),
+            queries.get_raw_buffer(),
+            this->get_raw_buffer(),
+            alpha,
+            beta,
+            rows,
+            columns,
+            query_count,
+            this->get_dtype());
+    }
+
+    void Array::gemv_topk(
+        const Array &matrix,
+        const Array &vector,
+        Array &indices,
+        size_t const rows,
+        size_t const columns,
+        size_t const k,
+        const void *alpha) {
+        this->impl->buffer->invalidate_norms();
+        this->impl->m_dispatcher->gemv_topk(
+            matrix.get_raw_buffer(),
+            vector.get_raw_buffer(),
+            static_cast<int64_t *>(indices.get_writable_buffer()),
+            this->get_raw_buffer(),
+            alpha,
+            rows,
+            columns,
+            k,
+            this->get_dtype());
+    }
+
+    void Array::gemv_cosine(
+        const Array &matrix,
+        const Array &vector,
+        size_t const rows,
+        size_t const columns,
+        const void *alpha,
+        const void *beta) {
+        const std::shared_ptr<Buffer> &source{matrix.impl->buffer};
+        std::shared_ptr<Buffer> norms{source->get_norms(matrix.impl->offset, rows, columns)};
+
+        if (!norms) {
+            norms = std::make_shared<Buffer>(rows * dtype_to_bytes(matrix.get_dtype()), matrix.get_device());
+            matrix.impl->m_dispatcher->row_norms(
+                matrix.get_raw_buffer(), norms->get_p_buffer(), rows, columns, matrix.get_dtype());
+            source->set_norms(matrix.impl->offset, rows, columns, norms);
+        }
+
+        this->impl->buffer->invalidate_norms();
+        this->impl->m_dispatcher->gemv_cosine(
+            matrix.get_raw_buffer(),
+            vector.get_raw_buffer(),
+            norms->get_p_buffer(),
+            this->get_raw_buffer(),
+            alpha,
+            beta,
+            rows,
+            columns,
             this->get_dtype());
     }
 
-    void Array::replace_segment(const void *source, size_t items) const {
-        impl->buffer->overwrite(source, items * dtype_to_bytes(get_dtype()), this->impl->offset);
+    void Array::quantize(
+        const Array &source,
+        const Array &scales,
+        const Array &zero_points,
+        size_t const rows,
+        size_t const columns) {
+        this->impl->buffer->invalidate_norms();
+        scales.impl->buffer->invalidate_norms();
+        this->impl->m_dispatcher->quantize_rows(
+            static_cast<const float *>(source.get_raw_buffer()),
+            static_cast<int8_t *>(this->get_raw_buffer()),
+            static_cast<float *>(scales.get_raw_buffer()),
+            static_cast<int32_t *>(zero_points.get_raw_buffer()),
+            rows,
+            columns);
+    }
+
+    void Array::dequantize(
+        const Array &source,
+        const Array &scales,
+        const Array &zero_points,
+        size_t const rows,
+        size_t const columns) {
+        this->impl->buffer->invalidate_norms();
+        this->impl->m_dispatcher->dequantize_rows(
+            static_cast<const int8_t *>(source.get_raw_buffer()),
+            static_cast<const float *>(scales.get_raw_buffer()),
+            static_cast<const int32_t *>(zero_points.get_raw_buffer()),
+            static_cast<float *>(this->get_raw_buffer()),
+            rows,
+            columns);
+    }
+
+    void Array::quantized_gemv(
+        const Array &matrix,
+        const Array &scales,
+        const Array &zero_points,
+        const Array &vector,
+        size_t const rows,
+        size_t const columns,
+        float const alpha,
+        float const beta) {
+        this->impl->buffer->invalidate_norms();
+        this->impl->m_dispatcher->quantized_gemv(
+            static_cast<const int8_t *>(matrix.get_raw_buffer()),
+            static_cast<const float *>(scales.get_raw_buffer()),
+            static_cast<const int32_t *>(zero_points.get_raw_buffer()),
+            static_cast<const float *>(vector.get_raw_buffer()),
+            static_cast<float *>(this->get_raw_buffer()),
+            alpha,
+            beta,
+            rows,
+            columns);
+    }
+
+    void Array::sparse_gemv(
+        const Array &row_pointers,
+        const Array &column_indices,
+        const Array &values,
+        const Array &vector,
+        size_t const rows,
+        const void *alpha,
+        const void *beta) {
+        this->impl->buffer->invalidate_norms();
+        this->impl->m_dispatcher->sparse_gemv(
+            static_cast<const int64_t *>(row_pointers.get_raw_buffer()),
+            static_cast<const int64_t *>(column_indices.get_raw_buffer()),
+            values.get_raw_buffer(),
+            vector.get_raw_buffer(),
+            this->get_raw_buffer(),
+            alpha,
+            beta,
+            rows,
+            values.get_dtype());
+    }
+
+    void Array::dot(const Array &other, size_t const length, void *dest) const {
+        this->impl->m_dispatcher->dot(
+            this->get_raw_buffer(), other.get_raw_buffer(), dest, length, this->get_dtype());
+    }
+
+    void Array::axpy(const Array &x, size_t const length, const void *alpha) {
+        this->impl->m_dispatcher->axpy(
+            alpha, x.get_raw_buffer(), this->get_writable_buffer(), length, this->get_dtype());
+    }
+
+    void Array::scal(size_t const length, const void *alpha) {
+        this->impl->m_dispatcher->scal(alpha, this->get_writable_buffer(), length, this->get_dtype());
+    }
+
+    void Array::nrm2(size_t const length, void *dest) const {
+        this->impl->m_dispatcher->nrm2(this->get_raw_buffer(), dest, length, this->get_dtype());
+    }
+
+    void Array::asum(size_t const length, void *dest) const {
+        this->impl->m_dispatcher->asum(this->get_raw_buffer(), dest, length, this->get_dtype());
+    }
+
+    size_t Array::iamax(size_t const length) const {
+        return this->impl->m_dispatcher->iamax(this->get_raw_buffer(), length, this->get_dtype());
+    }
+
+    void Array::reduce_rows(
+        const Array &matrix,
+        size_t const rows,
+        size_t const columns,
+        size_t const leading_dimension,
+        Reduction const reduction) {
+        this->impl->m_dispatcher->reduce_rows(
+            matrix.get_raw_buffer(),
+            this->get_writable_buffer(),
+            rows,
+            columns,
+            leading_dimension,
+            reduction,
+            matrix.get_dtype());
+    }
+
+    void Array::reduce_columns(
+        const Array &matrix,
+        size_t const rows,
+        size_t const columns,
+        size_t const leading_dimension,
+        Reduction const reduction) {
+        this->impl->m_dispatcher->reduce_columns(
+            matrix.get_raw_buffer(),
+            this->get_writable_buffer(),
+            rows,
+            columns,
+            leading_dimension,
+            reduction,
+            matrix.get_dtype());
+    }
+
+    void Array::sparse_query_gemv(
+        const Array &matrix,
+        const Array &indices,
+        const Array &values,
+        size_t const rows,
+        size_t const columns,
+        size_t const leading_dimension,
+        size_t const nonzeros,
+        const void *alpha,
+        const void *beta,
+        bool const transpose) {
+        this->impl->buffer->invalidate_norms();
+        this->impl->m_dispatcher->sparse_query_gemv(
+            matrix.get_raw_buffer(),
+            static_cast<const int64_t *>(indices.get_raw_buffer()),
+            values.get_raw_buffer(),
+            this->get_raw_buffer(),
+            alpha,
+            beta,
+            rows,
+            columns,
+            leading_dimension,
+            nonzeros,
+            transpose,
+            matrix.get_dtype());
+    }
+
+    void Array::replace_segment(const void *source, size_t const items, size_t const start) const {
+        size_t const bytes{dtype_to_bytes(get_dtype())};
+        impl->buffer->overwrite(source, items * bytes, this->impl->offset + start * bytes);
     }
 
     void Array::deep_copy(Array & other) {
@@ -0,0 +1,77 @@
+//
+// Created by sriram on 2/27/25.
+//
+
+#include "cml_c_api.h"
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include "dlpack_exchange.h"
+
+struct CmlMatrix {
+    cobraml::core::Matrix matrix{};
+};
+
+namespace {
+    thread_local std::string last_error{};
+
+    /**
+     * runs body, turning any exception into a -1 return so none cross the C boundary
+     */
+    template<typename Body>
+    int guarded(Body &&body) {
+        try {
+            body();
+            return 0;
+        } catch (const std::exception &e) {
+            last_error = e.what();
+        } catch (...) {
+            last_error = "unknown error";
+        }
+
+        return -1;
+    }
+}
+
+extern "C" {
+    const char *cml_last_error(void) {
+        return last_error.c_str();
+    }
+
+    int cml_matrix_from_dlpack(DLManagedTensor *tensor, int const accelerated, CmlMatrix **matrix) {
+        return guarded([&]() {
+            if (matrix == nullptr)
+                throw std::runtime_error("matrix must not be null");
+
+            auto handle{std::make_unique<CmlMatrix>()};
+            handle->matrix = cobraml::core::from_dlpack(
+                tensor, accelerated ? cobraml::core::CPU_X : cobraml::core::CPU);
+            *matrix = handle.release();
+        });
+    }
+
+    int cml_matrix_to_dlpack(const CmlMatrix *matrix, DLManagedTensor **tensor) {
+        return guarded([&]() {
+            if (matrix == nullptr || tensor == nullptr)
+                throw std::runtime_error("matrix and tensor must not be null");
+
+            *tensor = cobraml::core::to_dlpack(matrix->matrix);
+        });
+    }
+
+    int cml_matrix_shape(const CmlMatrix *matrix, size_t *rows, size_t *columns) {
+        return guarded([&]() {
+            if (matrix == nullptr || rows == nullptr || columns == nullptr)
+                throw std::runtime_error("matrix, rows and columns must not be null");
+
+            auto const [matrix_rows, matrix_columns]{matrix->matrix.get_shape()};
+            *rows = matrix_rows;
+            *columns = matrix_columns;
+        });
+    }
+
+    void cml_matrix_free(CmlMatrix *matrix) {
+        delete matrix;
+    }
+}
@@ -0,0 +1,175 @@
+//
+// Created by sriram on 2/27/25.
+//
+
+#include "dlpack_exchange.h"
+#include <memory>
+#include <stdexcept>
+
+namespace cobraml::core {
+
+    namespace {
+        /**
+         * everything an exported tensor points to, freed in one go by its deleter
+         */
+        struct ExportContext {
+            Matrix matrix{};
+            int64_t shape[2]{};
+            int64_t strides[2]{};
+            DLManagedTensor tensor{};
+        };
+
+        void delete_export(DLManagedTensor *self) {
+            delete static_cast<ExportContext *>(self->manager_ctx);
+        }
+
+        DLDataType to_dl_dtype(Dtype const dtype) {
+            DLDataType ret{};
+            ret.lanes = 1;
+            ret.bits = static_cast<uint8_t>(dtype_to_bytes(dtype) * 8);
+
+            switch (dtype) {
+                case INT8:
+                case INT16:
+                case INT32:
+                case INT64:
+                    ret.code = kDLInt;
+                    return ret;
+                case FLOAT32:
+                case FLOAT64:
+                case FLOAT16:
+                    ret.code = kDLFloat;
+                    return ret;
+                case BFLOAT16:
+                    ret.code = kDLBfloat;
+                    return ret;
+                case INVALID:
+                    throw std::runtime_error("cannot export a matrix of invalid type");
+            }
+
+            throw std::runtime_error("cannot export a matrix of invalid type");
+        }
+
+        Dtype from_dl_dtype(DLDataType const dtype) {
+            if (dtype.lanes == 1) {
+                switch (dtype.code) {
+                    case kDLInt:
+                        switch (dtype.bits) {
+                            case 8: return INT8;
+                            case 16: return INT16;
+                            case 32: return INT32;
+                            case 64: return INT64;
+                            default: break;
+                        }
+                        break;
+                    case kDLFloat:
+                        switch (dtype.bits) {
+                            case 16: return FLOAT16;
+                            case 32: return FLOAT32;
+                            case 64: return FLOAT64;
+                            default: break;
+                        }
+                        break;
+                    case kDLBfloat:
+                        if (dtype.bits == 16)
+                            return BFLOAT16;
+                        break;
+                    default:
+                        break;
+                }
+            }
+
+            throw std::runtime_error(
+                "unsupported DLPack dtype: code " + std::to_string(dtype.code) + ", " + std::to_string(dtype.bits) +
+                " bits, " + std::to_string(dtype.lanes) + " lanes");
+        }
+    }
+
+    DLManagedTensor *to_dlpack(const Matrix &matrix) {
+        if (matrix.rows == 0 || matrix.columns == 0)
+            throw std::runtime_error("cannot export an empty matrix");
+
+        if (matrix.get_device() == GPU)
+            throw std::runtime_error("only CPU and CPU_X matrices can be exported");
+
+        // the consumer can write the memory without the buffer ever seeing it
+        matrix.disable_norm_cache();
+
+        auto context{std::make_unique<ExportContext>()};
+        context->matrix = matrix;
+        context->shape[0] = static_cast<int64_t>(matrix.rows);
+        context->shape[1] = static_cast<int64_t>(matrix.columns);
+        context->strides[0] = static_cast<int64_t>(matrix.leading_dimension);
+        context->strides[1] = 1;
+
+        DLTensor &tensor{context->tensor.dl_tensor};
+        tensor.data = matrix.get_raw_buffer();
+        tensor.device = {kDLCPU, 0};
+        tensor.ndim = 2;
+        tensor.dtype = to_dl_dtype(matrix.get_dtype());
+        tensor.shape = context->shape;
+        tensor.strides = context->strides;
+        tensor.byte_offset = 0;
+
+        context->tensor.manager_ctx = context.get();
+        context->tensor.deleter = delete_export;
+
+        return &context.release()->tensor;
+    }
+
+    Matrix from_dlpack(DLManagedTensor *tensor, Device const device) {
+        if (tensor == nullptr)
+            throw std::runtime_error("cannot import a null tensor");
+
+        if (device == GPU)
+            throw std::runtime_error("tensors can only be imported to CPU or CPU_X");
+
+        const DLTensor &source{tensor->dl_tensor};
+
+        if (source.device.device_type != kDLCPU)
+            throw std::runtime_error("only CPU tensors can be imported");
+
+        if (source.ndim != 1 && source.ndim != 2)
+            throw std::runtime_error("only one and two dimensional tensors can be imported");
+
+        Dtype const dtype{from_dl_dtype(source.dtype)};
+
+        // a tensor made by to_dlpack hands back its matrix, so views keep their layout
+        if (tensor->deleter == delete_export) {
+            if (const Matrix &matrix{static_cast<ExportContext *>(tensor->manager_ctx)->matrix};
+                matrix.get_device() == device) {
+                Matrix ret{matrix};
+                tensor->deleter(tensor);
+                return ret;
+            }
+        }
+
+        int64_t const rows{source.ndim == 2 ? source.shape[0] : 1};
+        int64_t const columns{source.shape[source.ndim - 1]};
+
+        if (rows < 0 || columns < 0)
+            throw std::runtime_error("tensor has a negative dimension");
+
+        // dimensions of size one may carry any stride
+        if (source.strides != nullptr) {
+            bool const compact_columns{columns == 1 || source.strides[source.ndim - 1] == 1};
+            bool const compact_rows{source.ndim == 1 || rows == 1 || source.strides[0] == columns};
+
+            if (!compact_columns || !compact_rows)
+                throw std::runtime_error("only row major compact tensors can be imported");
+        }
+
+        void *data{static_cast<char *>(source.data) + source.byte_offset};
+
+        return wrap(
+            data,
+            static_cast<size_t>(rows),
+            static_cast<size_t>(columns),
+            device,
+            dtype,
+            [tensor]() {
+                if (tensor->deleter != nullptr)
+                    tensor->deleter(tensor);
+            });
+    }
+}
@@ -6,7 +6,7 @@
 
 namespace cobraml::core {
     bool is_float(Dtype const type) {
-        return type == FLOAT32 || type == FLOAT64;
+        return type == FLOAT32 || type == FLOAT64 || is_half(type);
     }
 
     std::string dtype_to_string(Dtype const dtype) {
@@ -17,6 +17,8 @@ namespace cobraml::core {
             case INT64: return "INT64";
             case FLOAT32: return "FLOAT32";
             case FLOAT64: return "FLOAT64";
+            case FLOAT16: return "FLOAT16";
+            case BFLOAT16: return "BFLOAT16";
             case INVALID: return "INVALID";
         }
 
@@ -33,6 +35,16 @@ namespace cobraml::core {
         return "";
     }
 
+    std::string simd_level_to_string(SimdLevel const level) {
+        switch (level) {
+            case SCALAR: return "SCALAR";
+            case SSE: return "SSE4.1";
+            case AVX2: return "AVX2";
+            case AVX512: return "AVX-512";
+        }
+
+        return "";
+    }
 
     bool operator<(Dtype const lhs, Dtype const rhs) {
 
@@ -0,0 +1,38 @@
+//
+// Created by sriram on 2/12/25.
+//
+
+#include "mapped_allocator.h"
+#include <cstring>
+#include <stdexcept>
+#include <sys/mman.h>
+
+namespace cobraml::core {
+
+    MappedAllocator::MappedAllocator(void *base, std::size_t const length): base(base), length(length) {
+    }
+
+    MappedAllocator::~MappedAllocator() {
+        free(base);
+    }
+
+    void *MappedAllocator::malloc(std::size_t) {
+        throw std::runtime_error("a mapped allocator cannot allocate new memory");
+    }
+
+    void *MappedAllocator::calloc(std::size_t) {
+        throw std::runtime_error("a mapped allocator cannot allocate new memory");
+    }
+
+    void MappedAllocator::mem_copy(void *dest, const void *source, std::size_t const bytes) {
+        std::memcpy(dest, source, bytes);
+    }
+
+    void MappedAllocator::free(void *) {
+        if (base == nullptr)
+            return;
+
+        munmap(base, length);
+        base = nullptr;
+    }
+}
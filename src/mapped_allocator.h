@@ -0,0 +1,37 @@
+//
+// Created by sriram on 2/12/25.
+//
+
+#ifndef MAPPED_ALLOCATOR_H
+#define MAPPED_ALLOCATOR_H
+
+#include "allocator.h"
+
+namespace cobraml::core {
+
+    /**
+     * Owns a single memory mapping, buffers wrapping the mapping unmap it instead of freeing it.
+     * It cannot allocate, a new mapping needs a new allocator.
+     */
+    class MappedAllocator final : public Allocator {
+        void *base;
+        std::size_t length;
+
+    public:
+        MappedAllocator(void *base, std::size_t length);
+        ~MappedAllocator() override;
+        MappedAllocator(const MappedAllocator &) = delete;
+        MappedAllocator &operator=(const MappedAllocator &) = delete;
+
+        void *malloc(std::size_t bytes) override;
+        void *calloc(std::size_t bytes) override;
+        void mem_copy(void *dest, const void *source, std::size_t bytes) override;
+
+        /**
+         * unmaps the whole mapping, ptr may point anywhere inside it
+         */
+        void free(void *ptr) override;
+    };
+}
+
+#endif //MAPPED_ALLOCATOR_H
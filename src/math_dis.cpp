@@ -4,13 +4,14 @@
 
 #include "math_dis.h"
 #include "standard_math.h"
+#include "accelerated_kernel/accelerated_math.h"
 #include <array>
 
 namespace cobraml::core {
     std::array<std::unique_ptr<Math>, 3> global_math_kernels = {
         std::make_unique<StandardMath>(),
         std::make_unique<StandardMath>(),
-        std::make_unique<StandardMath>(),
+        std::make_unique<AcceleratedMath>(),
     };
 
     Math * get_math_kernels(const Device device) {
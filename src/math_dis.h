@@ -12,6 +12,18 @@ namespace cobraml::core {
     class Math {
     public:
         virtual ~Math() = default;
+
+        /**
+         * Generalized Matrix Vector Multiplication.
+         * Performs y=αAx+βy, or y=αAᵀx+βy when transpose is set
+         *
+         * @param rows rows of A as stored, the length of x when transposed
+         * @param columns columns of A as stored, the length of y when transposed
+         * @param leading_dimension elements between the starts of consecutive rows of A, columns unless A
+         * is a view into a wider matrix
+         * @param transpose whether to multiply by Aᵀ, A is still read in its row major layout
+         * @param dtype the dtype of A, for FLOAT16 and BFLOAT16 x, y, α and β are FLOAT32
+         */
         virtual void gemv(const void *matrix,
             const void *vector,
             void *dest,
@@ -19,7 +31,263 @@ namespace cobraml::core {
             const void *beta,
             size_t rows,
             size_t columns,
+            size_t leading_dimension,
+            bool transpose,
+            Dtype dtype) = 0;
+
+        /**
+         * Generalized Matrix Matrix Multiplication.
+         * Performs C=αAB+βC, all matrices are row major
+         *
+         * @param matrix_a A of shape (rows, shared)
+         * @param matrix_b B of shape (shared, columns)
+         * @param dest C of shape (rows, columns)
+         */
+        virtual void gemm(const void *matrix_a,
+            const void *matrix_b,
+            void *dest,
+            const void *alpha,
+            const void *beta,
+            size_t rows,
+            size_t shared,
+            size_t columns,
+            Dtype dtype) = 0;
+
+        /**
+         * Batched Generalized Matrix Vector Multiplication.
+         * Performs Y=αXAᵀ+βY, i.e. a gemv for every row of X while streaming A only once
+         *
+         * @param matrix A of shape (rows, columns)
+         * @param queries X of shape (query_count, columns)
+         * @param dest Y of shape (query_count, rows)
+         */
+        virtual void gemv_batched(const void *matrix,
+            const void *queries,
+            void *dest,
+            const void *alpha,
+            const void *beta,
+            size_t rows,
+            size_t columns,
+            size_t query_count,
+            Dtype dtype) = 0;
+
+        /**
+         * Selects the k largest entries of y=αAx without materializing y.
+         * Results are ordered by descending score, ties go to the lower row index
+         *
+         * @param matrix A of shape (rows, columns)
+         * @param vector x of shape (1, columns)
+         * @param indices the k selected row indices
+         * @param scores the k selected scores
+         */
+        virtual void gemv_topk(const void *matrix,
+            const void *vector,
+            int64_t *indices,
+            void *scores,
+            const void *alpha,
+            size_t rows,
+            size_t columns,
+            size_t k,
+            Dtype dtype) = 0;
+
+        /**
+         * computes the L2 norm of every row of a matrix
+         *
+         * @param matrix the matrix of shape (rows, columns)
+         * @param dest the norms of shape (1, rows)
+         */
+        virtual void row_norms(const void *matrix,
+            void *dest,
+            size_t rows,
+            size_t columns,
+            Dtype dtype) = 0;
+
+        /**
+         * Cosine similarity Matrix Vector Multiplication.
+         * Performs y=α(Ax / (‖Aᵢ‖‖x‖))+βy
+         *
+         * @param norms the row norms of A, see row_norms
+         */
+        virtual void gemv_cosine(const void *matrix,
+            const void *vector,
+            const void *norms,
+            void *dest,
+            const void *alpha,
+            const void *beta,
+            size_t rows,
+            size_t columns,
             Dtype dtype) = 0;
+
+        /**
+         * per row asymmetric int8 quantization, q = clamp(round(x / scale) + zero_point, -128, 127)
+         *
+         * @param matrix the FLOAT32 source of shape (rows, columns)
+         * @param dest the quantized matrix
+         * @param scales receives one scale per row
+         * @param zero_points receives one zero point per row
+         */
+        virtual void quantize_rows(const float *matrix,
+            int8_t *dest,
+            float *scales,
+            int32_t *zero_points,
+            size_t rows,
+            size_t columns) = 0;
+
+        /**
+         * inverse of quantize_rows, x = (q - zero_point) * scale
+         */
+        virtual void dequantize_rows(const int8_t *matrix,
+            const float *scales,
+            const int32_t *zero_points,
+            float *dest,
+            size_t rows,
+            size_t columns) = 0;
+
+        /**
+         * Quantized Matrix Vector Multiplication.
+         * Performs y=αAx+βy where A is a per row quantized int8 matrix, x is quantized on the fly,
+         * products are accumulated in int32 and rescaled to float
+         */
+        virtual void quantized_gemv(const int8_t *matrix,
+            const float *scales,
+            const int32_t *zero_points,
+            const float *vector,
+            float *dest,
+            float alpha,
+            float beta,
+            size_t rows,
+            size_t columns) = 0;
+
+        /**
+         * Sparse Matrix Vector Multiplication.
+         * Performs y=αAx+βy where A is stored in CSR form, the nonzeros of row i are
+         * values[row_pointers[i], row_pointers[i + 1]) in the columns column_indices[...]
+         *
+         * @param row_pointers the rows + 1 offsets of the rows into values
+         * @param column_indices the column of every nonzero
+         * @param values the nonzeros
+         * @param rows rows of A, the length of y
+         */
+        virtual void sparse_gemv(const int64_t *row_pointers,
+            const int64_t *column_indices,
+            const void *values,
+            const void *vector,
+            void *dest,
+            const void *alpha,
+            const void *beta,
+            size_t rows,
+            Dtype dtype) = 0;
+
+        /**
+         * General Matrix Vector Multiplication against a sparse x.
+         * Performs y=αAx+βy, or y=αAᵀx+βy when transpose is set, where x is given by its nonzeros. Only the
+         * nonzeros of x are visited, so the work is rows * nonzeros instead of rows * columns
+         *
+         * @param indices the position of every nonzero of x, a column of A or a row of A when transposed
+         * @param values the nonzeros of x
+         * @param rows rows of A
+         * @param columns columns of A
+         * @param leading_dimension the distance in elements between the starts of consecutive rows of A
+         * @param nonzeros the number of nonzeros of x
+         * @param transpose multiply by Aᵀ
+         */
+        virtual void sparse_query_gemv(const void *matrix,
+            const int64_t *indices,
+            const void *values,
+            void *dest,
+            const void *alpha,
+            const void *beta,
+            size_t rows,
+            size_t columns,
+            size_t leading_dimension,
+            size_t nonzeros,
+            bool transpose,
+            Dtype dtype) = 0;
+
+        /**
+         * dot product, dest = xᵀy, accumulated in the dtype. In the level 1 routines FLOAT16 and BFLOAT16 are
+         * computed in FLOAT32, α and every result are then FLOAT32
+         *
+         * @param dest a single element of dtype
+         * @param length the number of elements of x and y
+         */
+        virtual void dot(const void *x, const void *y, void *dest, size_t length, Dtype dtype) = 0;
+
+        /**
+         * y = αx + y
+         *
+         * @param length the number of elements of x and y
+         */
+        virtual void axpy(const void *alpha, const void *x, void *y, size_t length, Dtype dtype) = 0;
+
+        /**
+         * x = αx
+         *
+         * @param length the number of elements of x
+         */
+        virtual void scal(const void *alpha, void *x, size_t length, Dtype dtype) = 0;
+
+        /**
+         * euclidean norm, dest = ‖x‖₂. The squares are summed in double, integer dtypes get the norm
+         * rounded toward zero
+         *
+         * @param dest a single element of dtype
+         * @param length the number of elements of x
+         */
+        virtual void nrm2(const void *x, void *dest, size_t length, Dtype dtype) = 0;
+
+        /**
+         * sum of magnitudes, dest = Σ|xᵢ|, accumulated in the dtype
+         *
+         * @param dest a single element of dtype
+         * @param length the number of elements of x
+         */
+        virtual void asum(const void *x, void *dest, size_t length, Dtype dtype) = 0;
+
+        /**
+         * @param length the number of elements of x
+         * @return the index of the first element of x with the largest magnitude
+         */
+        virtual size_t iamax(const void *x, size_t length, Dtype dtype) = 0;
+
+        /**
+         * reduces every row of A to one element, dest[i] = reduction(A[i, :])
+         *
+         * @param dest rows elements, INT64 for ARGMAX and of dtype otherwise
+         * @param leading_dimension elements between the starts of consecutive rows of A
+         */
+        virtual void reduce_rows(const void *matrix,
+            void *dest,
+            size_t rows,
+            size_t columns,
+            size_t leading_dimension,
+            Reduction reduction,
+            Dtype dtype) = 0;
+
+        /**
+         * reduces every column of A to one element, dest[j] = reduction(A[:, j])
+         *
+         * @param dest columns elements, INT64 for ARGMAX and of dtype otherwise
+         * @param leading_dimension elements between the starts of consecutive rows of A
+         */
+        virtual void reduce_columns(const void *matrix,
+            void *dest,
+            size_t rows,
+            size_t columns,
+            size_t leading_dimension,
+            Reduction reduction,
+            Dtype dtype) = 0;
+
+        /**
+         * zeroes a freshly allocated buffer from the threads and with the static row partition the gemv
+         * kernels use, so every page is first touched, and placed, by the thread that later streams it
+         *
+         * @param dest the buffer
+         * @param rows the number of rows
+         * @param row_bytes the size of one row in bytes
+         * @param dtype the dtype of the elements, the thread count is chosen from the element count as in gemv
+         */
+        virtual void first_touch(void *dest, size_t rows, size_t row_bytes, Dtype dtype) = 0;
     };
 
     extern std::array<std::unique_ptr<Math>, 3> global_math_kernels;
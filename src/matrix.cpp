@@ -6,15 +6,29 @@
 #include "matrix.h"
 #include <iomanip>
 #include <iostream>
+#include <utility>
 #include "enums.h"
 
 namespace cobraml::core {
 
-    Matrix::Matrix(size_t const rows, size_t const columns, Device const device, Dtype const dtype):
-        Array(rows * columns, device, dtype),
+    Matrix::Matrix(
+        size_t const rows,
+        size_t const columns,
+        Device const device,
+        Dtype const dtype,
+        AllocationPolicy const policy):
+        Array(rows * columns, device, dtype, policy == FIRST_TOUCH ? UNINITIALIZED : policy),
         rows(rows),
-        columns(columns){
+        columns(columns),
+        leading_dimension(columns) {
         is_invalid(dtype);
+
+        if (policy == FIRST_TOUCH) {
+            if (rows == 1)
+                first_touch(columns, dtype_to_bytes(dtype));
+            else
+                first_touch(rows, columns * dtype_to_bytes(dtype));
+        }
     }
 
     Matrix::Shape Matrix::get_shape() const {
@@ -24,9 +38,70 @@ namespace cobraml::core {
         return sh;
     }
 
-    Matrix::Matrix(Array const &other): Array(other), rows(0), columns(0) {}
-    Matrix::Matrix(Matrix const &other): Array(other), rows(other.rows), columns(other.columns) {}
+    Matrix::Matrix(
+        std::shared_ptr<Buffer> buffer,
+        size_t const rows,
+        size_t const columns,
+        Device const device,
+        Dtype const dtype):
+        Array(std::move(buffer), rows * columns, device, dtype),
+        rows(rows),
+        columns(columns),
+        leading_dimension(columns) {
+    }
 
+    Matrix::Matrix(
+        void *data,
+        size_t const rows,
+        size_t const columns,
+        Device const device,
+        Dtype const dtype,
+        std::function<void()> release):
+        Array(data, rows * columns, device, dtype, std::move(release)),
+        rows(rows),
+        columns(columns),
+        leading_dimension(columns) {
+    }
+
+    Matrix wrap(
+        void *data,
+        size_t const rows,
+        size_t const columns,
+        Device const device,
+        Dtype const dtype,
+        std::function<void()> release) {
+        if (rows == 0 || columns == 0)
+            throw std::runtime_error("matrix must have at least one row and one column");
+
+        // the array overload decides between adopting and copying, the matrix only adds the shape
+        Matrix ret{wrap(data, rows * columns, device, dtype, std::move(release))};
+        ret.rows = rows;
+        ret.columns = columns;
+        ret.leading_dimension = columns;
+        return ret;
+    }
+
+    Matrix::Matrix(Array const &other): Array(other), rows(0), columns(0), leading_dimension(0) {}
+    Matrix::Matrix(Matrix const &other):
+        Array(other), rows(other.rows), columns(other.columns), leading_dimension(other.leading_dimension) {}
+
+
+    Matrix::Matrix(Matrix &&other) noexcept:
+        Array(std::move(other)),
+        rows(std::exchange(other.rows, 0)),
+        columns(std::exchange(other.columns, 0)),
+        leading_dimension(std::exchange(other.leading_dimension, 0)) {}
+
+    Matrix &Matrix::operator=(Matrix &&other) noexcept {
+        if (this == &other)
+            return *this;
+
+        Array::operator=(std::move(other));
+        rows = std::exchange(other.rows, 0);
+        columns = std::exchange(other.columns, 0);
+        leading_dimension = std::exchange(other.leading_dimension, 0);
+        return *this;
+    }
 
     Matrix::~Matrix() = default;
 
@@ -42,6 +117,101 @@ namespace cobraml::core {
         return this->is_vector() && columns == 1;
     }
 
+    RowView Matrix::row(size_t const index) const {
+        if (index >= rows) {
+            throw std::out_of_range("index is out of range");
+        }
+
+        size_t const bytes{dtype_to_bytes(get_dtype())};
+        return {static_cast<const char *>(get_raw_buffer()) + index * leading_dimension * bytes, columns, get_dtype()};
+    }
+
+    RowIterator Matrix::begin() const {
+        size_t const stride{leading_dimension * dtype_to_bytes(get_dtype())};
+        // a default constructed matrix has no buffer and no rows
+        const char *first{rows == 0 ? nullptr : static_cast<const char *>(get_raw_buffer())};
+        return {first, stride, columns, get_dtype()};
+    }
+
+    RowIterator Matrix::end() const {
+        size_t const stride{leading_dimension * dtype_to_bytes(get_dtype())};
+        const char *first{rows == 0 ? nullptr : static_cast<const char *>(get_raw_buffer())};
+        return {first + rows * stride, stride, columns, get_dtype()};
+    }
+
+    bool Matrix::is_contiguous() const {
+        return rows <= 1 || leading_dimension == columns;
+    }
+
+    void Matrix::deep_copy(Array &other) {
+        auto const *source{dynamic_cast<const Matrix *>(&other)};
+        if (source == nullptr) {
+            if (!is_contiguous()) {
+                throw std::runtime_error("cannot deep copy a flat array into a non contiguous view");
+            }
+
+            Array::deep_copy(other);
+            return;
+        }
+
+        if (get_dtype() != source->get_dtype())
+            throw std::runtime_error("cannot deep copy arrays of different data types");
+
+        if (get_device() != source->get_device())
+            throw std::runtime_error("cannot deep copy arrays on different devices");
+
+        if (!(get_shape() == source->get_shape()))
+            throw std::runtime_error("cannot deep copy matrices of different shapes");
+
+        // a default constructed matrix has no buffer to copy
+        if (rows == 0)
+            return;
+
+        if (is_contiguous() && source->is_contiguous()) {
+            replace_segment(source->get_raw_buffer(), rows * columns);
+            return;
+        }
+
+        size_t const bytes{dtype_to_bytes(get_dtype())};
+        const auto *source_row{static_cast<const char *>(source->get_raw_buffer())};
+        for (size_t row{0}; row < rows; ++row) {
+            replace_segment(source_row, columns, row * leading_dimension);
+            source_row += source->leading_dimension * bytes;
+        }
+    }
+
+    size_t Matrix::get_leading_dimension() const {
+        return leading_dimension;
+    }
+
+    Matrix Matrix::slice(
+        size_t const row_begin,
+        size_t const row_end,
+        size_t const column_begin,
+        size_t const column_end) const {
+
+        if (row_begin >= row_end || column_begin >= column_end) {
+            throw std::runtime_error("slice must contain at least one row and one column");
+        }
+
+        if (row_end > rows || column_end > columns) {
+            throw std::out_of_range("slice is out of range");
+        }
+
+        Matrix ret = *this;
+        ret.rows = row_end - row_begin;
+        ret.columns = column_end - column_begin;
+
+        // a single row is contiguous whatever the stride of its parent
+        if (ret.rows == 1)
+            ret.leading_dimension = ret.columns;
+
+        ret.increment_offset(row_begin * leading_dimension + column_begin);
+        ret.set_length((ret.rows - 1) * leading_dimension + ret.columns);
+
+        return ret;
+    }
+
     Matrix Matrix::operator[](size_t const index) const{
 
         Matrix ret = *this;
@@ -65,14 +235,15 @@ namespace cobraml::core {
         }
 
         ret.columns = this->get_shape().columns;
+        ret.leading_dimension = columns;
 
-        ret.increment_offset(this->columns * index);
+        ret.increment_offset(this->leading_dimension * index);
         ret.set_length(columns);
 
         return ret;
     }
 
-    Matrix::Matrix(): rows(0), columns(0) {}
+    Matrix::Matrix(): rows(0), columns(0), leading_dimension(0) {}
 
     void print_num(void *buffer, Dtype const dtype) {
         switch (dtype) {
@@ -101,6 +272,14 @@ namespace cobraml::core {
                 std::cout << *static_cast<double *>(buffer);
                 return;
             }
+            case FLOAT16: {
+                std::cout << to_float(*static_cast<float16 *>(buffer));
+                return;
+            }
+            case BFLOAT16: {
+                std::cout << to_float(*static_cast<bfloat16 *>(buffer));
+                return;
+            }
             case INVALID: {
                 is_invalid(dtype);
             }
@@ -119,6 +298,7 @@ namespace cobraml::core {
         Array::operator=(other);
         this->rows = other.rows;
         this->columns = other.columns;
+        this->leading_dimension = other.leading_dimension;
 
         return *this;
     }
@@ -131,6 +311,28 @@ namespace cobraml::core {
         std::cout << "#####################################\n";
     }
 
+    size_t iamax(const Matrix &x) {
+        if (!x.is_contiguous()) {
+            throw std::runtime_error("iamax requires a contiguous matrix");
+        }
+
+        return x.iamax(x.rows * x.columns);
+    }
+
+    Matrix reduce_rows(const Matrix &matrix, Reduction const reduction) {
+        Dtype const dtype{reduction == ARGMAX ? INT64 : matrix.get_dtype()};
+        Matrix result(1, matrix.rows, matrix.get_device(), dtype, UNINITIALIZED);
+        result.reduce_rows(matrix, matrix.rows, matrix.columns, matrix.leading_dimension, reduction);
+        return result;
+    }
+
+    Matrix reduce_columns(const Matrix &matrix, Reduction const reduction) {
+        Dtype const dtype{reduction == ARGMAX ? INT64 : matrix.get_dtype()};
+        Matrix result(1, matrix.columns, matrix.get_device(), dtype, UNINITIALIZED);
+        result.reduce_columns(matrix, matrix.rows, matrix.columns, matrix.leading_dimension, reduction);
+        return result;
+    }
+
     // void Matrix::print(bool const hide_middle) const {
     //     print_details(impl->device, impl->dtype, rows, columns);
     //     unsigned char const shift = dtype_to_bytes(impl->dtype);
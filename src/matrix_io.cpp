@@ -0,0 +1,139 @@
+//
+// Created by sriram on 2/12/25.
+//
+
+#include "matrix_io.h"
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "allocator.h"
+#include "mapped_allocator.h"
+
+namespace cobraml::core {
+
+#define MATRIX_FILE_VERSION 1
+#define MATRIX_FILE_ALIGNMENT 64
+
+    static constexpr char matrix_file_magic[8]{'C', 'B', 'R', 'A', 'M', 'T', 'X', '\0'};
+
+    struct MatrixFileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t dtype;
+        uint64_t rows;
+        uint64_t columns;
+        uint64_t data_offset;
+        char reserved[24];
+    };
+
+    static_assert(sizeof(MatrixFileHeader) == MATRIX_FILE_ALIGNMENT, "the header must fill one aligned block");
+
+    void save(const Matrix &matrix, const std::string &path) {
+        const auto [rows, columns]{matrix.get_shape()};
+
+        MatrixFileHeader header{};
+        std::memcpy(header.magic, matrix_file_magic, sizeof(header.magic));
+        header.version = MATRIX_FILE_VERSION;
+        header.dtype = static_cast<uint32_t>(matrix.get_dtype());
+        header.rows = rows;
+        header.columns = columns;
+        header.data_offset = sizeof(MatrixFileHeader);
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            throw std::runtime_error("could not open " + path + " for writing");
+        }
+
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+        // views are written row by row so the file always holds a packed matrix
+        size_t const row_bytes{columns * dtype_to_bytes(matrix.get_dtype())};
+        size_t const stride_bytes{matrix.get_leading_dimension() * dtype_to_bytes(matrix.get_dtype())};
+        const auto data{static_cast<const char *>(matrix.get_raw_buffer())};
+
+        if (matrix.is_contiguous()) {
+            file.write(data, static_cast<std::streamsize>(rows * row_bytes));
+        } else {
+            for (size_t row = 0; row < rows; ++row) {
+                file.write(data + row * stride_bytes, static_cast<std::streamsize>(row_bytes));
+            }
+        }
+
+        if (!file) {
+            throw std::runtime_error("failed to write matrix to " + path);
+        }
+    }
+
+    Matrix load(const std::string &path, Device const device) {
+        if (device != CPU && device != CPU_X) {
+            throw std::runtime_error("matrix files can only be loaded on " + device_to_string(CPU) + " or " +
+                                     device_to_string(CPU_X));
+        }
+
+        int const fd{open(path.c_str(), O_RDONLY)};
+        if (fd < 0) {
+            throw std::runtime_error("could not open " + path);
+        }
+
+        struct stat info{};
+        if (fstat(fd, &info) != 0) {
+            close(fd);
+            throw std::runtime_error("could not stat " + path);
+        }
+
+        const auto file_size{static_cast<size_t>(info.st_size)};
+        if (file_size < sizeof(MatrixFileHeader)) {
+            close(fd);
+            throw std::runtime_error(path + " is too small to be a matrix file");
+        }
+
+        // private and writable, writes become copy on write pages instead of reaching the file
+        void *base{mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0)};
+        close(fd);
+
+        if (base == MAP_FAILED) {
+            throw std::runtime_error("could not map " + path);
+        }
+
+        // unmaps on every exit path until the buffer takes ownership
+        auto allocator{std::make_unique<MappedAllocator>(base, file_size)};
+
+        MatrixFileHeader header{};
+        std::memcpy(&header, base, sizeof(header));
+
+        if (std::memcmp(header.magic, matrix_file_magic, sizeof(header.magic)) != 0) {
+            throw std::runtime_error(path + " is not a matrix file");
+        }
+
+        if (header.version != MATRIX_FILE_VERSION) {
+            throw std::runtime_error(path + " has unsupported format version " + std::to_string(header.version));
+        }
+
+        if (header.dtype >= INVALID) {
+            throw std::runtime_error(path + " has an invalid dtype");
+        }
+
+        const auto dtype{static_cast<Dtype>(header.dtype)};
+
+        if (header.rows == 0 || header.columns == 0) {
+            throw std::runtime_error(path + " holds an empty matrix");
+        }
+
+        if (header.data_offset % MATRIX_FILE_ALIGNMENT != 0 || header.data_offset < sizeof(MatrixFileHeader)) {
+            throw std::runtime_error(path + " has a misaligned data section");
+        }
+
+        size_t const data_bytes{header.rows * header.columns * dtype_to_bytes(dtype)};
+        if (data_bytes / dtype_to_bytes(dtype) / header.columns != header.rows ||
+            header.data_offset > file_size || file_size - header.data_offset < data_bytes) {
+            throw std::runtime_error(path + " is truncated");
+        }
+
+        void *data{static_cast<char *>(base) + header.data_offset};
+        auto buffer{std::make_shared<Buffer>(data, device, std::move(allocator))};
+        return {std::move(buffer), header.rows, header.columns, device, dtype};
+    }
+}
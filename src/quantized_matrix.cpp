@@ -0,0 +1,86 @@
+//
+// Created by sriram on 2/8/25.
+//
+
+#include "quantized_matrix.h"
+
+namespace cobraml::core {
+
+    QuantizedMatrix::QuantizedMatrix(size_t const rows, size_t const columns, Device const device):
+        data(rows, columns, device, INT8),
+        scales(1, rows, device, FLOAT32),
+        zero_points(1, rows, device, INT32) {
+    }
+
+    Matrix::Shape QuantizedMatrix::get_shape() const {
+        return data.get_shape();
+    }
+
+    Device QuantizedMatrix::get_device() const {
+        return data.get_device();
+    }
+
+    const Matrix &QuantizedMatrix::get_data() const {
+        return data;
+    }
+
+    const Matrix &QuantizedMatrix::get_scales() const {
+        return scales;
+    }
+
+    const Matrix &QuantizedMatrix::get_zero_points() const {
+        return zero_points;
+    }
+
+    QuantizedMatrix quantize(const Matrix &matrix) {
+        if (matrix.get_dtype() != FLOAT32) {
+            throw std::runtime_error("only FLOAT32 matrices can be quantized");
+        }
+
+        if (!matrix.is_contiguous()) {
+            throw std::runtime_error("quantize requires a contiguous matrix");
+        }
+
+        const auto [rows, columns]{matrix.get_shape()};
+        QuantizedMatrix ret(rows, columns, matrix.get_device());
+        ret.data.quantize(matrix, ret.scales, ret.zero_points, rows, columns);
+        return ret;
+    }
+
+    Matrix dequantize(const QuantizedMatrix &matrix) {
+        const auto [rows, columns]{matrix.get_shape()};
+        Matrix ret(rows, columns, matrix.get_device(), FLOAT32, UNINITIALIZED);
+        ret.dequantize(matrix.data, matrix.scales, matrix.zero_points, rows, columns);
+        return ret;
+    }
+
+    void gemv(const QuantizedMatrix &matrix, const Matrix &vector, Matrix &result, float const alpha, float const beta) {
+        if (!vector.is_vector()) {
+            throw std::runtime_error("vector is a matrix");
+        }
+
+        if (!result.is_vector()) {
+            throw std::runtime_error("result is a matrix");
+        }
+
+        const auto [rows, columns]{matrix.get_shape()};
+
+        if (columns != vector.columns) {
+            throw std::runtime_error("vector and matrix have different columns lengths");
+        }
+
+        if (rows != result.columns) {
+            throw std::runtime_error("result must be size 1, rows(matrix)");
+        }
+
+        if (matrix.get_device() != vector.get_device() || matrix.get_device() != result.get_device()) {
+            throw std::runtime_error("vector, matrix and result are not on the same device");
+        }
+
+        if (vector.get_dtype() != FLOAT32 || result.get_dtype() != FLOAT32) {
+            throw std::runtime_error("vector and result must be FLOAT32");
+        }
+
+        result.quantized_gemv(matrix.data, matrix.scales, matrix.zero_points, vector, rows, columns, alpha, beta);
+    }
+}
@@ -0,0 +1,36 @@
+//
+// Created by sriram on 2/20/25.
+//
+
+#include "sparse_matrix.h"
+
+namespace cobraml::core {
+
+    Matrix::Shape SparseMatrix::get_shape() const {
+        return {rows, columns};
+    }
+
+    Device SparseMatrix::get_device() const {
+        return values.get_device();
+    }
+
+    Dtype SparseMatrix::get_dtype() const {
+        return values.get_dtype();
+    }
+
+    size_t SparseMatrix::get_nonzeros() const {
+        return nonzeros;
+    }
+
+    const Matrix &SparseMatrix::get_row_pointers() const {
+        return row_pointers;
+    }
+
+    const Matrix &SparseMatrix::get_column_indices() const {
+        return column_indices;
+    }
+
+    const Matrix &SparseMatrix::get_values() const {
+        return values;
+    }
+}
@@ -0,0 +1,228 @@
+//
+// Created by sriram on 2/18/25.
+//
+
+#include "gemv_tuner.h"
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <sstream>
+#include "standard_math.h"
+#include "threading.h"
+
+namespace cobraml::core {
+
+    const std::array<std::string, GEMV_KERNEL_COUNT> gemv_kernel_names{
+        "gemv_naive",
+        "gemv_parallel",
+        "gemv_parallel_simd",
+        "gemv_blocked_2",
+        "gemv_blocked_4",
+        "gemv_blocked_8",
+        "gemv_blocked_2_tiled",
+        "gemv_blocked_4_tiled",
+        "gemv_blocked_8_tiled",
+    };
+
+    static std::atomic<bool> autotuning{false};
+
+    // guards both the table and the tuning file path, gemv only ever takes it shared once a shape is tuned
+    static std::shared_mutex tuning_mutex;
+    static std::map<TuningKey, size_t> tuning_table;
+    static std::string tuning_path;
+
+    bool TuningKey::operator<(const TuningKey &other) const {
+        if (dtype != other.dtype) return dtype < other.dtype;
+        if (rows_bucket != other.rows_bucket) return rows_bucket < other.rows_bucket;
+        if (columns_bucket != other.columns_bucket) return columns_bucket < other.columns_bucket;
+        return threads < other.threads;
+    }
+
+    /**
+     * @return the exponent of the smallest power of two >= value
+     */
+    static size_t bucket(size_t const value) {
+        size_t exponent{0};
+        while ((1UL << exponent) < value && exponent < 63) ++exponent;
+        return exponent;
+    }
+
+    TuningKey make_tuning_key(Dtype const dtype, size_t const rows, size_t const columns) {
+        // below the threshold the kernels run on one thread whatever the configured count
+        size_t const threads{rows * columns < get_parallel_threshold() ? 1 : get_thread_count()};
+        return {dtype, bucket(rows), bucket(columns), threads};
+    }
+
+    bool find_gemv_kernel(const TuningKey &key, size_t &kernel) {
+        std::shared_lock lock(tuning_mutex);
+        auto const entry{tuning_table.find(key)};
+
+        if (entry == tuning_table.end()) return false;
+
+        kernel = entry->second;
+        return true;
+    }
+
+    static Dtype string_to_dtype(const std::string &name) {
+        for (Dtype const dtype: {INT8, INT16, INT32, INT64, FLOAT32, FLOAT64}) {
+            if (dtype_to_string(dtype) == name) return dtype;
+        }
+
+        return INVALID;
+    }
+
+    /**
+     * writes the whole table to a temporary file and renames it over the tuning file, so a crash never
+     * leaves a half written file behind. The caller holds the lock.
+     */
+    static void save_table() {
+        if (tuning_path.empty()) return;
+
+        std::string const temp_path{tuning_path + ".tmp"};
+        std::ofstream out(temp_path, std::ios::trunc);
+
+        if (!out)
+            throw std::runtime_error("could not write tuning file " + tuning_path);
+
+        for (const auto &[key, kernel]: tuning_table) {
+            out << dtype_to_string(key.dtype) << ' '
+                    << key.rows_bucket << ' '
+                    << key.columns_bucket << ' '
+                    << key.threads << ' '
+                    << gemv_kernel_names[kernel] << '\n';
+        }
+
+        out.close();
+
+        if (!out || std::rename(temp_path.c_str(), tuning_path.c_str()) != 0) {
+            std::remove(temp_path.c_str());
+            throw std::runtime_error("could not write tuning file " + tuning_path);
+        }
+    }
+
+    /**
+     * merges the entries of the tuning file into the table, lines with unknown dtypes or kernels, e.g.
+     * from another build, are skipped. The caller holds the lock.
+     */
+    static void load_table() {
+        std::ifstream in(tuning_path);
+        std::string line;
+
+        while (std::getline(in, line)) {
+            std::istringstream fields(line);
+            std::string dtype_name, kernel_name;
+            TuningKey key{INVALID, 0, 0, 0};
+
+            if (!(fields >> dtype_name >> key.rows_bucket >> key.columns_bucket >> key.threads >> kernel_name))
+                continue;
+
+            key.dtype = string_to_dtype(dtype_name);
+            if (key.dtype == INVALID) continue;
+
+            for (size_t kernel{0}; kernel < GEMV_KERNEL_COUNT; ++kernel) {
+                if (gemv_kernel_names[kernel] == kernel_name) {
+                    tuning_table[key] = kernel;
+                    break;
+                }
+            }
+        }
+    }
+
+    void record_gemv_kernel(const TuningKey &key, size_t const kernel, bool const best_effort) {
+        std::unique_lock lock(tuning_mutex);
+        tuning_table[key] = kernel;
+
+        try {
+            save_table();
+        } catch (const std::runtime_error &) {
+            if (!best_effort) throw;
+        }
+    }
+
+    void set_autotuning(bool const enabled) {
+        autotuning = enabled;
+    }
+
+    bool get_autotuning() {
+        return autotuning;
+    }
+
+    void set_tuning_file(const std::string &path) {
+        std::unique_lock lock(tuning_mutex);
+        tuning_path = path;
+
+        if (!tuning_path.empty()) load_table();
+    }
+
+    template<typename NumType>
+    static size_t calibrate(size_t const rows, size_t const columns) {
+        std::mt19937 generator(42);
+        std::uniform_int_distribution distribution(-8, 8);
+
+        std::vector<NumType> mat(rows * columns);
+        std::vector<NumType> vec(columns);
+
+        for (auto &value: mat) value = static_cast<NumType>(distribution(generator));
+        for (auto &value: vec) value = static_cast<NumType>(distribution(generator));
+
+        return fastest_gemv(mat.data(), vec.data(), rows, columns, columns);
+    }
+
+    void calibrate_gemv(Dtype const dtype, size_t const rows, size_t const columns) {
+        if (rows == 0 || columns == 0)
+            throw std::runtime_error("cannot calibrate gemv on an empty shape");
+
+        size_t kernel;
+
+        switch (dtype) {
+            case INT8: {
+                kernel = calibrate<int8_t>(rows, columns);
+                break;
+            }
+            case INT16: {
+                kernel = calibrate<int16_t>(rows, columns);
+                break;
+            }
+            case INT32: {
+                kernel = calibrate<int32_t>(rows, columns);
+                break;
+            }
+            case INT64: {
+                kernel = calibrate<int64_t>(rows, columns);
+                break;
+            }
+            case FLOAT32: {
+                kernel = calibrate<float>(rows, columns);
+                break;
+            }
+            case FLOAT64: {
+                kernel = calibrate<double>(rows, columns);
+                break;
+            }
+            case FLOAT16:
+            case BFLOAT16: {
+                throw std::runtime_error("gemv on half precision storage has a single kernel, nothing to calibrate");
+            }
+            case INVALID: {
+                throw std::runtime_error("cannot calibrate gemv on invalid type");
+            }
+        }
+
+        record_gemv_kernel(make_tuning_key(dtype, rows, columns), kernel);
+    }
+
+    std::string tuned_gemv_kernel(Dtype const dtype, size_t const rows, size_t const columns) {
+        size_t kernel{DEFAULT_GEMV_KERNEL};
+        find_gemv_kernel(make_tuning_key(dtype, rows, columns), kernel);
+        return gemv_kernel_names[kernel];
+    }
+
+    void clear_tuning() {
+        std::unique_lock lock(tuning_mutex);
+        tuning_table.clear();
+    }
+}
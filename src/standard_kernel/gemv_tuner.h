@@ -0,0 +1,60 @@
+//
+// Created by sriram on 2/18/25.
+//
+
+#ifndef GEMV_TUNER_H
+#define GEMV_TUNER_H
+
+#include <array>
+#include <string>
+#include "enums.h"
+#include "tuning.h"
+
+namespace cobraml::core {
+
+#define GEMV_KERNEL_COUNT 9
+#define DEFAULT_GEMV_KERNEL 6
+
+// rows per block of the default kernel, StandardMath::first_touch places pages in blocks of the same size
+#define DEFAULT_BLOCK_ROWS 2
+
+// bytes of x per column tile of the tiled gemv kernels, half of a typical 32 KB L1
+#define GEMV_TILE_BYTES 16384
+
+    /**
+     * names of the tunable gemv kernels, indexed like gemv_candidates and func_pos
+     */
+    extern const std::array<std::string, GEMV_KERNEL_COUNT> gemv_kernel_names;
+
+    struct TuningKey {
+        Dtype dtype;
+        size_t rows_bucket;
+        size_t columns_bucket;
+        size_t threads;
+
+        bool operator<(const TuningKey &other) const;
+    };
+
+    /**
+     * @return the tuning table key of a gemv on a (rows, columns) matrix with the current thread settings
+     */
+    TuningKey make_tuning_key(Dtype dtype, size_t rows, size_t columns);
+
+    /**
+     * @param key the shape
+     * @param kernel receives the tuned kernel index
+     * @return whether the shape has been tuned
+     */
+    bool find_gemv_kernel(const TuningKey &key, size_t &kernel);
+
+    /**
+     * stores a tuned kernel, and writes the table to the tuning file if one is set
+     *
+     * @param key the shape
+     * @param kernel the tuned kernel index
+     * @param best_effort skip the write instead of throwing when the tuning file cannot be written
+     */
+    void record_gemv_kernel(const TuningKey &key, size_t kernel, bool best_effort = false);
+}
+
+#endif //GEMV_TUNER_H
@@ -0,0 +1,270 @@
+//
+// Created by sriram on 2/14/25.
+//
+
+#include "pool_allocator.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <unordered_map>
+
+namespace cobraml::core {
+
+#define POOL_ALIGNMENT 64
+#define POOL_HEADER_BYTES 64       // keeps the returned pointer POOL_ALIGNMENT aligned
+#define POOL_MIN_CLASS_SHIFT 8     // the smallest class holds 256 bytes, StandardAllocator's minimum
+#define POOL_MAX_CLASS_SHIFT 26    // classes stop at 64 MB, larger blocks bypass the pool
+#define POOL_CLASS_STEPS 4         // classes per power of two, bounds the wasted space to 25%
+#define POOL_CLASS_COUNT ((POOL_MAX_CLASS_SHIFT - POOL_MIN_CLASS_SHIFT) * POOL_CLASS_STEPS + 1)
+#define POOL_LARGE_CLASS POOL_CLASS_COUNT
+#define THREAD_CACHE_BLOCKS 16     // most blocks a thread keeps per class
+#define THREAD_CACHE_BYTES (4 << 20) // most bytes a thread keeps per class, whichever limit is lower
+
+    struct BlockHeader {
+        BlockHeader *next;
+        size_t size_class;
+        size_t bytes;
+    };
+
+    static_assert(sizeof(BlockHeader) <= POOL_HEADER_BYTES, "block header does not fit in front of the block");
+
+    static size_t class_bytes(size_t const size_class) {
+        size_t const base{static_cast<size_t>(1) << (POOL_MIN_CLASS_SHIFT + size_class / POOL_CLASS_STEPS)};
+        return base + base / POOL_CLASS_STEPS * (size_class % POOL_CLASS_STEPS);
+    }
+
+    static size_t size_class_of(size_t const bytes) {
+        if (bytes <= class_bytes(0))
+            return 0;
+
+        // the power of two right below bytes, then the first step above it
+        size_t shift{0};
+        for (size_t rest{bytes - 1}; rest > 1; rest >>= 1)
+            ++shift;
+
+        if (shift >= POOL_MAX_CLASS_SHIFT)
+            return POOL_LARGE_CLASS;
+
+        size_t const base{static_cast<size_t>(1) << shift};
+        size_t const step{base / POOL_CLASS_STEPS};
+        size_t const sub{(bytes - base + step - 1) / step};
+        return (shift - POOL_MIN_CLASS_SHIFT) * POOL_CLASS_STEPS + sub;
+    }
+
+    static size_t thread_cache_limit(size_t const size_class) {
+        size_t const by_bytes{THREAD_CACHE_BYTES / class_bytes(size_class)};
+        return std::max<size_t>(1, std::min<size_t>(THREAD_CACHE_BLOCKS, by_bytes));
+    }
+
+    static void *to_user(BlockHeader *header) {
+        return reinterpret_cast<char *>(header) + POOL_HEADER_BYTES;
+    }
+
+    static BlockHeader *to_header(void *ptr) {
+        return reinterpret_cast<BlockHeader *>(static_cast<char *>(ptr) - POOL_HEADER_BYTES);
+    }
+
+    static BlockHeader *system_allocate(size_t const size_class, size_t const bytes) {
+        // aligned_alloc requires a size that is a multiple of the alignment, large blocks have any size
+        size_t const total{(POOL_HEADER_BYTES + bytes + POOL_ALIGNMENT - 1) / POOL_ALIGNMENT * POOL_ALIGNMENT};
+        void *raw{std::aligned_alloc(POOL_ALIGNMENT, total)};
+        if (raw == nullptr)
+            throw std::bad_alloc();
+
+        auto *header{static_cast<BlockHeader *>(raw)};
+        header->next = nullptr;
+        header->size_class = size_class;
+        header->bytes = bytes;
+        return header;
+    }
+
+    /**
+     * singly linked free lists, one per size class
+     */
+    struct FreeLists {
+        std::array<BlockHeader *, POOL_CLASS_COUNT> heads;
+        std::array<size_t, POOL_CLASS_COUNT> counts;
+
+        FreeLists(): heads(), counts() {
+            heads.fill(nullptr);
+            counts.fill(0);
+        }
+
+        void push(BlockHeader *header) {
+            header->next = heads[header->size_class];
+            heads[header->size_class] = header;
+            ++counts[header->size_class];
+        }
+
+        BlockHeader *pop(size_t const size_class) {
+            BlockHeader *header{heads[size_class]};
+            if (header != nullptr) {
+                heads[size_class] = header->next;
+                --counts[size_class];
+            }
+
+            return header;
+        }
+    };
+
+    struct PoolState {
+        std::mutex lock;
+        FreeLists shared;
+        std::atomic<size_t> hits;
+        std::atomic<size_t> misses;
+        std::atomic<size_t> bytes_retained;
+
+        PoolState(): lock(), shared(), hits(0), misses(0), bytes_retained(0) {
+        }
+
+        PoolState(const PoolState &) = delete;
+        PoolState &operator=(const PoolState &) = delete;
+
+        ~PoolState() {
+            release();
+        }
+
+        /**
+         * frees every block on the shared lists
+         */
+        void release() {
+            std::lock_guard guard(lock);
+            for (size_t size_class{0}; size_class < POOL_CLASS_COUNT; ++size_class) {
+                while (BlockHeader *header = shared.pop(size_class)) {
+                    bytes_retained -= class_bytes(size_class);
+                    std::free(header);
+                }
+            }
+        }
+    };
+
+    /**
+     * the blocks one thread keeps for one pool, they return to the shared lists when the thread exits
+     */
+    struct ThreadCache {
+        std::shared_ptr<PoolState> state;
+        FreeLists local;
+
+        explicit ThreadCache(std::shared_ptr<PoolState> state): state(std::move(state)), local() {
+        }
+
+        ThreadCache(const ThreadCache &) = delete;
+        ThreadCache &operator=(const ThreadCache &) = delete;
+
+        ~ThreadCache() {
+            for (size_t size_class{0}; size_class < POOL_CLASS_COUNT; ++size_class) {
+                flush(size_class, 0);
+            }
+        }
+
+        /**
+         * moves blocks of a class to the shared lists until keep remain
+         */
+        void flush(size_t const size_class, size_t const keep) {
+            if (local.counts[size_class] <= keep)
+                return;
+
+            std::lock_guard guard(state->lock);
+            while (local.counts[size_class] > keep) {
+                state->shared.push(local.pop(size_class));
+            }
+        }
+
+        /**
+         * moves up to half a cache worth of blocks from the shared lists, returns one of them
+         */
+        BlockHeader *refill(size_t const size_class) {
+            std::lock_guard guard(state->lock);
+            size_t const batch{thread_cache_limit(size_class) / 2};
+
+            for (size_t i{0}; i < batch; ++i) {
+                BlockHeader *header{state->shared.pop(size_class)};
+                if (header == nullptr)
+                    break;
+
+                local.push(header);
+            }
+
+            return state->shared.pop(size_class);
+        }
+    };
+
+    static ThreadCache &thread_cache(const std::shared_ptr<PoolState> &state) {
+        thread_local std::unordered_map<const PoolState *, ThreadCache> caches;
+        return caches.try_emplace(state.get(), state).first->second;
+    }
+
+    PoolAllocator::PoolAllocator(): state(std::make_shared<PoolState>()) {
+    }
+
+    void *PoolAllocator::malloc(std::size_t const bytes) {
+        size_t const size_class{size_class_of(bytes)};
+
+        if (size_class == POOL_LARGE_CLASS) {
+            ++state->misses;
+            return to_user(system_allocate(size_class, bytes));
+        }
+
+        ThreadCache &cache{thread_cache(state)};
+        BlockHeader *header{cache.local.pop(size_class)};
+
+        if (header == nullptr)
+            header = cache.refill(size_class);
+
+        if (header == nullptr) {
+            ++state->misses;
+            return to_user(system_allocate(size_class, class_bytes(size_class)));
+        }
+
+        ++state->hits;
+        state->bytes_retained -= class_bytes(size_class);
+        return to_user(header);
+    }
+
+    void *PoolAllocator::calloc(std::size_t const bytes) {
+        void *ptr{malloc(bytes)};
+        std::memset(ptr, 0, to_header(ptr)->bytes);
+        return ptr;
+    }
+
+    void PoolAllocator::mem_copy(void *dest, const void *source, std::size_t const bytes) {
+        std::memcpy(dest, source, bytes);
+    }
+
+    void PoolAllocator::free(void *ptr) {
+        if (ptr == nullptr)
+            return;
+
+        BlockHeader *header{to_header(ptr)};
+        size_t const size_class{header->size_class};
+
+        if (size_class == POOL_LARGE_CLASS) {
+            std::free(header);
+            return;
+        }
+
+        state->bytes_retained += class_bytes(size_class);
+
+        ThreadCache &cache{thread_cache(state)};
+        cache.local.push(header);
+
+        if (size_t const limit{thread_cache_limit(size_class)}; cache.local.counts[size_class] > limit)
+            cache.flush(size_class, limit / 2);
+    }
+
+    AllocatorStats PoolAllocator::stats() const {
+        return {state->hits.load(), state->misses.load(), state->bytes_retained.load()};
+    }
+
+    void PoolAllocator::release_retained() {
+        ThreadCache &cache{thread_cache(state)};
+        for (size_t size_class{0}; size_class < POOL_CLASS_COUNT; ++size_class) {
+            cache.flush(size_class, 0);
+        }
+
+        state->release();
+    }
+}
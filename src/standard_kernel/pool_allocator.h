@@ -0,0 +1,32 @@
+//
+// Created by sriram on 2/14/25.
+//
+
+#ifndef POOL_ALLOCATOR_H
+#define POOL_ALLOCATOR_H
+
+#include "../allocator.h"
+
+namespace cobraml::core {
+    struct PoolState;
+
+    /**
+     * Caching allocator, freed blocks are kept on size class free lists and handed out again. Each
+     * thread owns a small cache per size class that needs no locking, overflow and refills go through
+     * a shared pool guarded by a mutex. Blocks larger than the biggest size class bypass the pool.
+     */
+    class PoolAllocator final : public Allocator {
+        std::shared_ptr<PoolState> state;
+
+    public:
+        PoolAllocator();
+        void *malloc(std::size_t bytes) override;
+        void *calloc(std::size_t bytes) override;
+        void mem_copy(void *dest, const void *source, std::size_t bytes) override;
+        void free(void *ptr) override;
+        [[nodiscard]] AllocatorStats stats() const override;
+        void release_retained() override;
+    };
+}
+
+#endif //POOL_ALLOCATOR_H
@@ -3,15 +3,185 @@
 //
 
 #include "standard_allocator.h"
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <map>
+#include <sys/mman.h>
 
 
 namespace cobraml::core {
 
 #define ALIGNMENT 32
 #define MIN_LENGTH 256 // 64  * 4 (ensures there is a 4 element padding for 64 bit systems)
+#define HUGE_PAGE_BYTES (2UL << 20)
+#define DEFAULT_HUGE_PAGE_THRESHOLD (32UL << 20)
+
+    /**
+     * a buffer placed in its own mapping by the huge page path
+     */
+    struct HugeMapping {
+        size_t length;
+        bool hugetlbfs;
+    };
+
+    static std::atomic<HugePageMode> active_huge_page_mode{TRANSPARENT_HUGE_PAGES};
+    static std::atomic<size_t> active_huge_page_threshold{DEFAULT_HUGE_PAGE_THRESHOLD};
+    static std::atomic<size_t> hugetlbfs_fallbacks{0};
+
+    static std::mutex mapping_lock;
+
+    // keyed by the start address, lets free and the stats find the mapping behind any pointer
+    static std::map<uintptr_t, HugeMapping> &huge_mappings() {
+        static std::map<uintptr_t, HugeMapping> mappings;
+        return mappings;
+    }
+
+    static size_t round_to_huge_page(size_t const bytes) {
+        return (bytes + HUGE_PAGE_BYTES - 1) / HUGE_PAGE_BYTES * HUGE_PAGE_BYTES;
+    }
+
+    /**
+     * maps length bytes at a 2 MB boundary by over mapping and trimming the ends, then asks for transparent
+     * huge pages
+     */
+    static void *map_transparent(size_t const length) {
+        size_t const padded{length + HUGE_PAGE_BYTES};
+        void *raw{mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)};
+
+        if (raw == MAP_FAILED)
+            return nullptr;
+
+        auto const start{reinterpret_cast<uintptr_t>(raw)};
+        uintptr_t const aligned{(start + HUGE_PAGE_BYTES - 1) / HUGE_PAGE_BYTES * HUGE_PAGE_BYTES};
+
+        if (size_t const head{aligned - start}; head > 0)
+            munmap(raw, head);
+
+        if (size_t const tail{start + padded - (aligned + length)}; tail > 0)
+            munmap(reinterpret_cast<void *>(aligned + length), tail);
+
+        void *ptr{reinterpret_cast<void *>(aligned)};
+        madvise(ptr, length, MADV_HUGEPAGE);
+        return ptr;
+    }
+
+    /**
+     * places a buffer in its own mapping, anonymous mappings are zero filled on first touch
+     *
+     * @return the mapping, nullptr if no mapping could be created
+     */
+    static void *map_huge(size_t const bytes) {
+        size_t const length{round_to_huge_page(bytes)};
+        bool hugetlbfs{false};
+        void *ptr{nullptr};
+
+        if (active_huge_page_mode.load() == HUGETLBFS_PAGES) {
+            void *raw{mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0)};
+
+            if (raw != MAP_FAILED) {
+                ptr = raw;
+                hugetlbfs = true;
+            } else {
+                ++hugetlbfs_fallbacks;
+            }
+        }
+
+        if (ptr == nullptr)
+            ptr = map_transparent(length);
+
+        if (ptr == nullptr)
+            return nullptr;
+
+        std::lock_guard guard(mapping_lock);
+        huge_mappings().emplace(reinterpret_cast<uintptr_t>(ptr), HugeMapping{length, hugetlbfs});
+        return ptr;
+    }
+
+    static bool takes_huge_path(size_t const bytes) {
+        return active_huge_page_mode.load() != NO_HUGE_PAGES && bytes >= active_huge_page_threshold.load();
+    }
+
+    void configure_huge_pages(HugePageMode const mode, size_t const threshold) {
+        active_huge_page_mode.store(mode);
+        active_huge_page_threshold.store(threshold);
+    }
+
+    HugePageMode huge_page_mode() {
+        return active_huge_page_mode.load();
+    }
+
+    size_t huge_page_threshold() {
+        return active_huge_page_threshold.load();
+    }
+
+    HugePageStats huge_page_stats() {
+        std::lock_guard guard(mapping_lock);
+        HugePageStats stats{0, 0, 0, hugetlbfs_fallbacks.load()};
+
+        for (const auto &[start, mapping]: huge_mappings()) {
+            ++stats.buffers;
+            stats.bytes += mapping.length;
+            stats.hugetlbfs_buffers += mapping.hugetlbfs ? 1 : 0;
+        }
+
+        return stats;
+    }
+
+    size_t mapped_huge_page_bytes(const void *ptr) {
+        uintptr_t start;
+        size_t length;
+
+        {
+            std::lock_guard guard(mapping_lock);
+            auto const address{reinterpret_cast<uintptr_t>(ptr)};
+            auto const it{huge_mappings().upper_bound(address)};
+
+            if (it == huge_mappings().begin())
+                return 0;
+
+            auto const &[found_start, mapping]{*std::prev(it)};
+            if (address >= found_start + mapping.length)
+                return 0;
+
+            start = found_start;
+            length = mapping.length;
+        }
+
+        // the kernel may report the mapping as part of a larger merged region, so sum every region
+        // overlapping it and clamp the result to its length
+        std::ifstream smaps("/proc/self/smaps");
+        std::string line;
+        bool inside{false};
+        size_t total{0};
+
+        while (std::getline(smaps, line)) {
+            uintptr_t region_start, region_end;
+
+            if (std::sscanf(line.c_str(), "%" SCNxPTR "-%" SCNxPTR " ", &region_start, &region_end) == 2) {
+                inside = region_start < start + length && region_end > start;
+                continue;
+            }
+
+            if (!inside)
+                continue;
+
+            size_t kilobytes;
+            if (std::sscanf(line.c_str(), "AnonHugePages: %zu kB", &kilobytes) == 1 ||
+                std::sscanf(line.c_str(), "Private_Hugetlb: %zu kB", &kilobytes) == 1 ||
+                std::sscanf(line.c_str(), "Shared_Hugetlb: %zu kB", &kilobytes) == 1) {
+                total += kilobytes * 1024;
+            }
+        }
+
+        return std::min(total, length);
+    }
 
     static size_t compute_aligned_size(size_t const bytes) {
 
@@ -29,6 +199,11 @@ namespace cobraml::core {
     void * StandardAllocator::malloc(std::size_t const bytes) {
         // std::cout << bytes << " bytes" << std::endl;
         // std::cout << compute_aligned_size(bytes) << " bytes" << std::endl;
+        if (takes_huge_path(bytes)) {
+            if (void *ptr = map_huge(bytes))
+                return ptr;
+        }
+
         return std::aligned_alloc(ALIGNMENT, compute_aligned_size(bytes));
     }
 
@@ -36,7 +211,13 @@ namespace cobraml::core {
     // A malloc() followed by a memset() will likely be about as fast as calloc()
     // https://stackoverflow.com/questions/2605476/calloc-v-s-malloc-and-time-efficiency
     void * StandardAllocator::calloc(const std::size_t bytes) {
-        void * ptr = malloc(bytes);
+        // fresh anonymous mappings are already zero, touching them here would also defeat first touch
+        if (takes_huge_path(bytes)) {
+            if (void *ptr = map_huge(bytes))
+                return ptr;
+        }
+
+        void * ptr = std::aligned_alloc(ALIGNMENT, compute_aligned_size(bytes));
         std::memset(ptr, 0, compute_aligned_size(bytes));
         return ptr;
     }
@@ -46,6 +227,22 @@ namespace cobraml::core {
     }
 
     void StandardAllocator::free(void *ptr) {
+        // every huge mapping starts on a 2 MB boundary, anything else came from aligned_alloc and is freed
+        // without touching the shared mapping table
+        if (reinterpret_cast<uintptr_t>(ptr) % HUGE_PAGE_BYTES != 0) {
+            std::free(ptr);
+            return;
+        }
+
+        {
+            std::lock_guard guard(mapping_lock);
+            if (auto const it{huge_mappings().find(reinterpret_cast<uintptr_t>(ptr))}; it != huge_mappings().end()) {
+                munmap(ptr, it->second.length);
+                huge_mappings().erase(it);
+                return;
+            }
+        }
+
         std::free(ptr);
     }
 }
@@ -8,6 +8,21 @@
 #include "../allocator.h"
 
 namespace cobraml::core {
+    /**
+     * @param ptr any address inside a buffer
+     * @return the huge page backed bytes of the huge page mapping holding ptr, 0 if ptr is not in one
+     */
+    size_t mapped_huge_page_bytes(const void *ptr);
+
+    void configure_huge_pages(HugePageMode mode, size_t threshold);
+    HugePageMode huge_page_mode();
+    size_t huge_page_threshold();
+    HugePageStats huge_page_stats();
+
+    /**
+     * aligned_alloc based allocator, buffers at or above the huge page threshold are instead placed in
+     * their own 2 MB aligned mapping
+     */
     class StandardAllocator final : public Allocator {
         void *malloc(std::size_t bytes) override;
         void *calloc(std::size_t bytes) override;
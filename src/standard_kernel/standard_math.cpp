@@ -3,21 +3,672 @@
 //
 
 #include "standard_math.h"
-#include <omp.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include "enums.h"
 
 
 namespace cobraml::core {
 
-    void set_num_threads() {
-        static bool set = false;
+    static int8_t clamp_to_int8(long const value) {
+        return static_cast<int8_t>(std::clamp(value, -128L, 127L));
+    }
+
+    float quantize_vector(const float *vector, int8_t *dest, size_t const columns, int32_t &sum) {
+        float max_abs = 0;
+        for (size_t i = 0; i < columns; ++i) {
+            max_abs = std::max(max_abs, std::fabs(vector[i]));
+        }
+
+        float const scale = max_abs == 0 ? 1.0f : max_abs / 127.0f;
+        sum = 0;
+
+        for (size_t i = 0; i < columns; ++i) {
+            dest[i] = clamp_to_int8(std::lround(vector[i] / scale));
+            sum += dest[i];
+        }
+
+        return scale;
+    }
+
+    void StandardMath::quantize_rows(
+        const float *matrix,
+        int8_t *dest,
+        float *scales,
+        int32_t *zero_points,
+        size_t const rows,
+        size_t const columns) {
+        set_num_threads(rows * columns);
+        size_t start;
+
+#pragma omp parallel for default(none) shared(matrix, dest, scales, zero_points, rows, columns) private(start) schedule(static)
+        for (start = 0; start < rows; ++start) {
+            const float *row = matrix + start * columns;
+
+            // the range always contains 0 so that 0 is exactly representable
+            float low = 0;
+            float high = 0;
+            for (size_t i = 0; i < columns; ++i) {
+                low = std::min(low, row[i]);
+                high = std::max(high, row[i]);
+            }
+
+            float const scale = high == low ? 1.0f : (high - low) / 255.0f;
+            int32_t const zero_point = clamp_to_int8(std::lround(-128.0f - low / scale));
+
+            for (size_t i = 0; i < columns; ++i) {
+                dest[start * columns + i] = clamp_to_int8(std::lround(row[i] / scale) + zero_point);
+            }
+
+            scales[start] = scale;
+            zero_points[start] = zero_point;
+        }
+    }
+
+    void StandardMath::dequantize_rows(
+        const int8_t *matrix,
+        const float *scales,
+        const int32_t *zero_points,
+        float *dest,
+        size_t const rows,
+        size_t const columns) {
+        set_num_threads(rows * columns);
+        size_t start;
+
+#pragma omp parallel for default(none) shared(matrix, scales, zero_points, dest, rows, columns) private(start) schedule(static)
+        for (start = 0; start < rows; ++start) {
+            float const scale = scales[start];
+            int32_t const zero_point = zero_points[start];
+
+#pragma omp simd
+            for (size_t i = 0; i < columns; ++i) {
+                dest[start * columns + i] = static_cast<float>(matrix[start * columns + i] - zero_point) * scale;
+            }
+        }
+    }
+
+    void StandardMath::quantized_gemv(
+        const int8_t *matrix,
+        const float *scales,
+        const int32_t *zero_points,
+        const float *vector,
+        float *dest,
+        float const alpha,
+        float const beta,
+        size_t const rows,
+        size_t const columns) {
+        std::vector<int8_t> quantized(columns);
+        int32_t vector_sum;
+        float const vector_scale = quantize_vector(vector, quantized.data(), columns, vector_sum);
+        const int8_t *q_vector = quantized.data();
+
+        set_num_threads(rows * columns);
+        size_t start;
+
+#pragma omp parallel for default(none) shared(matrix, scales, zero_points, q_vector, vector_sum, vector_scale, dest, alpha, beta, rows, columns) private(start) schedule(static)
+        for (start = 0; start < rows; ++start) {
+            int32_t partial = 0;
+
+#pragma omp simd reduction(+:partial)
+            for (size_t i = 0; i < columns; ++i) {
+                partial += static_cast<int32_t>(matrix[start * columns + i]) * static_cast<int32_t>(q_vector[i]);
+            }
+
+            // Σ(q - z)qₓ = Σqqₓ - zΣqₓ
+            int64_t const centered = static_cast<int64_t>(partial) -
+                                     static_cast<int64_t>(zero_points[start]) * vector_sum;
+            float const dot = static_cast<float>(centered) * scales[start] * vector_scale;
+            scale_store(dest[start], dot, alpha, beta);
+        }
+    }
+
+    void StandardMath::sparse_gemv(
+        const int64_t *row_pointers,
+        const int64_t *column_indices,
+        const void *values,
+        const void *vector,
+        void *dest,
+        const void *alpha,
+        const void *beta,
+        size_t const rows,
+        Dtype const dtype) {
+
+        switch (dtype) {
+            case FLOAT64: {
+                sparse_gemv_parallel<double>(
+                    row_pointers,
+                    column_indices,
+                    static_cast<const double *>(values),
+                    static_cast<const double *>(vector),
+                    static_cast<double *>(dest),
+                    *static_cast<const double *>(alpha),
+                    *static_cast<const double *>(beta),
+                    rows);
+                return;
+            }
+            case FLOAT32: {
+                sparse_gemv_parallel<float>(
+                    row_pointers,
+                    column_indices,
+                    static_cast<const float *>(values),
+                    static_cast<const float *>(vector),
+                    static_cast<float *>(dest),
+                    *static_cast<const float *>(alpha),
+                    *static_cast<const float *>(beta),
+                    rows);
+                return;
+            }
+            case INT8: {
+                sparse_gemv_parallel<int8_t>(
+                    row_pointers,
+                    column_indices,
+                    static_cast<const int8_t *>(values),
+                    static_cast<const int8_t *>(vector),
+                    static_cast<int8_t *>(dest),
+                    *static_cast<const int8_t *>(alpha),
+                    *static_cast<const int8_t *>(beta),
+                    rows);
+                return;
+            }
+            case INT16: {
+                sparse_gemv_parallel<int16_t>(
+                    row_pointers,
+                    column_indices,
+                    static_cast<const int16_t *>(values),
+                    static_cast<const int16_t *>(vector),
+                    static_cast<int16_t *>(dest),
+                    *static_cast<const int16_t *>(alpha),
+                    *static_cast<const int16_t *>(beta),
+                    rows);
+                return;
+            }
+            case INT32: {
+                sparse_gemv_parallel<int32_t>(
+                    row_pointers,
+                    column_indices,
+                    static_cast<const int32_t *>(values),
+                    static_cast<const int32_t *>(vector),
+                    static_cast<int32_t *>(dest),
+                    *static_cast<const int32_t *>(alpha),
+                    *static_cast<const int32_t *>(beta),
+                    rows);
+                return;
+            }
+            case INT64: {
+                sparse_gemv_parallel<int64_t>(
+                    row_pointers,
+                    column_indices,
+                    static_cast<const int64_t *>(values),
+                    static_cast<const int64_t *>(vector),
+                    static_cast<int64_t *>(dest),
+                    *static_cast<const int64_t *>(alpha),
+                    *static_cast<const int64_t *>(beta),
+                    rows);
+                return;
+            }
+            case FLOAT16:
+            case BFLOAT16: {
+                throw std::runtime_error("sparse gemv is not supported on half precision storage");
+            }
+            case INVALID: {
+                throw std::runtime_error("cannot calculate sparse gemv on invalid type");
+            }
+        }
+    }
+
+    template<typename NumType>
+    static void dispatch_sparse_query_gemv(
+        const void *matrix,
+        const int64_t *indices,
+        const void *values,
+        void *dest,
+        const void *alpha,
+        const void *beta,
+        size_t const rows,
+        size_t const columns,
+        size_t const leading_dimension,
+        size_t const nonzeros,
+        bool const transpose) {
+        if (transpose) {
+            sparse_query_gemv_transposed_parallel<NumType>(
+                static_cast<const NumType *>(matrix),
+                indices,
+                static_cast<const NumType *>(values),
+                static_cast<NumType *>(dest),
+                *static_cast<const NumType *>(alpha),
+                *static_cast<const NumType *>(beta),
+                columns,
+                leading_dimension,
+                nonzeros);
+            return;
+        }
+
+        sparse_query_gemv_parallel<NumType>(
+            static_cast<const NumType *>(matrix),
+            indices,
+            static_cast<const NumType *>(values),
+            static_cast<NumType *>(dest),
+            *static_cast<const NumType *>(alpha),
+            *static_cast<const NumType *>(beta),
+            rows,
+            leading_dimension,
+            nonzeros);
+    }
+
+    void StandardMath::sparse_query_gemv(
+        const void *matrix,
+        const int64_t *indices,
+        const void *values,
+        void *dest,
+        const void *alpha,
+        const void *beta,
+        size_t const rows,
+        size_t const columns,
+        size_t const leading_dimension,
+        size_t const nonzeros,
+        bool const transpose,
+        Dtype const dtype) {
+
+        switch (dtype) {
+            case FLOAT64: {
+                dispatch_sparse_query_gemv<double>(matrix, indices, values, dest, alpha, beta, rows, columns, leading_dimension,
+                    nonzeros, transpose);
+                return;
+            }
+            case FLOAT32: {
+                dispatch_sparse_query_gemv<float>(matrix, indices, values, dest, alpha, beta, rows, columns, leading_dimension,
+                    nonzeros, transpose);
+                return;
+            }
+            case INT8: {
+                dispatch_sparse_query_gemv<int8_t>(matrix, indices, values, dest, alpha, beta, rows, columns, leading_dimension,
+                    nonzeros, transpose);
+                return;
+            }
+            case INT16: {
+                dispatch_sparse_query_gemv<int16_t>(matrix, indices, values, dest, alpha, beta, rows, columns, leading_dimension,
+                    nonzeros, transpose);
+                return;
+            }
+            case INT32: {
+                dispatch_sparse_query_gemv<int32_t>(matrix, indices, values, dest, alpha, beta, rows, columns, leading_dimension,
+                    nonzeros, transpose);
+                return;
+            }
+            case INT64: {
+                dispatch_sparse_query_gemv<int64_t>(matrix, indices, values, dest, alpha, beta, rows, columns, leading_dimension,
+                    nonzeros, transpose);
+                return;
+            }
+            case FLOAT16:
+            case BFLOAT16: {
+                throw std::runtime_error("sparse query gemv is not supported on half precision storage");
+            }
+            case INVALID: {
+                throw std::runtime_error("cannot calculate sparse query gemv on invalid type");
+            }
+        }
+    }
+
+    void StandardMath::dot(const void *x, const void *y, void *dest, size_t const length, Dtype const dtype) {
+        switch (dtype) {
+            case FLOAT64: {
+                *static_cast<double *>(dest) = dot_parallel(
+                    static_cast<const double *>(x), static_cast<const double *>(y), length);
+                return;
+            }
+            case FLOAT32: {
+                *static_cast<float *>(dest) = dot_parallel(
+                    static_cast<const float *>(x), static_cast<const float *>(y), length);
+                return;
+            }
+            case INT8: {
+                *static_cast<int8_t *>(dest) = dot_parallel(
+                    static_cast<const int8_t *>(x), static_cast<const int8_t *>(y), length);
+                return;
+            }
+            case INT16: {
+                *static_cast<int16_t *>(dest) = dot_parallel(
+                    static_cast<const int16_t *>(x), static_cast<const int16_t *>(y), length);
+                return;
+            }
+            case INT32: {
+                *static_cast<int32_t *>(dest) = dot_parallel(
+                    static_cast<const int32_t *>(x), static_cast<const int32_t *>(y), length);
+                return;
+            }
+            case INT64: {
+                *static_cast<int64_t *>(dest) = dot_parallel(
+                    static_cast<const int64_t *>(x), static_cast<const int64_t *>(y), length);
+                return;
+            }
+            case FLOAT16: {
+                *static_cast<float *>(dest) = dot_parallel(
+                    static_cast<const float16 *>(x), static_cast<const float16 *>(y), length);
+                return;
+            }
+            case BFLOAT16: {
+                *static_cast<float *>(dest) = dot_parallel(
+                    static_cast<const bfloat16 *>(x), static_cast<const bfloat16 *>(y), length);
+                return;
+            }
+            case INVALID: {
+                throw std::runtime_error("cannot calculate dot on invalid type");
+            }
+        }
+    }
+
+    void StandardMath::axpy(const void *alpha, const void *x, void *y, size_t const length, Dtype const dtype) {
+        switch (dtype) {
+            case FLOAT64: {
+                axpy_parallel(
+                    *static_cast<const double *>(alpha), static_cast<const double *>(x), static_cast<double *>(y), length);
+                return;
+            }
+            case FLOAT32: {
+                axpy_parallel(
+                    *static_cast<const float *>(alpha), static_cast<const float *>(x), static_cast<float *>(y), length);
+                return;
+            }
+            case INT8: {
+                axpy_parallel(
+                    *static_cast<const int8_t *>(alpha), static_cast<const int8_t *>(x), static_cast<int8_t *>(y), length);
+                return;
+            }
+            case INT16: {
+                axpy_parallel(
+                    *static_cast<const int16_t *>(alpha), static_cast<const int16_t *>(x), static_cast<int16_t *>(y), length);
+                return;
+            }
+            case INT32: {
+                axpy_parallel(
+                    *static_cast<const int32_t *>(alpha), static_cast<const int32_t *>(x), static_cast<int32_t *>(y), length);
+                return;
+            }
+            case INT64: {
+                axpy_parallel(
+                    *static_cast<const int64_t *>(alpha), static_cast<const int64_t *>(x), static_cast<int64_t *>(y), length);
+                return;
+            }
+            case FLOAT16: {
+                axpy_parallel(
+                    *static_cast<const float *>(alpha), static_cast<const float16 *>(x), static_cast<float16 *>(y), length);
+                return;
+            }
+            case BFLOAT16: {
+                axpy_parallel(
+                    *static_cast<const float *>(alpha), static_cast<const bfloat16 *>(x), static_cast<bfloat16 *>(y), length);
+                return;
+            }
+            case INVALID: {
+                throw std::runtime_error("cannot calculate axpy on invalid type");
+            }
+        }
+    }
+
+    void StandardMath::scal(const void *alpha, void *x, size_t const length, Dtype const dtype) {
+        switch (dtype) {
+            case FLOAT64: {
+                scal_parallel(*static_cast<const double *>(alpha), static_cast<double *>(x), length);
+                return;
+            }
+            case FLOAT32: {
+                scal_parallel(*static_cast<const float *>(alpha), static_cast<float *>(x), length);
+                return;
+            }
+            case INT8: {
+                scal_parallel(*static_cast<const int8_t *>(alpha), static_cast<int8_t *>(x), length);
+                return;
+            }
+            case INT16: {
+                scal_parallel(*static_cast<const int16_t *>(alpha), static_cast<int16_t *>(x), length);
+                return;
+            }
+            case INT32: {
+                scal_parallel(*static_cast<const int32_t *>(alpha), static_cast<int32_t *>(x), length);
+                return;
+            }
+            case INT64: {
+                scal_parallel(*static_cast<const int64_t *>(alpha), static_cast<int64_t *>(x), length);
+                return;
+            }
+            case FLOAT16: {
+                scal_parallel(*static_cast<const float *>(alpha), static_cast<float16 *>(x), length);
+                return;
+            }
+            case BFLOAT16: {
+                scal_parallel(*static_cast<const float *>(alpha), static_cast<bfloat16 *>(x), length);
+                return;
+            }
+            case INVALID: {
+                throw std::runtime_error("cannot calculate scal on invalid type");
+            }
+        }
+    }
+
+    void StandardMath::nrm2(const void *x, void *dest, size_t const length, Dtype const dtype) {
+        switch (dtype) {
+            case FLOAT64: {
+                *static_cast<double *>(dest) = nrm2_parallel(static_cast<const double *>(x), length);
+                return;
+            }
+            case FLOAT32: {
+                *static_cast<float *>(dest) = nrm2_parallel(static_cast<const float *>(x), length);
+                return;
+            }
+            case INT8: {
+                *static_cast<int8_t *>(dest) = nrm2_parallel(static_cast<const int8_t *>(x), length);
+                return;
+            }
+            case INT16: {
+                *static_cast<int16_t *>(dest) = nrm2_parallel(static_cast<const int16_t *>(x), length);
+                return;
+            }
+            case INT32: {
+                *static_cast<int32_t *>(dest) = nrm2_parallel(static_cast<const int32_t *>(x), length);
+                return;
+            }
+            case INT64: {
+                *static_cast<int64_t *>(dest) = nrm2_parallel(static_cast<const int64_t *>(x), length);
+                return;
+            }
+            case FLOAT16: {
+                *static_cast<float *>(dest) = nrm2_parallel(static_cast<const float16 *>(x), length);
+                return;
+            }
+            case BFLOAT16: {
+                *static_cast<float *>(dest) = nrm2_parallel(static_cast<const bfloat16 *>(x), length);
+                return;
+            }
+            case INVALID: {
+                throw std::runtime_error("cannot calculate nrm2 on invalid type");
+            }
+        }
+    }
+
+    void StandardMath::asum(const void *x, void *dest, size_t const length, Dtype const dtype) {
+        switch (dtype) {
+            case FLOAT64: {
+                *static_cast<double *>(dest) = asum_parallel(static_cast<const double *>(x), length);
+                return;
+            }
+            case FLOAT32: {
+                *static_cast<float *>(dest) = asum_parallel(static_cast<const float *>(x), length);
+                return;
+            }
+            case INT8: {
+                *static_cast<int8_t *>(dest) = asum_parallel(static_cast<const int8_t *>(x), length);
+                return;
+            }
+            case INT16: {
+                *static_cast<int16_t *>(dest) = asum_parallel(static_cast<const int16_t *>(x), length);
+                return;
+            }
+            case INT32: {
+                *static_cast<int32_t *>(dest) = asum_parallel(static_cast<const int32_t *>(x), length);
+                return;
+            }
+            case INT64: {
+                *static_cast<int64_t *>(dest) = asum_parallel(static_cast<const int64_t *>(x), length);
+                return;
+            }
+            case FLOAT16: {
+                *static_cast<float *>(dest) = asum_parallel(static_cast<const float16 *>(x), length);
+                return;
+            }
+            case BFLOAT16: {
+                *static_cast<float *>(dest) = asum_parallel(static_cast<const bfloat16 *>(x), length);
+                return;
+            }
+            case INVALID: {
+                throw std::runtime_error("cannot calculate asum on invalid type");
+            }
+        }
+    }
+
+    size_t StandardMath::iamax(const void *x, size_t const length, Dtype const dtype) {
+        switch (dtype) {
+            case FLOAT64: {
+                return iamax_parallel(static_cast<const double *>(x), length);
+            }
+            case FLOAT32: {
+                return iamax_parallel(static_cast<const float *>(x), length);
+            }
+            case INT8: {
+                return iamax_parallel(static_cast<const int8_t *>(x), length);
+            }
+            case INT16: {
+                return iamax_parallel(static_cast<const int16_t *>(x), length);
+            }
+            case INT32: {
+                return iamax_parallel(static_cast<const int32_t *>(x), length);
+            }
+            case INT64: {
+                return iamax_parallel(static_cast<const int64_t *>(x), length);
+            }
+            case FLOAT16: {
+                return iamax_parallel(static_cast<const float16 *>(x), length);
+            }
+            case BFLOAT16: {
+                return iamax_parallel(static_cast<const bfloat16 *>(x), length);
+            }
+            case INVALID: {
+                throw std::runtime_error("cannot calculate iamax on invalid type");
+            }
+        }
+
+        return 0;
+    }
+
+    void StandardMath::reduce_rows(
+        const void *matrix,
+        void *dest,
+        size_t const rows,
+        size_t const columns,
+        size_t const leading_dimension,
+        Reduction const reduction,
+        Dtype const dtype) {
+        switch (dtype) {
+            case FLOAT64: {
+                reduce_rows_parallel<double>(
+                    static_cast<const double *>(matrix), dest, rows, columns, leading_dimension, reduction);
+                return;
+            }
+            case FLOAT32: {
+                reduce_rows_parallel<float>(
+                    static_cast<const float *>(matrix), dest, rows, columns, leading_dimension, reduction);
+                return;
+            }
+            case INT8: {
+                reduce_rows_parallel<int8_t>(
+                    static_cast<const int8_t *>(matrix), dest, rows, columns, leading_dimension, reduction);
+                return;
+            }
+            case INT16: {
+                reduce_rows_parallel<int16_t>(
+                    static_cast<const int16_t *>(matrix), dest, rows, columns, leading_dimension, reduction);
+                return;
+            }
+            case INT32: {
+                reduce_rows_parallel<int32_t>(
+                    static_cast<const int32_t *>(matrix), dest, rows, columns, leading_dimension, reduction);
+                return;
+            }
+            case INT64: {
+                reduce_rows_parallel<int64_t>(
+                    static_cast<const int64_t *>(matrix), dest, rows, columns, leading_dimension, reduction);
+                return;
+            }
+            case FLOAT16:
+            case BFLOAT16: {
+                throw std::runtime_error("row reductions is not supported on half precision storage");
+            }
+            case INVALID: {
+                throw std::runtime_error("cannot calculate row reductions on invalid type");
+            }
+        }
+    }
+
+    void StandardMath::reduce_columns(
+        const void *matrix,
+        void *dest,
+        size_t const rows,
+        size_t const columns,
+        size_t const leading_dimension,
+        Reduction const reduction,
+        Dtype const dtype) {
+        switch (dtype) {
+            case FLOAT64: {
+                reduce_columns_parallel<double>(
+                    static_cast<const double *>(matrix), dest, rows, columns, leading_dimension, reduction);
+                return;
+            }
+            case FLOAT32: {
+                reduce_columns_parallel<float>(
+                    static_cast<const float *>(matrix), dest, rows, columns, leading_dimension, reduction);
+                return;
+            }
+            case INT8: {
+                reduce_columns_parallel<int8_t>(
+                    static_cast<const int8_t *>(matrix), dest, rows, columns, leading_dimension, reduction);
+                return;
+            }
+            case INT16: {
+                reduce_columns_parallel<int16_t>(
+                    static_cast<const int16_t *>(matrix), dest, rows, columns, leading_dimension, reduction);
+                return;
+            }
+            case INT32: {
+                reduce_columns_parallel<int32_t>(
+                    static_cast<const int32_t *>(matrix), dest, rows, columns, leading_dimension, reduction);
+                return;
+            }
+            case INT64: {
+                reduce_columns_parallel<int64_t>(
+                    static_cast<const int64_t *>(matrix), dest, rows, columns, leading_dimension, reduction);
+                return;
+            }
+            case FLOAT16:
+            case BFLOAT16: {
+                throw std::runtime_error("column reductions is not supported on half precision storage");
+            }
+            case INVALID: {
+                throw std::runtime_error("cannot calculate column reductions on invalid type");
+            }
+        }
+    }
+
+    void StandardMath::first_touch(void *dest, size_t const rows, size_t const row_bytes, Dtype const dtype) {
+        // the same work measure as the gemv that later streams the buffer, so both run on the same threads
+        set_num_threads(rows * (row_bytes / dtype_to_bytes(dtype)));
+        const auto bytes = static_cast<char *>(dest);
+        size_t start;
 
-        if (!set) {
-#ifdef NUM_THREADS
-            omp_set_num_threads(NUM_THREADS);
-#else
-            omp_set_num_threads(9);
-#endif
+#pragma omp parallel for default(none) shared(bytes, rows, row_bytes) private(start) schedule(static)
+        for (start = 0; start < rows; start += DEFAULT_BLOCK_ROWS) {
+            size_t const block = std::min<size_t>(DEFAULT_BLOCK_ROWS, rows - start);
+            std::memset(bytes + start * row_bytes, 0, block * row_bytes);
         }
     }
 
@@ -29,6 +680,8 @@ namespace cobraml::core {
         const void *beta,
         size_t const rows,
         size_t const columns,
+        size_t const leading_dimension,
+        bool const transpose,
         Dtype const dtype) {
 
         switch (dtype) {
@@ -38,8 +691,15 @@ namespace cobraml::core {
                 const auto casted_vec = static_cast<const double *>(vector);
                 const auto casted_alpha = static_cast<const double *>(alpha);
                 const auto casted_beta = static_cast<const double *>(beta);
+
+                if (transpose) {
+                    gemv_transposed_parallel(
+                        casted_mat, casted_vec, casted_dest, *casted_alpha, *casted_beta, rows, columns, leading_dimension);
+                    return;
+                }
+
                 benchmarked_gemv<double>(
-                    casted_mat, casted_vec, casted_dest, *casted_alpha, *casted_beta, rows, columns);
+                    casted_mat, casted_vec, casted_dest, *casted_alpha, *casted_beta, rows, columns, leading_dimension);
                 return;
             }
             case FLOAT32: {
@@ -48,8 +708,15 @@ namespace cobraml::core {
                 const auto casted_vec = static_cast<const float *>(vector);
                 const auto casted_alpha = static_cast<const float *>(alpha);
                 const auto casted_beta = static_cast<const float *>(beta);
+
+                if (transpose) {
+                    gemv_transposed_parallel(
+                        casted_mat, casted_vec, casted_dest, *casted_alpha, *casted_beta, rows, columns, leading_dimension);
+                    return;
+                }
+
                 benchmarked_gemv<float>(
-                    casted_mat, casted_vec, casted_dest, *casted_alpha, *casted_beta, rows, columns);
+                    casted_mat, casted_vec, casted_dest, *casted_alpha, *casted_beta, rows, columns, leading_dimension);
                 return;
             }
             case INT8: {
@@ -58,8 +725,15 @@ namespace cobraml::core {
                 const auto casted_vec = static_cast<const int8_t *>(vector);
                 const auto casted_alpha = static_cast<const int8_t *>(alpha);
                 const auto casted_beta = static_cast<const int8_t *>(beta);
+
+                if (transpose) {
+                    gemv_transposed_parallel(
+                        casted_mat, casted_vec, casted_dest, *casted_alpha, *casted_beta, rows, columns, leading_dimension);
+                    return;
+                }
+
                 benchmarked_gemv<int8_t>(
-                    casted_mat, casted_vec, casted_dest, *casted_alpha, *casted_beta, rows, columns);
+                    casted_mat, casted_vec, casted_dest, *casted_alpha, *casted_beta, rows, columns, leading_dimension);
                 return;
             }
             case INT16: {
@@ -68,8 +742,15 @@ namespace cobraml::core {
                 const auto casted_vec = static_cast<const int16_t *>(vector);
                 const auto casted_alpha = static_cast<const int16_t *>(alpha);
                 const auto casted_beta = static_cast<const int16_t *>(beta);
+
+                if (transpose) {
+                    gemv_transposed_parallel(
+                        casted_mat, casted_vec, casted_dest, *casted_alpha, *casted_beta, rows, columns, leading_dimension);
+                    return;
+                }
+
                 benchmarked_gemv<int16_t>(
-                    casted_mat, casted_vec, casted_dest, *casted_alpha, *casted_beta, rows, columns);
+                    casted_mat, casted_vec, casted_dest, *casted_alpha, *casted_beta, rows, columns, leading_dimension);
                 return;
             }
             case INT32: {
@@ -78,8 +759,15 @@ namespace cobraml::core {
                 const auto casted_vec = static_cast<const int32_t *>(vector);
                 const auto casted_alpha = static_cast<const int32_t *>(alpha);
                 const auto casted_beta = static_cast<const int32_t *>(beta);
+
+                if (transpose) {
+                    gemv_transposed_parallel(
+                        casted_mat, casted_vec, casted_dest, *casted_alpha, *casted_beta, rows, columns, leading_dimension);
+                    return;
+                }
+
                 benchmarked_gemv<int32_t>(
-                    casted_mat, casted_vec, casted_dest, *casted_alpha, *casted_beta, rows, columns);
+                    casted_mat, casted_vec, casted_dest, *casted_alpha, *casted_beta, rows, columns, leading_dimension);
                 return;
             }
             case INT64: {
@@ -88,8 +776,49 @@ namespace cobraml::core {
                 const auto casted_vec = static_cast<const int64_t *>(vector);
                 const auto casted_alpha = static_cast<const int64_t *>(alpha);
                 const auto casted_beta = static_cast<const int64_t *>(beta);
+
+                if (transpose) {
+                    gemv_transposed_parallel(
+                        casted_mat, casted_vec, casted_dest, *casted_alpha, *casted_beta, rows, columns, leading_dimension);
+                    return;
+                }
+
                 benchmarked_gemv<int64_t>(
-                    casted_mat, casted_vec, casted_dest, *casted_alpha, *casted_beta, rows, columns);
+                    casted_mat, casted_vec, casted_dest, *casted_alpha, *casted_beta, rows, columns, leading_dimension);
+                return;
+            }
+            case FLOAT16: {
+                const auto casted_dest = static_cast<float *>(dest);
+                const auto casted_mat = static_cast<const float16 *>(matrix);
+                const auto casted_vec = static_cast<const float *>(vector);
+                const auto casted_alpha = static_cast<const float *>(alpha);
+                const auto casted_beta = static_cast<const float *>(beta);
+
+                if (transpose) {
+                    gemv_transposed_parallel(
+                        casted_mat, casted_vec, casted_dest, *casted_alpha, *casted_beta, rows, columns, leading_dimension);
+                    return;
+                }
+
+                gemv_half_parallel<float16>(
+                    casted_mat, casted_vec, casted_dest, *casted_alpha, *casted_beta, rows, columns, leading_dimension);
+                return;
+            }
+            case BFLOAT16: {
+                const auto casted_dest = static_cast<float *>(dest);
+                const auto casted_mat = static_cast<const bfloat16 *>(matrix);
+                const auto casted_vec = static_cast<const float *>(vector);
+                const auto casted_alpha = static_cast<const float *>(alpha);
+                const auto casted_beta = static_cast<const float *>(beta);
+
+                if (transpose) {
+                    gemv_transposed_parallel(
+                        casted_mat, casted_vec, casted_dest, *casted_alpha, *casted_beta, rows, columns, leading_dimension);
+                    return;
+                }
+
+                gemv_half_parallel<bfloat16>(
+                    casted_mat, casted_vec, casted_dest, *casted_alpha, *casted_beta, rows, columns, leading_dimension);
                 return;
             }
             case INVALID: {
@@ -97,4 +826,326 @@ namespace cobraml::core {
             }
         }
     }
+
+    void StandardMath::gemm(
+        const void *matrix_a,
+        const void *matrix_b,
+        void *dest,
+        const void *alpha,
+        const void *beta,
+        size_t const rows,
+        size_t const shared,
+        size_t const columns,
+        Dtype const dtype) {
+
+        switch (dtype) {
+            case FLOAT64: {
+                const auto casted_dest = static_cast<double *>(dest);
+                const auto casted_a = static_cast<const double *>(matrix_a);
+                const auto casted_b = static_cast<const double *>(matrix_b);
+                const auto casted_alpha = static_cast<const double *>(alpha);
+                const auto casted_beta = static_cast<const double *>(beta);
+                benchmarked_gemm<double>(
+                    casted_a, casted_b, casted_dest, *casted_alpha, *casted_beta, rows, shared, columns);
+                return;
+            }
+            case FLOAT32: {
+                const auto casted_dest = static_cast<float *>(dest);
+                const auto casted_a = static_cast<const float *>(matrix_a);
+                const auto casted_b = static_cast<const float *>(matrix_b);
+                const auto casted_alpha = static_cast<const float *>(alpha);
+                const auto casted_beta = static_cast<const float *>(beta);
+                benchmarked_gemm<float>(
+                    casted_a, casted_b, casted_dest, *casted_alpha, *casted_beta, rows, shared, columns);
+                return;
+            }
+            case INT8: {
+                const auto casted_dest = static_cast<int8_t *>(dest);
+                const auto casted_a = static_cast<const int8_t *>(matrix_a);
+                const auto casted_b = static_cast<const int8_t *>(matrix_b);
+                const auto casted_alpha = static_cast<const int8_t *>(alpha);
+                const auto casted_beta = static_cast<const int8_t *>(beta);
+                benchmarked_gemm<int8_t>(
+                    casted_a, casted_b, casted_dest, *casted_alpha, *casted_beta, rows, shared, columns);
+                return;
+            }
+            case INT16: {
+                const auto casted_dest = static_cast<int16_t *>(dest);
+                const auto casted_a = static_cast<const int16_t *>(matrix_a);
+                const auto casted_b = static_cast<const int16_t *>(matrix_b);
+                const auto casted_alpha = static_cast<const int16_t *>(alpha);
+                const auto casted_beta = static_cast<const int16_t *>(beta);
+                benchmarked_gemm<int16_t>(
+                    casted_a, casted_b, casted_dest, *casted_alpha, *casted_beta, rows, shared, columns);
+                return;
+            }
+            case INT32: {
+                const auto casted_dest = static_cast<int32_t *>(dest);
+                const auto casted_a = static_cast<const int32_t *>(matrix_a);
+                const auto casted_b = static_cast<const int32_t *>(matrix_b);
+                const auto casted_alpha = static_cast<const int32_t *>(alpha);
+                const auto casted_beta = static_cast<const int32_t *>(beta);
+                benchmarked_gemm<int32_t>(
+                    casted_a, casted_b, casted_dest, *casted_alpha, *casted_beta, rows, shared, columns);
+                return;
+            }
+            case INT64: {
+                const auto casted_dest = static_cast<int64_t *>(dest);
+                const auto casted_a = static_cast<const int64_t *>(matrix_a);
+                const auto casted_b = static_cast<const int64_t *>(matrix_b);
+                const auto casted_alpha = static_cast<const int64_t *>(alpha);
+                const auto casted_beta = static_cast<const int64_t *>(beta);
+                benchmarked_gemm<int64_t>(
+                    casted_a, casted_b, casted_dest, *casted_alpha, *casted_beta, rows, shared, columns);
+                return;
+            }
+            case FLOAT16:
+            case BFLOAT16: {
+                throw std::runtime_error("gemm is not supported on half precision storage");
+            }
+            case INVALID: {
+                throw std::runtime_error("cannot calculate gemm on invalid type");
+            }
+        }
+    }
+
+    void StandardMath::gemv_batched(
+        const void *matrix,
+        const void *queries,
+        void *dest,
+        const void *alpha,
+        const void *beta,
+        size_t const rows,
+        size_t const columns,
+        size_t const query_count,
+        Dtype const dtype) {
+
+        switch (dtype) {
+            case FLOAT64: {
+                const auto casted_dest = static_cast<double *>(dest);
+                const auto casted_mat = static_cast<const double *>(matrix);
+                const auto casted_queries = static_cast<const double *>(queries);
+                const auto casted_alpha = static_cast<const double *>(alpha);
+                const auto casted_beta = static_cast<const double *>(beta);
+                gemv_batched_parallel<double>(
+                    casted_mat, casted_queries, casted_dest, *casted_alpha, *casted_beta, rows, columns, query_count);
+                return;
+            }
+            case FLOAT32: {
+                const auto casted_dest = static_cast<float *>(dest);
+                const auto casted_mat = static_cast<const float *>(matrix);
+                const auto casted_queries = static_cast<const float *>(queries);
+                const auto casted_alpha = static_cast<const float *>(alpha);
+                const auto casted_beta = static_cast<const float *>(beta);
+                gemv_batched_parallel<float>(
+                    casted_mat, casted_queries, casted_dest, *casted_alpha, *casted_beta, rows, columns, query_count);
+                return;
+            }
+            case INT8: {
+                const auto casted_dest = static_cast<int8_t *>(dest);
+                const auto casted_mat = static_cast<const int8_t *>(matrix);
+                const auto casted_queries = static_cast<const int8_t *>(queries);
+                const auto casted_alpha = static_cast<const int8_t *>(alpha);
+                const auto casted_beta = static_cast<const int8_t *>(beta);
+                gemv_batched_parallel<int8_t>(
+                    casted_mat, casted_queries, casted_dest, *casted_alpha, *casted_beta, rows, columns, query_count);
+                return;
+            }
+            case INT16: {
+                const auto casted_dest = static_cast<int16_t *>(dest);
+                const auto casted_mat = static_cast<const int16_t *>(matrix);
+                const auto casted_queries = static_cast<const int16_t *>(queries);
+                const auto casted_alpha = static_cast<const int16_t *>(alpha);
+                const auto casted_beta = static_cast<const int16_t *>(beta);
+                gemv_batched_parallel<int16_t>(
+                    casted_mat, casted_queries, casted_dest, *casted_alpha, *casted_beta, rows, columns, query_count);
+                return;
+            }
+            case INT32: {
+                const auto casted_dest = static_cast<int32_t *>(dest);
+                const auto casted_mat = static_cast<const int32_t *>(matrix);
+                const auto casted_queries = static_cast<const int32_t *>(queries);
+                const auto casted_alpha = static_cast<const int32_t *>(alpha);
+                const auto casted_beta = static_cast<const int32_t *>(beta);
+                gemv_batched_parallel<int32_t>(
+                    casted_mat, casted_queries, casted_dest, *casted_alpha, *casted_beta, rows, columns, query_count);
+                return;
+            }
+            case INT64: {
+                const auto casted_dest = static_cast<int64_t *>(dest);
+                const auto casted_mat = static_cast<const int64_t *>(matrix);
+                const auto casted_queries = static_cast<const int64_t *>(queries);
+                const auto casted_alpha = static_cast<const int64_t *>(alpha);
+                const auto casted_beta = static_cast<const int64_t *>(beta);
+                gemv_batched_parallel<int64_t>(
+                    casted_mat, casted_queries, casted_dest, *casted_alpha, *casted_beta, rows, columns, query_count);
+                return;
+            }
+            case FLOAT16:
+            case BFLOAT16: {
+                throw std::runtime_error("batched gemv is not supported on half precision storage");
+            }
+            case INVALID: {
+                throw std::runtime_error("cannot calculate batched gemv on invalid type");
+            }
+        }
+    }
+
+    void StandardMath::gemv_topk(
+        const void *matrix,
+        const void *vector,
+        int64_t *indices,
+        void *scores,
+        const void *alpha,
+        size_t const rows,
+        size_t const columns,
+        size_t const k,
+        Dtype const dtype) {
+
+        switch (dtype) {
+            case FLOAT64: {
+                const auto casted_scores = static_cast<double *>(scores);
+                const auto casted_mat = static_cast<const double *>(matrix);
+                const auto casted_vec = static_cast<const double *>(vector);
+                const auto casted_alpha = static_cast<const double *>(alpha);
+                gemv_topk_parallel<double>(
+                    casted_mat, casted_vec, indices, casted_scores, *casted_alpha, rows, columns, k);
+                return;
+            }
+            case FLOAT32: {
+                const auto casted_scores = static_cast<float *>(scores);
+                const auto casted_mat = static_cast<const float *>(matrix);
+                const auto casted_vec = static_cast<const float *>(vector);
+                const auto casted_alpha = static_cast<const float *>(alpha);
+                gemv_topk_parallel<float>(
+                    casted_mat, casted_vec, indices, casted_scores, *casted_alpha, rows, columns, k);
+                return;
+            }
+            case INT8: {
+                const auto casted_scores = static_cast<int8_t *>(scores);
+                const auto casted_mat = static_cast<const int8_t *>(matrix);
+                const auto casted_vec = static_cast<const int8_t *>(vector);
+                const auto casted_alpha = static_cast<const int8_t *>(alpha);
+                gemv_topk_parallel<int8_t>(
+                    casted_mat, casted_vec, indices, casted_scores, *casted_alpha, rows, columns, k);
+                return;
+            }
+            case INT16: {
+                const auto casted_scores = static_cast<int16_t *>(scores);
+                const auto casted_mat = static_cast<const int16_t *>(matrix);
+                const auto casted_vec = static_cast<const int16_t *>(vector);
+                const auto casted_alpha = static_cast<const int16_t *>(alpha);
+                gemv_topk_parallel<int16_t>(
+                    casted_mat, casted_vec, indices, casted_scores, *casted_alpha, rows, columns, k);
+                return;
+            }
+            case INT32: {
+                const auto casted_scores = static_cast<int32_t *>(scores);
+                const auto casted_mat = static_cast<const int32_t *>(matrix);
+                const auto casted_vec = static_cast<const int32_t *>(vector);
+                const auto casted_alpha = static_cast<const int32_t *>(alpha);
+                gemv_topk_parallel<int32_t>(
+                    casted_mat, casted_vec, indices, casted_scores, *casted_alpha, rows, columns, k);
+                return;
+            }
+            case INT64: {
+                const auto casted_scores = static_cast<int64_t *>(scores);
+                const auto casted_mat = static_cast<const int64_t *>(matrix);
+                const auto casted_vec = static_cast<const int64_t *>(vector);
+                const auto casted_alpha = static_cast<const int64_t *>(alpha);
+                gemv_topk_parallel<int64_t>(
+                    casted_mat, casted_vec, indices, casted_scores, *casted_alpha, rows, columns, k);
+                return;
+            }
+            case FLOAT16:
+            case BFLOAT16: {
+                throw std::runtime_error("top k gemv is not supported on half precision storage");
+            }
+            case INVALID: {
+                throw std::runtime_error("cannot calculate top k gemv on invalid type");
+            }
+        }
+    }
+
+    void StandardMath::row_norms(
+        const void *matrix,
+        void *dest,
+        size_t const rows,
+        size_t const columns,
+        Dtype const dtype) {
+
+        switch (dtype) {
+            case FLOAT64: {
+                const auto casted_dest = static_cast<double *>(dest);
+                const auto casted_mat = static_cast<const double *>(matrix);
+                row_norms_parallel<double>(casted_mat, casted_dest, rows, columns);
+                return;
+            }
+            case FLOAT32: {
+                const auto casted_dest = static_cast<float *>(dest);
+                const auto casted_mat = static_cast<const float *>(matrix);
+                row_norms_parallel<float>(casted_mat, casted_dest, rows, columns);
+                return;
+            }
+            case INT8:
+            case INT16:
+            case INT32:
+            case FLOAT16:
+            case BFLOAT16: {
+                throw std::runtime_error("row norms is not supported on half precision storage");
+            }
+            case INT64:
+            case INVALID: {
+                throw std::runtime_error("row norms require a floating point type");
+            }
+        }
+    }
+
+    void StandardMath::gemv_cosine(
+        const void *matrix,
+        const void *vector,
+        const void *norms,
+        void *dest,
+        const void *alpha,
+        const void *beta,
+        size_t const rows,
+        size_t const columns,
+        Dtype const dtype) {
+
+        switch (dtype) {
+            case FLOAT64: {
+                const auto casted_dest = static_cast<double *>(dest);
+                const auto casted_mat = static_cast<const double *>(matrix);
+                const auto casted_vec = static_cast<const double *>(vector);
+                const auto casted_norms = static_cast<const double *>(norms);
+                const auto casted_alpha = static_cast<const double *>(alpha);
+                const auto casted_beta = static_cast<const double *>(beta);
+                gemv_cosine_parallel<double>(
+                    casted_mat, casted_vec, casted_norms, casted_dest, *casted_alpha, *casted_beta, rows, columns);
+                return;
+            }
+            case FLOAT32: {
+                const auto casted_dest = static_cast<float *>(dest);
+                const auto casted_mat = static_cast<const float *>(matrix);
+                const auto casted_vec = static_cast<const float *>(vector);
+                const auto casted_norms = static_cast<const float *>(norms);
+                const auto casted_alpha = static_cast<const float *>(alpha);
+                const auto casted_beta = static_cast<const float *>(beta);
+                gemv_cosine_parallel<float>(
+                    casted_mat, casted_vec, casted_norms, casted_dest, *casted_alpha, *casted_beta, rows, columns);
+                return;
+            }
+            case INT8:
+            case INT16:
+            case INT32:
+            case FLOAT16:
+            case BFLOAT16: {
+                throw std::runtime_error("cosine similarity is not supported on half precision storage");
+            }
+            case INT64:
+            case INVALID: {
+                throw std::runtime_error("cosine similarity requires a floating point type");
+            }
+        }
+    }
 }
@@ -5,125 +5,1431 @@
 #ifndef STANDARD_MATH_H
 #define STANDARD_MATH_H
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
 #include <iostream>
+#include <limits>
+#include <vector>
+#include <omp.h>
 #include "../math_dis.h"
+#include "gemv_tuner.h"
 
 namespace cobraml::core {
-    void set_num_threads();
+    /**
+     * sets the OpenMP thread count of the next parallel region, kernels whose work falls below the
+     * parallel threshold run on the calling thread alone
+     *
+     * @param work the number of elements or multiply adds the kernel performs
+     */
+    void set_num_threads(size_t work);
+
+    /**
+     * symmetric int8 quantization of a query vector, q = round(x / scale)
+     *
+     * @param vector the FLOAT32 vector
+     * @param dest receives the quantized values
+     * @param columns the length of the vector
+     * @param sum receives the sum of the quantized values
+     * @return the scale
+     */
+    float quantize_vector(const float *vector, int8_t *dest, size_t columns, int32_t &sum);
+
+    /**
+     * the epilogue of the gemv style kernels, y = αp + βy. y is not read when β is 0, so it may start out
+     * uninitialized
+     */
+    template<typename NumType, typename PartialType>
+    void scale_store(NumType &dest, const PartialType partial, const NumType alpha, const NumType beta) {
+        if (beta == 0) {
+            dest = static_cast<NumType>(partial * alpha);
+            return;
+        }
+
+        dest = static_cast<NumType>(dest * beta + partial * alpha);
+    }
+
+    template<typename NumType>
+    void gemv_naive(
+        const NumType *matrix,
+        const NumType *vector,
+        NumType *dest,
+        const NumType alpha,
+        const NumType beta,
+        const size_t rows,
+        const size_t columns,
+        const size_t leading_dimension) {
+        for (size_t start{0}; start < rows; ++start) {
+            NumType partial = 0;
+            for (size_t i = 0; i < columns; ++i) {
+                partial = static_cast<NumType>(partial + vector[i] * matrix[start * leading_dimension + i]);
+            }
+
+            scale_store(dest[start], partial, alpha, beta);
+        }
+    }
+
+    template<typename NumType>
+    void gemv_parallel(
+        const NumType *matrix,
+        const NumType *vector,
+        NumType *dest,
+        const NumType alpha,
+        const NumType beta,
+        const size_t rows,
+        const size_t columns,
+        const size_t leading_dimension) {
+        set_num_threads(rows * columns);
+        size_t start;
+
+#pragma omp parallel for default(none) shared(alpha, beta, matrix, vector, dest, rows, columns, leading_dimension) private(start) schedule(dynamic)
+        for (start = 0; start < rows; ++start) {
+            NumType partial = 0;
+
+            for (size_t i = 0; i < columns; ++i) {
+                partial += static_cast<NumType>(vector[i] * matrix[start * leading_dimension + i]);
+            }
+
+            scale_store(dest[start], partial, alpha, beta);
+        }
+    }
+
+    template<typename NumType>
+    void gemv_parallel_simd(
+        const NumType *matrix,
+        const NumType *vector,
+        NumType *dest,
+        const NumType alpha,
+        const NumType beta,
+        const size_t rows,
+        const size_t columns,
+        const size_t leading_dimension) {
+        set_num_threads(rows * columns);
+        size_t start;
+
+#pragma omp parallel for default(none) shared(alpha, beta, matrix, vector, dest, rows, columns, leading_dimension) private(start) schedule(dynamic)
+        for (start = 0; start < rows; ++start) {
+            NumType partial = 0;
+
+#pragma omp simd reduction(+:partial)
+            for (size_t i = 0; i < columns; ++i) {
+                partial += static_cast<NumType>(vector[i] * matrix[start * leading_dimension + i]);
+            }
+
+            scale_store(dest[start], partial, alpha, beta);
+        }
+    }
+
+    /**
+     * adds the dot products of BlockRows consecutive rows with x over the columns [tile_start, tile_end) to
+     * partials. The rows share every load of x and keep one accumulator each in a register, consecutive
+     * rows start leading_dimension elements apart.
+     */
+    template<typename NumType, size_t BlockRows>
+    void dot_rows(
+        const NumType *matrix,
+        const NumType *vector,
+        NumType *partials,
+        const size_t start_row,
+        const size_t leading_dimension,
+        const size_t tile_start,
+        const size_t tile_end) {
+        NumType acc[BlockRows]{};
+
+#pragma omp simd reduction(+:acc[:BlockRows])
+        for (size_t i = tile_start; i < tile_end; ++i) {
+            for (size_t r = 0; r < BlockRows; ++r) {
+                acc[r] += static_cast<NumType>(vector[i] * matrix[(start_row + r) * leading_dimension + i]);
+            }
+        }
+
+        for (size_t r = 0; r < BlockRows; ++r) {
+            partials[r] = static_cast<NumType>(partials[r] + acc[r]);
+        }
+    }
+
+// rows per block of the dynamically scheduled scoring kernels, top k and cosine
+#define SCORE_BLOCK_ROWS 2
+
+#define PREFETCH_LINES 4
+
+    /**
+     * Requests the first cache lines of the rows that follow a block. The hardware prefetcher follows
+     * each row once it is streaming, but has to rediscover the stream whenever a new row starts.
+     */
+    template<typename NumType>
+    void prefetch_rows(const NumType *matrix, const size_t start_row, const size_t count, const size_t columns,
+                       const size_t leading_dimension, const size_t offset) {
+        constexpr size_t line = 64 / sizeof(NumType);
+
+        for (size_t r = 0; r < count; ++r) {
+            const NumType *row = matrix + (start_row + r) * leading_dimension + offset;
+            for (size_t l = 0; l < PREFETCH_LINES && offset + l * line < columns; ++l) {
+                __builtin_prefetch(row + l * line, 0, 0);
+            }
+        }
+    }
+
+    /**
+     * Register blocked gemv. Rows are processed BlockRows at a time so every load of x feeds BlockRows
+     * multiply adds. A non zero TileBytes cuts the columns into tiles of that many bytes of x, each
+     * thread sweeps all of its rows per tile, so the tile of x stays in L1 however wide the matrix is;
+     * partial sums are carried between tiles in a scratch buffer.
+     *
+     * Blocks are scheduled statically so each thread streams the rows it placed through
+     * StandardMath::first_touch.
+     */
+    template<typename NumType, size_t BlockRows, size_t TileBytes>
+    void gemv_blocked(
+        const NumType *matrix,
+        const NumType *vector,
+        NumType *dest,
+        const NumType alpha,
+        const NumType beta,
+        const size_t rows,
+        const size_t columns,
+        const size_t leading_dimension) {
+        static_assert(BlockRows > 0, "a block holds at least one row");
+        set_num_threads(rows * columns);
+
+        constexpr size_t tile = TileBytes == 0 ? 0 : TileBytes / sizeof(NumType);
+        size_t const tile_columns{tile == 0 || tile > columns ? columns : tile};
+        size_t const blocks{(rows + BlockRows - 1) / BlockRows};
+
+        // a single tile leaves nothing to carry between tiles
+        std::vector<NumType> scratch(tile_columns < columns ? rows : 0);
+
+#pragma omp parallel default(none) shared(alpha, beta, matrix, vector, dest, rows, columns, leading_dimension, tile_columns, blocks, scratch)
+        {
+            for (size_t tile_start = 0;; tile_start += tile_columns) {
+                size_t const tile_end{std::min(columns, tile_start + tile_columns)};
+                bool const last_tile{tile_end == columns};
+
+                // the same static schedule hands every tile's loop the same blocks
+#pragma omp for schedule(static) nowait
+                for (size_t block = 0; block < blocks; ++block) {
+                    size_t const start_row{block * BlockRows};
+                    size_t const count{std::min(BlockRows, rows - start_row)};
+                    NumType partials[BlockRows]{};
+
+                    if (!scratch.empty()) {
+                        std::copy_n(scratch.begin() + static_cast<std::ptrdiff_t>(start_row), count, partials);
+                    }
+
+                    if (start_row + BlockRows < rows) {
+                        prefetch_rows(matrix, start_row + BlockRows,
+                                      std::min(BlockRows, rows - start_row - BlockRows), columns, leading_dimension,
+                                      tile_start);
+                    }
+
+                    if (count == BlockRows) {
+                        dot_rows<NumType, BlockRows>(
+                            matrix, vector, partials, start_row, leading_dimension, tile_start, tile_end);
+                    } else {
+                        for (size_t r = 0; r < count; ++r) {
+                            dot_rows<NumType, 1>(
+                                matrix, vector, partials + r, start_row + r, leading_dimension, tile_start, tile_end);
+                        }
+                    }
+
+                    if (last_tile) {
+                        for (size_t r = 0; r < count; ++r) {
+                            scale_store(dest[start_row + r], partials[r], alpha, beta);
+                        }
+                    } else {
+                        std::copy_n(partials, count, scratch.begin() + static_cast<std::ptrdiff_t>(start_row));
+                    }
+                }
+
+                if (last_tile) break;
+            }
+        }
+    }
+
+    /**
+     * mixed precision gemv, A is stored as FLOAT16 or BFLOAT16 and widened to FLOAT32 as it is loaded,
+     * x, y and the accumulation stay in FLOAT32
+     */
+    template<typename HalfType>
+    void gemv_half_parallel(
+        const HalfType *matrix,
+        const float *vector,
+        float *dest,
+        const float alpha,
+        const float beta,
+        const size_t rows,
+        const size_t columns,
+        const size_t leading_dimension) {
+        set_num_threads(rows * columns);
+        size_t start;
+
+#pragma omp parallel for default(none) shared(alpha, beta, matrix, vector, dest, rows, columns, leading_dimension) private(start) schedule(static)
+        for (start = 0; start < rows; ++start) {
+            float partial = 0;
+
+#pragma omp simd reduction(+:partial)
+            for (size_t i = 0; i < columns; ++i) {
+                partial += vector[i] * to_float(matrix[start * leading_dimension + i]);
+            }
+
+            scale_store(dest[start], partial, alpha, beta);
+        }
+    }
+
+    template<typename NumType>
+    NumType widen_element(const NumType value) {
+        return value;
+    }
+
+    inline float widen_element(const float16 value) {
+        return to_float(value);
+    }
+
+    inline float widen_element(const bfloat16 value) {
+        return to_float(value);
+    }
+
+    /**
+     * the type arithmetic on NumType is performed in, FLOAT32 for half precision storage
+     */
+    template<typename NumType>
+    using widened_t = decltype(widen_element(NumType{}));
+
+    /**
+     * stores a value computed in the widened type back into NumType, rounding half precision to nearest even
+     */
+    template<typename NumType, typename Value>
+    NumType narrow_element(const Value value) {
+        return static_cast<NumType>(value);
+    }
+
+    template<>
+    inline float16 narrow_element<float16, float>(const float value) {
+        return to_float16(value);
+    }
+
+    template<>
+    inline bfloat16 narrow_element<bfloat16, float>(const float value) {
+        return to_bfloat16(value);
+    }
+
+#define TRANSPOSE_BLOCK_ROWS 4
+
+    /**
+     * y=αAᵀx+βy without transposing A. Every thread walks its static share of the rows in blocks and
+     * adds x[r]·A[r] to its own column buffer, TRANSPOSE_BLOCK_ROWS rows per pass so the buffer is read
+     * and written once per block. The buffers are then summed column wise by all threads.
+     *
+     * @param rows rows of A, the length of x
+     * @param columns columns of A, the length of y
+     * @param leading_dimension elements between the starts of consecutive rows of A
+     */
+    template<typename MatrixType, typename NumType>
+    void gemv_transposed_parallel(
+        const MatrixType *matrix,
+        const NumType *vector,
+        NumType *dest,
+        const NumType alpha,
+        const NumType beta,
+        const size_t rows,
+        const size_t columns,
+        const size_t leading_dimension) {
+        set_num_threads(rows * columns);
+        std::vector<NumType> partials;
+        size_t threads{1};
+
+#pragma omp parallel default(none) shared(alpha, beta, matrix, vector, dest, rows, columns, leading_dimension, partials, threads)
+        {
+#pragma omp single
+            {
+                threads = static_cast<size_t>(omp_get_num_threads());
+                partials.assign(threads * columns, 0);
+            }
+
+            NumType *own = partials.data() + static_cast<size_t>(omp_get_thread_num()) * columns;
+
+#pragma omp for schedule(static)
+            for (size_t start = 0; start < rows; start += TRANSPOSE_BLOCK_ROWS) {
+                if (start + TRANSPOSE_BLOCK_ROWS > rows) {
+                    for (size_t row = start; row < rows; ++row) {
+                        const MatrixType *a = matrix + row * leading_dimension;
+                        NumType const x = vector[row];
+
+#pragma omp simd
+                        for (size_t i = 0; i < columns; ++i) {
+                            own[i] = static_cast<NumType>(own[i] + x * widen_element(a[i]));
+                        }
+                    }
+
+                    continue;
+                }
+
+                const MatrixType *a0 = matrix + start * leading_dimension;
+                const MatrixType *a1 = a0 + leading_dimension;
+                const MatrixType *a2 = a1 + leading_dimension;
+                const MatrixType *a3 = a2 + leading_dimension;
+                NumType const x0 = vector[start];
+                NumType const x1 = vector[start + 1];
+                NumType const x2 = vector[start + 2];
+                NumType const x3 = vector[start + 3];
+
+#pragma omp simd
+                for (size_t i = 0; i < columns; ++i) {
+                    own[i] = static_cast<NumType>(
+                        own[i] + x0 * widen_element(a0[i]) + x1 * widen_element(a1[i]) +
+                        x2 * widen_element(a2[i]) + x3 * widen_element(a3[i]));
+                }
+            }
+
+#pragma omp for schedule(static)
+            for (size_t i = 0; i < columns; ++i) {
+                NumType sum = 0;
+                for (size_t t = 0; t < threads; ++t) {
+                    sum = static_cast<NumType>(sum + partials[t * columns + i]);
+                }
+
+                scale_store(dest[i], sum, alpha, beta);
+            }
+        }
+    }
+
+    /**
+     * CSR gemv balanced by nonzeros rather than rows, every thread gets an equal share of the nonzeros
+     * whatever the row lengths. A row split between threads is summed in pieces: the thread it starts in
+     * keeps its part as a tail, the following threads keep theirs as heads, and the pieces are added up
+     * once the threads are done.
+     */
+    template<typename NumType>
+    void sparse_gemv_parallel(
+        const int64_t *row_pointers,
+        const int64_t *column_indices,
+        const NumType *values,
+        const NumType *vector,
+        NumType *dest,
+        const NumType alpha,
+        const NumType beta,
+        const size_t rows) {
+        auto const nonzeros{static_cast<size_t>(row_pointers[rows])};
+        set_num_threads(nonzeros);
+
+        // rows stands for none
+        std::vector<size_t> head_rows, tail_rows;
+        std::vector<NumType> head_sums, tail_sums;
+        size_t threads{1};
+
+        auto const row_sum = [&](size_t const begin, size_t const end) {
+            NumType partial = 0;
+            for (size_t i = begin; i < end; ++i) {
+                partial = static_cast<NumType>(
+                    partial + values[i] * vector[static_cast<size_t>(column_indices[i])]);
+            }
+
+            return partial;
+        };
+
+        // the first row starting at or after nonzero position
+        auto const first_row = [&](size_t const position) {
+            return static_cast<size_t>(
+                std::lower_bound(row_pointers, row_pointers + rows, static_cast<int64_t>(position)) - row_pointers);
+        };
+
+#pragma omp parallel default(none) shared(alpha, beta, dest, rows, nonzeros, threads, head_rows, tail_rows, head_sums, tail_sums, row_pointers, row_sum, first_row)
+        {
+#pragma omp single
+            {
+                threads = static_cast<size_t>(omp_get_num_threads());
+                head_rows.assign(threads, rows);
+                tail_rows.assign(threads, rows);
+                head_sums.assign(threads, 0);
+                tail_sums.assign(threads, 0);
+            }
+
+            auto const thread{static_cast<size_t>(omp_get_thread_num())};
+            size_t const low{nonzeros * thread / threads};
+            size_t const high{nonzeros * (thread + 1) / threads};
+            size_t const row_begin{first_row(low)};
+            size_t const row_end{thread + 1 == threads ? rows : first_row(high)};
+
+            // the end of a row that started before this thread's share
+            if (row_begin > 0 && static_cast<size_t>(row_pointers[row_begin]) > low) {
+                head_rows[thread] = row_begin - 1;
+                head_sums[thread] = row_sum(low, std::min(static_cast<size_t>(row_pointers[row_begin]), high));
+            }
+
+            for (size_t row = row_begin; row < row_end; ++row) {
+                auto const begin{static_cast<size_t>(row_pointers[row])};
+                auto const end{static_cast<size_t>(row_pointers[row + 1])};
+
+                if (end > high) {
+                    tail_rows[thread] = row;
+                    tail_sums[thread] = row_sum(begin, high);
+                    break;
+                }
+
+                scale_store(dest[row], row_sum(begin, end), alpha, beta);
+            }
+        }
+
+        for (size_t thread = 0; thread < threads; ++thread) {
+            size_t const row{tail_rows[thread]};
+            if (row == rows) continue;
+
+            NumType total = tail_sums[thread];
+            for (size_t next = thread + 1; next < threads && head_rows[next] == row; ++next) {
+                total = static_cast<NumType>(total + head_sums[next]);
+            }
+
+            scale_store(dest[row], total, alpha, beta);
+        }
+    }
+
+    /**
+     * gemv against a sparse x, only the columns of A named in indices are read so the work is rows * nonzeros
+     */
+    template<typename NumType>
+    void sparse_query_gemv_parallel(
+        const NumType *matrix,
+        const int64_t *indices,
+        const NumType *values,
+        NumType *dest,
+        const NumType alpha,
+        const NumType beta,
+        const size_t rows,
+        const size_t leading_dimension,
+        const size_t nonzeros) {
+        set_num_threads(rows * nonzeros);
+        size_t start;
+
+#pragma omp parallel for default(none) shared(alpha, beta, matrix, indices, values, dest, rows, leading_dimension, nonzeros) private(start) schedule(static)
+        for (start = 0; start < rows; ++start) {
+            const NumType *a = matrix + start * leading_dimension;
+            NumType partial = 0;
+
+            for (size_t i = 0; i < nonzeros; ++i) {
+                partial = static_cast<NumType>(partial + values[i] * a[static_cast<size_t>(indices[i])]);
+            }
+
+            scale_store(dest[start], partial, alpha, beta);
+        }
+    }
+
+    /**
+     * transposed gemv against a sparse x, y is the sum of the rows of A named in indices scaled by their values.
+     * Each thread owns a contiguous range of y and streams that range of every touched row, so no
+     * reduction across threads is needed
+     */
+    template<typename NumType>
+    void sparse_query_gemv_transposed_parallel(
+        const NumType *matrix,
+        const int64_t *indices,
+        const NumType *values,
+        NumType *dest,
+        const NumType alpha,
+        const NumType beta,
+        const size_t columns,
+        const size_t leading_dimension,
+        const size_t nonzeros) {
+        set_num_threads(columns * nonzeros);
+
+#pragma omp parallel default(none) shared(alpha, beta, matrix, indices, values, dest, columns, leading_dimension, nonzeros)
+        {
+            auto const threads{static_cast<size_t>(omp_get_num_threads())};
+            auto const thread{static_cast<size_t>(omp_get_thread_num())};
+            size_t const low{columns * thread / threads};
+            size_t const high{columns * (thread + 1) / threads};
+            std::vector<NumType> partials(high - low, 0);
+
+            for (size_t i = 0; i < nonzeros; ++i) {
+                const NumType *a = matrix + static_cast<size_t>(indices[i]) * leading_dimension + low;
+                NumType const x = values[i];
+                NumType *own = partials.data();
+
+#pragma omp simd
+                for (size_t j = 0; j < high - low; ++j) {
+                    own[j] = static_cast<NumType>(own[j] + x * a[j]);
+                }
+            }
+
+            for (size_t j = low; j < high; ++j) {
+                scale_store(dest[j], partials[j - low], alpha, beta);
+            }
+        }
+    }
+
+    // the level 1 kernels read half precision storage widened to FLOAT32 and return FLOAT32 results
+
+    template<typename NumType>
+    widened_t<NumType> dot_parallel(const NumType *x, const NumType *y, const size_t length) {
+        using Compute = widened_t<NumType>;
+        set_num_threads(length);
+        Compute sum = 0;
+        size_t i;
+
+#pragma omp parallel for simd default(none) shared(x, y, length) private(i) reduction(+:sum) schedule(static)
+        for (i = 0; i < length; ++i) {
+            sum = static_cast<Compute>(sum + widen_element(x[i]) * widen_element(y[i]));
+        }
+
+        return sum;
+    }
+
+    template<typename NumType>
+    void axpy_parallel(const widened_t<NumType> alpha, const NumType *x, NumType *y, const size_t length) {
+        set_num_threads(length);
+        size_t i;
+
+#pragma omp parallel for simd default(none) shared(alpha, x, y, length) private(i) schedule(static)
+        for (i = 0; i < length; ++i) {
+            y[i] = narrow_element<NumType>(alpha * widen_element(x[i]) + widen_element(y[i]));
+        }
+    }
+
+    template<typename NumType>
+    void scal_parallel(const widened_t<NumType> alpha, NumType *x, const size_t length) {
+        set_num_threads(length);
+        size_t i;
+
+#pragma omp parallel for simd default(none) shared(alpha, x, length) private(i) schedule(static)
+        for (i = 0; i < length; ++i) {
+            x[i] = narrow_element<NumType>(alpha * widen_element(x[i]));
+        }
+    }
+
+    template<typename NumType>
+    widened_t<NumType> nrm2_parallel(const NumType *x, const size_t length) {
+        set_num_threads(length);
+        double sum = 0;
+        size_t i;
+
+#pragma omp parallel for simd default(none) shared(x, length) private(i) reduction(+:sum) schedule(static)
+        for (i = 0; i < length; ++i) {
+            auto const value{static_cast<double>(widen_element(x[i]))};
+            sum += value * value;
+        }
+
+        return static_cast<widened_t<NumType>>(std::sqrt(sum));
+    }
+
+    template<typename NumType>
+    widened_t<NumType> asum_parallel(const NumType *x, const size_t length) {
+        using Compute = widened_t<NumType>;
+        set_num_threads(length);
+        Compute sum = 0;
+        size_t i;
+
+#pragma omp parallel for simd default(none) shared(x, length) private(i) reduction(+:sum) schedule(static)
+        for (i = 0; i < length; ++i) {
+            Compute const value{widen_element(x[i])};
+            sum = static_cast<Compute>(sum + (value < 0 ? -value : value));
+        }
+
+        return sum;
+    }
+
+    /**
+     * -|x|, which unlike |x| cannot overflow for the most negative integer
+     */
+    template<typename NumType>
+    NumType negative_magnitude(const NumType value) {
+        return value > 0 ? static_cast<NumType>(-value) : value;
+    }
+
+    template<typename NumType>
+    size_t iamax_parallel(const NumType *x, const size_t length) {
+        set_num_threads(length);
+        std::vector<size_t> best;
+        size_t threads{1};
+
+#pragma omp parallel default(none) shared(x, length, best, threads)
+        {
+#pragma omp single
+            {
+                threads = static_cast<size_t>(omp_get_num_threads());
+                best.assign(threads, length);
+            }
+
+            auto const thread{static_cast<size_t>(omp_get_thread_num())};
+            size_t own{length};
+
+            // threads get increasing ranges, so the first index with the largest magnitude wins
+#pragma omp for schedule(static)
+            for (size_t i = 0; i < length; ++i) {
+                if (own == length ||
+                    negative_magnitude(widen_element(x[i])) < negative_magnitude(widen_element(x[own]))) {
+                    own = i;
+                }
+            }
+
+            best[thread] = own;
+        }
+
+        size_t index{0};
+        for (size_t const candidate: best) {
+            if (candidate != length &&
+                negative_magnitude(widen_element(x[candidate])) < negative_magnitude(widen_element(x[index]))) {
+                index = candidate;
+            }
+        }
+
+        return index;
+    }
+
+    template<typename Accumulator, typename NumType>
+    Accumulator sum_row(const NumType *row, const size_t columns) {
+        Accumulator sum = 0;
+
+#pragma omp simd reduction(+:sum)
+        for (size_t i = 0; i < columns; ++i) {
+            sum = static_cast<Accumulator>(sum + static_cast<Accumulator>(row[i]));
+        }
+
+        return sum;
+    }
+
+    template<typename NumType>
+    NumType max_row(const NumType *row, const size_t columns) {
+        NumType best = row[0];
+
+#pragma omp simd reduction(max:best)
+        for (size_t i = 1; i < columns; ++i) {
+            best = row[i] > best ? row[i] : best;
+        }
+
+        return best;
+    }
+
+    template<typename NumType>
+    int64_t argmax_row(const NumType *row, const size_t columns) {
+        NumType const best{max_row(row, columns)};
+
+        for (size_t i = 0; i < columns; ++i) {
+            if (row[i] == best) return static_cast<int64_t>(i);
+        }
+
+        return 0;
+    }
+
+    template<typename NumType>
+    void reduce_rows_parallel(
+        const NumType *matrix,
+        void *dest,
+        const size_t rows,
+        const size_t columns,
+        const size_t leading_dimension,
+        const Reduction reduction) {
+        set_num_threads(rows * columns);
+        size_t row;
+
+        switch (reduction) {
+            case SUM: {
+                auto *out = static_cast<NumType *>(dest);
+#pragma omp parallel for default(none) shared(matrix, out, rows, columns, leading_dimension) private(row) schedule(static)
+                for (row = 0; row < rows; ++row) {
+                    out[row] = sum_row<NumType>(matrix + row * leading_dimension, columns);
+                }
+
+                return;
+            }
+            case MEAN: {
+                auto *out = static_cast<NumType *>(dest);
+#pragma omp parallel for default(none) shared(matrix, out, rows, columns, leading_dimension) private(row) schedule(static)
+                for (row = 0; row < rows; ++row) {
+                    double const sum{sum_row<double>(matrix + row * leading_dimension, columns)};
+                    out[row] = static_cast<NumType>(sum / static_cast<double>(columns));
+                }
+
+                return;
+            }
+            case MAX: {
+                auto *out = static_cast<NumType *>(dest);
+#pragma omp parallel for default(none) shared(matrix, out, rows, columns, leading_dimension) private(row) schedule(static)
+                for (row = 0; row < rows; ++row) {
+                    out[row] = max_row(matrix + row * leading_dimension, columns);
+                }
+
+                return;
+            }
+            case ARGMAX: {
+                auto *out = static_cast<int64_t *>(dest);
+#pragma omp parallel for default(none) shared(matrix, out, rows, columns, leading_dimension) private(row) schedule(static)
+                for (row = 0; row < rows; ++row) {
+                    out[row] = argmax_row(matrix + row * leading_dimension, columns);
+                }
+            }
+        }
+    }
+
+    /**
+     * sums the columns of A. Every thread adds its rows into its own partial row, so A is streamed row by
+     * row instead of strided down the columns, then the partials are combined
+     */
+    template<typename Accumulator, typename NumType>
+    void column_sums_parallel(
+        const NumType *matrix,
+        Accumulator *sums,
+        const size_t rows,
+        const size_t columns,
+        const size_t leading_dimension) {
+        std::vector<Accumulator> partials;
+        size_t threads{1};
+
+#pragma omp parallel default(none) shared(matrix, sums, rows, columns, leading_dimension, partials, threads)
+        {
+#pragma omp single
+            {
+                threads = static_cast<size_t>(omp_get_num_threads());
+                partials.assign(threads * columns, 0);
+            }
+
+            Accumulator *own = partials.data() + static_cast<size_t>(omp_get_thread_num()) * columns;
+
+#pragma omp for schedule(static)
+            for (size_t row = 0; row < rows; ++row) {
+                const NumType *a = matrix + row * leading_dimension;
+
+#pragma omp simd
+                for (size_t i = 0; i < columns; ++i) {
+                    own[i] = static_cast<Accumulator>(own[i] + static_cast<Accumulator>(a[i]));
+                }
+            }
+
+#pragma omp for schedule(static)
+            for (size_t i = 0; i < columns; ++i) {
+                Accumulator sum = 0;
+                for (size_t t = 0; t < threads; ++t) {
+                    sum = static_cast<Accumulator>(sum + partials[t * columns + i]);
+                }
+
+                sums[i] = sum;
+            }
+        }
+    }
+
+    /**
+     * the maximum of every column of A and, when indices is not null, the first row holding it. Every thread
+     * keeps a partial row over a contiguous range of rows, the ranges increase with the thread so merging
+     * them in thread order keeps the first row on ties
+     */
+    template<typename NumType>
+    void column_max_parallel(
+        const NumType *matrix,
+        NumType *maxima,
+        int64_t *indices,
+        const size_t rows,
+        const size_t columns,
+        const size_t leading_dimension) {
+        std::vector<NumType> partials;
+        std::vector<int64_t> partial_indices;
+        size_t threads{1};
+
+#pragma omp parallel default(none) shared(matrix, maxima, indices, rows, columns, leading_dimension, partials, partial_indices, threads)
+        {
+#pragma omp single
+            {
+                threads = static_cast<size_t>(omp_get_num_threads());
+                partials.assign(threads * columns, 0);
+                partial_indices.assign(threads * columns, -1);
+            }
+
+            auto const thread{static_cast<size_t>(omp_get_thread_num())};
+            size_t const low{rows * thread / threads};
+            size_t const high{rows * (thread + 1) / threads};
+            NumType *own = partials.data() + thread * columns;
+            int64_t *own_indices = partial_indices.data() + thread * columns;
+
+            if (low < high) {
+                std::copy_n(matrix + low * leading_dimension, columns, own);
+                std::fill_n(own_indices, columns, static_cast<int64_t>(low));
+            }
+
+            for (size_t row = low + 1; row < high; ++row) {
+                const NumType *a = matrix + row * leading_dimension;
+                auto const index{static_cast<int64_t>(row)};
+
+#pragma omp simd
+                for (size_t i = 0; i < columns; ++i) {
+                    bool const greater{a[i] > own[i]};
+                    own[i] = greater ? a[i] : own[i];
+                    own_indices[i] = greater ? index : own_indices[i];
+                }
+            }
+
+#pragma omp barrier
+
+#pragma omp for schedule(static)
+            for (size_t i = 0; i < columns; ++i) {
+                NumType best = matrix[i];
+                int64_t best_index{0};
+
+                for (size_t t = 0; t < threads; ++t) {
+                    if (partial_indices[t * columns + i] >= 0 && partials[t * columns + i] > best) {
+                        best = partials[t * columns + i];
+                        best_index = partial_indices[t * columns + i];
+                    }
+                }
+
+                maxima[i] = best;
+                if (indices != nullptr) indices[i] = best_index;
+            }
+        }
+    }
+
+    template<typename NumType>
+    void reduce_columns_parallel(
+        const NumType *matrix,
+        void *dest,
+        const size_t rows,
+        const size_t columns,
+        const size_t leading_dimension,
+        const Reduction reduction) {
+        set_num_threads(rows * columns);
+
+        switch (reduction) {
+            case SUM: {
+                column_sums_parallel(matrix, static_cast<NumType *>(dest), rows, columns, leading_dimension);
+                return;
+            }
+            case MEAN: {
+                std::vector<double> sums(columns);
+                column_sums_parallel(matrix, sums.data(), rows, columns, leading_dimension);
+
+                auto *out = static_cast<NumType *>(dest);
+                for (size_t i = 0; i < columns; ++i) {
+                    out[i] = static_cast<NumType>(sums[i] / static_cast<double>(rows));
+                }
+
+                return;
+            }
+            case MAX: {
+                column_max_parallel(matrix, static_cast<NumType *>(dest), nullptr, rows, columns, leading_dimension);
+                return;
+            }
+            case ARGMAX: {
+                std::vector<NumType> maxima(columns);
+                column_max_parallel(
+                    matrix, maxima.data(), static_cast<int64_t *>(dest), rows, columns, leading_dimension);
+            }
+        }
+    }
 
     template<typename NumType>
-    void gemv_naive(
+    struct ScoredRow {
+        NumType score;
+        int64_t index;
+    };
+
+    /**
+     * ordering used by top k selection, higher scores first and ties broken by the lower row index
+     */
+    template<typename NumType>
+    bool ranks_higher(const ScoredRow<NumType> &lhs, const ScoredRow<NumType> &rhs) {
+        return lhs.score > rhs.score || (lhs.score == rhs.score && lhs.index < rhs.index);
+    }
+
+    /**
+     * offers a row to a heap holding the best k rows seen so far, the lowest ranked row sits at the front
+     */
+    template<typename NumType>
+    void offer_topk(std::vector<ScoredRow<NumType> > &heap, size_t const k, const ScoredRow<NumType> &candidate) {
+        if (heap.size() < k) {
+            heap.push_back(candidate);
+            std::push_heap(heap.begin(), heap.end(), ranks_higher<NumType>);
+            return;
+        }
+
+        if (ranks_higher(candidate, heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), ranks_higher<NumType>);
+            heap.back() = candidate;
+            std::push_heap(heap.begin(), heap.end(), ranks_higher<NumType>);
+        }
+    }
+
+    /**
+     * computes the k best scores of αAx without materializing the score vector, every thread keeps a heap
+     * of its k best rows which are merged once the row loop is done
+     */
+    template<typename NumType>
+    void gemv_topk_parallel(
         const NumType *matrix,
         const NumType *vector,
-        NumType *dest,
+        int64_t *indices,
+        NumType *scores,
         const NumType alpha,
-        const NumType beta,
+        const size_t rows,
+        const size_t columns,
+        const size_t k) {
+        set_num_threads(rows * columns);
+        std::vector<ScoredRow<NumType> > merged;
+
+#pragma omp parallel default(none) shared(alpha, matrix, vector, rows, columns, k, merged)
+        {
+            std::vector<ScoredRow<NumType> > heap;
+            heap.reserve(k);
+
+#pragma omp for schedule(dynamic) nowait
+            for (size_t start = 0; start < rows; start += SCORE_BLOCK_ROWS) {
+                size_t const count{std::min<size_t>(SCORE_BLOCK_ROWS, rows - start)};
+                NumType partials[SCORE_BLOCK_ROWS]{};
+
+                if (count == SCORE_BLOCK_ROWS) {
+                    dot_rows<NumType, SCORE_BLOCK_ROWS>(matrix, vector, partials, start, columns, 0, columns);
+                } else {
+                    for (size_t r = 0; r < count; ++r) {
+                        dot_rows<NumType, 1>(matrix, vector, partials + r, start + r, columns, 0, columns);
+                    }
+                }
+
+                for (size_t r = 0; r < count; ++r) {
+                    offer_topk(heap, k, {
+                                   static_cast<NumType>(partials[r] * alpha), static_cast<int64_t>(start + r)
+                               });
+                }
+            }
+
+#pragma omp critical
+            merged.insert(merged.end(), heap.begin(), heap.end());
+        }
+
+        std::partial_sort(merged.begin(), merged.begin() + static_cast<std::ptrdiff_t>(k), merged.end(),
+                          ranks_higher<NumType>);
+
+        for (size_t i = 0; i < k; ++i) {
+            indices[i] = merged[i].index;
+            scores[i] = merged[i].score;
+        }
+    }
+
+    template<typename NumType>
+    void row_norms_parallel(
+        const NumType *matrix,
+        NumType *dest,
         const size_t rows,
         const size_t columns) {
-        for (size_t start{0}; start < rows; ++start) {
+        set_num_threads(rows * columns);
+        size_t start;
+
+#pragma omp parallel for default(none) shared(matrix, dest, rows, columns) private(start) schedule(static)
+        for (start = 0; start < rows; ++start) {
             NumType partial = 0;
+
+#pragma omp simd reduction(+:partial)
             for (size_t i = 0; i < columns; ++i) {
-                partial = static_cast<NumType>(partial + vector[i] * matrix[start * columns + i]);
+                partial += matrix[start * columns + i] * matrix[start * columns + i];
             }
 
-            dest[start] = static_cast<NumType>(dest[start] * beta + partial * alpha);
+            dest[start] = std::sqrt(partial);
         }
     }
 
+    /**
+     * y=α(Ax / (‖Aᵢ‖‖x‖))+βy, the row norms are precomputed so normalization is folded into the
+     * gemv epilogue. Rows or queries with a zero norm score 0.
+     */
     template<typename NumType>
-    void gemv_parallel(
+    void gemv_cosine_parallel(
         const NumType *matrix,
         const NumType *vector,
+        const NumType *norms,
         NumType *dest,
         const NumType alpha,
         const NumType beta,
         const size_t rows,
         const size_t columns) {
-        set_num_threads();
+        set_num_threads(rows * columns);
+
+        NumType vector_norm = 0;
+#pragma omp simd reduction(+:vector_norm)
+        for (size_t i = 0; i < columns; ++i) {
+            vector_norm += vector[i] * vector[i];
+        }
+
+        vector_norm = std::sqrt(vector_norm);
+
+        auto const epilogue = [&](size_t const row, NumType const partial) {
+            NumType const denominator = norms[row] * vector_norm;
+            NumType const similarity = denominator == 0 ? 0 : partial / denominator;
+            scale_store(dest[row], similarity, alpha, beta);
+        };
+
         size_t start;
 
-#pragma omp parallel for default(none) shared(alpha, beta, matrix, vector, dest, rows, columns) private(start) schedule(dynamic)
-        for (start = 0; start < rows; ++start) {
-            NumType partial = 0;
+#pragma omp parallel for default(none) shared(matrix, vector, rows, columns, epilogue) private(start) schedule(dynamic)
+        for (start = 0; start < rows; start += SCORE_BLOCK_ROWS) {
+            size_t const count{std::min<size_t>(SCORE_BLOCK_ROWS, rows - start)};
+            NumType partials[SCORE_BLOCK_ROWS]{};
 
-            for (size_t i = 0; i < columns; ++i) {
-                partial += static_cast<NumType>(vector[i] * matrix[start * columns + i]);
+            if (count == SCORE_BLOCK_ROWS) {
+                dot_rows<NumType, SCORE_BLOCK_ROWS>(matrix, vector, partials, start, columns, 0, columns);
+            } else {
+                for (size_t r = 0; r < count; ++r) {
+                    dot_rows<NumType, 1>(matrix, vector, partials + r, start + r, columns, 0, columns);
+                }
             }
 
-            dest[start] = static_cast<NumType>(dest[start] * beta + partial * alpha);
+            for (size_t r = 0; r < count; ++r) {
+                epilogue(start + r, partials[r]);
+            }
         }
     }
 
+    /**
+     * Tile sizes for the batched gemv. BATCH_ROWS rows of the matrix are cut into BATCH_COLUMNS wide
+     * tiles that stay in L1 while every query is applied to them, so the matrix is streamed once.
+     */
     template<typename NumType>
-    void gemv_parallel_simd(
+    struct BatchedTiling {
+        static constexpr size_t BATCH_ROWS = 4;
+        static constexpr size_t BATCH_COLUMNS = 16384 / (BATCH_ROWS * sizeof(NumType));
+    };
+
+    template<typename NumType>
+    void gemv_batched_parallel(
         const NumType *matrix,
-        const NumType *vector,
+        const NumType *queries,
+        NumType *dest,
+        const NumType alpha,
+        const NumType beta,
+        const size_t rows,
+        const size_t columns,
+        const size_t query_count) {
+        constexpr size_t BATCH_ROWS = BatchedTiling<NumType>::BATCH_ROWS;
+        constexpr size_t BATCH_COLUMNS = BatchedTiling<NumType>::BATCH_COLUMNS;
+
+        set_num_threads(rows * columns * query_count);
+
+#pragma omp parallel default(none) shared(alpha, beta, matrix, queries, dest, rows, columns, query_count)
+        {
+            // partial sums for every (query, row) pair of the current row tile
+            std::vector<NumType> partials(query_count * BATCH_ROWS);
+
+#pragma omp for schedule(static)
+            for (size_t start = 0; start < rows; start += BATCH_ROWS) {
+                size_t const tile_rows = rows - start < BATCH_ROWS ? rows - start : BATCH_ROWS;
+                std::fill(partials.begin(), partials.end(), static_cast<NumType>(0));
+
+                for (size_t col = 0; col < columns; col += BATCH_COLUMNS) {
+                    size_t const tile_columns = columns - col < BATCH_COLUMNS ? columns - col : BATCH_COLUMNS;
+
+                    for (size_t q = 0; q < query_count; ++q) {
+                        const NumType *query = queries + q * columns + col;
+                        NumType *partial = partials.data() + q * BATCH_ROWS;
+
+                        if (tile_rows == BATCH_ROWS) {
+                            const NumType *r0 = matrix + start * columns + col;
+                            const NumType *r1 = r0 + columns;
+                            const NumType *r2 = r1 + columns;
+                            const NumType *r3 = r2 + columns;
+                            NumType p0 = 0, p1 = 0, p2 = 0, p3 = 0;
+
+#pragma omp simd reduction(+:p0, p1, p2, p3)
+                            for (size_t i = 0; i < tile_columns; ++i) {
+                                p0 += static_cast<NumType>(query[i] * r0[i]);
+                                p1 += static_cast<NumType>(query[i] * r1[i]);
+                                p2 += static_cast<NumType>(query[i] * r2[i]);
+                                p3 += static_cast<NumType>(query[i] * r3[i]);
+                            }
+
+                            partial[0] = static_cast<NumType>(partial[0] + p0);
+                            partial[1] = static_cast<NumType>(partial[1] + p1);
+                            partial[2] = static_cast<NumType>(partial[2] + p2);
+                            partial[3] = static_cast<NumType>(partial[3] + p3);
+                            continue;
+                        }
+
+                        for (size_t r = 0; r < tile_rows; ++r) {
+                            const NumType *row = matrix + (start + r) * columns + col;
+                            NumType p = 0;
+
+#pragma omp simd reduction(+:p)
+                            for (size_t i = 0; i < tile_columns; ++i) {
+                                p += static_cast<NumType>(query[i] * row[i]);
+                            }
+
+                            partial[r] = static_cast<NumType>(partial[r] + p);
+                        }
+                    }
+                }
+
+                for (size_t q = 0; q < query_count; ++q) {
+                    NumType *dest_row = dest + q * rows + start;
+                    const NumType *partial = partials.data() + q * BATCH_ROWS;
+
+                    for (size_t r = 0; r < tile_rows; ++r) {
+                        scale_store(dest_row[r], partial[r], alpha, beta);
+                    }
+                }
+            }
+        }
+    }
+
+    template<typename NumType>
+    void gemm_naive(
+        const NumType *matrix_a,
+        const NumType *matrix_b,
         NumType *dest,
         const NumType alpha,
         const NumType beta,
         const size_t rows,
+        const size_t shared,
         const size_t columns) {
-        set_num_threads();
-        size_t start;
+        for (size_t i{0}; i < rows; ++i) {
+            for (size_t j{0}; j < columns; ++j) {
+                NumType partial = 0;
+                for (size_t p{0}; p < shared; ++p) {
+                    partial = static_cast<NumType>(partial + matrix_a[i * shared + p] * matrix_b[p * columns + j]);
+                }
 
-#pragma omp parallel for default(none) shared(alpha, beta, matrix, vector, dest, rows, columns) private(start) schedule(dynamic)
-        for (start = 0; start < rows; ++start) {
-            NumType partial = 0;
+                scale_store(dest[i * columns + j], partial, alpha, beta);
+            }
+        }
+    }
 
-#pragma omp simd reduction(+:partial)
-            for (size_t i = 0; i < columns; ++i) {
-                partial += static_cast<NumType>(vector[i] * matrix[start * columns + i]);
+    /**
+     * Tile sizes for the blocked gemm. A micro tile of MR x NR accumulators stays in registers,
+     * a KC x NR panel of B is sized to stay in L1 and an MC x KC block of A is sized to stay in L2.
+     */
+    template<typename NumType>
+    struct GemmTiling {
+        static constexpr size_t MR = 4;
+        static constexpr size_t NR = 64 / sizeof(NumType); // one cache line of B per k step
+        static constexpr size_t KC = 16384 / (NR * sizeof(NumType));
+        static constexpr size_t MC = (131072 / (KC * sizeof(NumType))) / MR * MR;
+        static constexpr size_t NC = 4096 / NR * NR;
+    };
+
+    /**
+     * packs an mc x kc block of A into MR row panels, each panel is stored k major so the micro kernel
+     * reads it sequentially. Rows past the end of the block are zero filled.
+     */
+    template<typename NumType>
+    void gemm_pack_a(
+        const NumType *matrix_a,
+        NumType *packed,
+        const size_t lda,
+        const size_t mc,
+        const size_t kc) {
+        constexpr size_t MR = GemmTiling<NumType>::MR;
+
+        for (size_t ir{0}; ir < mc; ir += MR) {
+            size_t const mr = mc - ir < MR ? mc - ir : MR;
+            for (size_t p{0}; p < kc; ++p) {
+                for (size_t i{0}; i < MR; ++i) {
+                    packed[p * MR + i] = i < mr ? matrix_a[(ir + i) * lda + p] : static_cast<NumType>(0);
+                }
             }
 
-            dest[start] = static_cast<NumType>(dest[start] * beta + partial * alpha);
+            packed += MR * kc;
         }
     }
 
-#define ROW_COUNT 2
+    /**
+     * packs a single kc x nr panel of B, k major. Columns past the end of the block are zero filled.
+     */
+    template<typename NumType>
+    void gemm_pack_b_panel(
+        const NumType *matrix_b,
+        NumType *packed,
+        const size_t ldb,
+        const size_t kc,
+        const size_t nr) {
+        constexpr size_t NR = GemmTiling<NumType>::NR;
 
+        for (size_t p{0}; p < kc; ++p) {
+            for (size_t j{0}; j < NR; ++j) {
+                packed[p * NR + j] = j < nr ? matrix_b[p * ldb + j] : static_cast<NumType>(0);
+            }
+        }
+    }
 
+    /**
+     * computes a MR x NR tile of C from packed panels, only the top left mr x nr corner is written back
+     */
     template<typename NumType>
-    void gemv_parallel_simd_2(
-        const NumType *matrix,
-        const NumType *vector,
+    void gemm_micro_kernel(
+        const NumType *packed_a,
+        const NumType *packed_b,
+        NumType *dest,
+        const size_t ldc,
+        const size_t kc,
+        const size_t mr,
+        const size_t nr,
+        const NumType alpha,
+        const NumType beta) {
+        constexpr size_t MR = GemmTiling<NumType>::MR;
+        constexpr size_t NR = GemmTiling<NumType>::NR;
+
+        NumType acc[MR][NR]{};
+
+        for (size_t p{0}; p < kc; ++p) {
+            const NumType *a_col = packed_a + p * MR;
+            const NumType *b_row = packed_b + p * NR;
+
+            for (size_t i{0}; i < MR; ++i) {
+                NumType const a_val = a_col[i];
+#pragma omp simd
+                for (size_t j = 0; j < NR; ++j) {
+                    acc[i][j] = static_cast<NumType>(acc[i][j] + a_val * b_row[j]);
+                }
+            }
+        }
+
+        for (size_t i{0}; i < mr; ++i) {
+            NumType *dest_row = dest + i * ldc;
+            if (beta == 0) {
+                for (size_t j{0}; j < nr; ++j) {
+                    dest_row[j] = static_cast<NumType>(acc[i][j] * alpha);
+                }
+            } else {
+                for (size_t j{0}; j < nr; ++j) {
+                    dest_row[j] = static_cast<NumType>(dest_row[j] * beta + acc[i][j] * alpha);
+                }
+            }
+        }
+    }
+
+    template<typename NumType>
+    void gemm_parallel_blocked(
+        const NumType *matrix_a,
+        const NumType *matrix_b,
         NumType *dest,
         const NumType alpha,
         const NumType beta,
         const size_t rows,
+        const size_t shared,
         const size_t columns) {
-        set_num_threads();
-        size_t start;
+        using Tiling = GemmTiling<NumType>;
+        constexpr size_t MR = Tiling::MR;
+        constexpr size_t NR = Tiling::NR;
+        constexpr size_t KC = Tiling::KC;
+        constexpr size_t MC = Tiling::MC;
+        constexpr size_t NC = Tiling::NC;
+
+        if (shared == 0) {
+            for (size_t i{0}; i < rows * columns; ++i) {
+                scale_store(dest[i], static_cast<NumType>(0), alpha, beta);
+            }
+            return;
+        }
+
+        set_num_threads(rows * shared * columns);
+        std::vector<NumType> packed_b(KC * NC);
 
-#pragma omp parallel for default(none) shared(alpha, beta, matrix, vector, dest, rows, columns) private(start) schedule(dynamic)
-        for (start = 0; start < rows; start += ROW_COUNT) {
-            NumType partial;
+#pragma omp parallel default(none) shared(alpha, beta, matrix_a, matrix_b, dest, rows, shared, columns, packed_b)
+        {
+            std::vector<NumType> packed_a(MC * KC);
 
-            size_t const end_row = start + ROW_COUNT;
-            size_t start_row = start;
+            for (size_t jc = 0; jc < columns; jc += NC) {
+                size_t const nc = columns - jc < NC ? columns - jc : NC;
+                size_t const b_panels = (nc + NR - 1) / NR;
 
-            if (end_row > rows) {
-                for (; start_row < rows; ++start_row) {
-                    partial = 0;
-#pragma omp simd reduction(+:partial) aligned(vector: 32) aligned(matrix: 32)
-                    for (size_t i = 0; i < columns; ++i) {
-                        partial += static_cast<NumType>(vector[i] * matrix[start_row * columns + i]);
+                for (size_t pc = 0; pc < shared; pc += KC) {
+                    size_t const kc = shared - pc < KC ? shared - pc : KC;
+
+                    // beta only applies to the first pass over k, later passes accumulate into C
+                    NumType const pass_beta = pc == 0 ? beta : static_cast<NumType>(1);
+
+#pragma omp for schedule(static)
+                    for (size_t jp = 0; jp < b_panels; ++jp) {
+                        size_t const jr = jp * NR;
+                        size_t const nr = nc - jr < NR ? nc - jr : NR;
+                        gemm_pack_b_panel(
+                            matrix_b + pc * columns + jc + jr, packed_b.data() + jp * NR * kc, columns, kc, nr);
                     }
 
-                    dest[start_row] = static_cast<NumType>(dest[start_row] * beta + partial * alpha);
-                }
-            }else {
-                partial = 0;
-                NumType partial_2 = 0;
-#pragma omp simd reduction(+:partial) reduction(+:partial_2) aligned(vector: 32) aligned(matrix: 32)
-                for (size_t i = 0; i < columns; ++i) {
-                    partial += static_cast<NumType>(vector[i] * matrix[start * columns + i]);
-                    partial_2 += static_cast<NumType>(vector[i] * matrix[(start + 1) * columns + i]);
+#pragma omp for schedule(static)
+                    for (size_t ic = 0; ic < rows; ic += MC) {
+                        size_t const mc = rows - ic < MC ? rows - ic : MC;
+                        gemm_pack_a(matrix_a + ic * shared + pc, packed_a.data(), shared, mc, kc);
+
+                        for (size_t jp = 0; jp < b_panels; ++jp) {
+                            size_t const jr = jp * NR;
+                            size_t const nr = nc - jr < NR ? nc - jr : NR;
+
+                            for (size_t ir = 0; ir < mc; ir += MR) {
+                                size_t const mr = mc - ir < MR ? mc - ir : MR;
+                                gemm_micro_kernel(
+                                    packed_a.data() + ir * kc,
+                                    packed_b.data() + jp * NR * kc,
+                                    dest + (ic + ir) * columns + jc + jr,
+                                    columns,
+                                    kc,
+                                    mr,
+                                    nr,
+                                    alpha,
+                                    pass_beta);
+                            }
+                        }
+                    }
                 }
+            }
+        }
+    }
+
+    template<typename NumType>
+    using gemv_candidate = void (*)(
+        const NumType *matrix,
+        const NumType *vector,
+        NumType *dest,
+        NumType alpha,
+        NumType beta,
+        size_t rows,
+        size_t columns,
+        size_t leading_dimension);
+
+    /**
+     * the gemv kernels the tuner and func_pos choose from, in the order of gemv_kernel_names
+     */
+    template<typename NumType>
+    const std::array<gemv_candidate<NumType>, GEMV_KERNEL_COUNT> &gemv_candidates() {
+        static const std::array<gemv_candidate<NumType>, GEMV_KERNEL_COUNT> candidates{
+            gemv_naive<NumType>,
+            gemv_parallel<NumType>,
+            gemv_parallel_simd<NumType>,
+            gemv_blocked<NumType, 2, 0>,
+            gemv_blocked<NumType, 4, 0>,
+            gemv_blocked<NumType, 8, 0>,
+            gemv_blocked<NumType, 2, GEMV_TILE_BYTES>,
+            gemv_blocked<NumType, 4, GEMV_TILE_BYTES>,
+            gemv_blocked<NumType, 8, GEMV_TILE_BYTES>,
+        };
+
+        return candidates;
+    }
+
+#define TUNING_REPETITIONS 3
+
+    /**
+     * times every candidate on the given operands, writing into a scratch result so the caller's result
+     * is untouched
+     *
+     * @return the index of the fastest candidate
+     */
+    template<typename NumType>
+    size_t fastest_gemv(const NumType *mat, const NumType *vec, size_t const rows, size_t const columns,
+                        size_t const leading_dimension) {
+        std::vector<NumType> scratch(rows);
+        size_t best{DEFAULT_GEMV_KERNEL};
+        auto best_time{std::chrono::steady_clock::duration::max()};
+
+        for (size_t kernel{0}; kernel < GEMV_KERNEL_COUNT; ++kernel) {
+            auto kernel_time{std::chrono::steady_clock::duration::max()};
+
+            for (size_t rep{0}; rep < TUNING_REPETITIONS; ++rep) {
+                auto const start{std::chrono::steady_clock::now()};
+                gemv_candidates<NumType>()[kernel](
+                    mat, vec, scratch.data(), static_cast<NumType>(1), static_cast<NumType>(0), rows, columns,
+                    leading_dimension);
+                kernel_time = std::min(kernel_time, std::chrono::steady_clock::now() - start);
+            }
 
-                dest[start] = static_cast<NumType>(dest[start] * beta + partial * alpha);
-                dest[start + 1] = static_cast<NumType>(dest[start + 1] * beta + partial_2 * alpha);
+            if (kernel_time < best_time) {
+                best_time = kernel_time;
+                best = kernel;
             }
         }
+
+        return best;
     }
 
 #ifdef BENCHMARK
@@ -136,31 +1442,44 @@ namespace cobraml::core {
         const NumType alpha,
         const NumType beta,
         size_t const rows,
+        size_t const columns,
+        size_t const leading_dimension) {
+        if (func_pos >= GEMV_KERNEL_COUNT) {
+            throw std::runtime_error("invalid gemv type provided");
+        }
+
+        gemv_candidates<NumType>()[func_pos](mat, vec, dest, alpha, beta, rows, columns, leading_dimension);
+    }
+
+    template<typename NumType>
+    void benchmarked_gemm(
+        const NumType *mat_a,
+        const NumType *mat_b,
+        NumType *dest,
+        const NumType alpha,
+        const NumType beta,
+        size_t const rows,
+        size_t const shared,
         size_t const columns) {
         switch (func_pos) {
             case 0: {
-                gemv_naive(mat, vec, dest, alpha, beta, rows, columns);
+                gemm_naive(mat_a, mat_b, dest, alpha, beta, rows, shared, columns);
                 return;
             }
             case 1: {
-                gemv_parallel(mat, vec, dest, alpha, beta, rows, columns);
-                return;
-            }
-            case 2: {
-                gemv_parallel_simd(mat, vec, dest, alpha, beta, rows, columns);
-                return;
-            }
-            case 3: {
-                gemv_parallel_simd_2(mat, vec, dest, alpha, beta, rows, columns);
+                gemm_parallel_blocked(mat_a, mat_b, dest, alpha, beta, rows, shared, columns);
                 return;
             }
             default: {
-                throw std::runtime_error("invalid gemv type provided");
+                throw std::runtime_error("invalid gemm type provided");
             }
         }
     }
 
 #else
+    /**
+     * dispatches through the tuning table, untuned shapes use the default kernel unless autotuning is on
+     */
     template<typename NumType>
     void benchmarked_gemv(
         const NumType *mat,
@@ -169,12 +1488,40 @@ namespace cobraml::core {
         const NumType alpha,
         const NumType beta,
         size_t const rows,
+        size_t const columns,
+        size_t const leading_dimension) {
+        TuningKey const key{make_tuning_key(get_dtype_from_type<NumType>::type, rows, columns)};
+        size_t kernel;
+
+        if (!find_gemv_kernel(key, kernel)) {
+            kernel = DEFAULT_GEMV_KERNEL;
+
+            if (get_autotuning()) {
+                kernel = fastest_gemv(mat, vec, rows, columns, leading_dimension);
+                // a gemv must not fail because the tuning file is unwritable, the table still holds the result
+                record_gemv_kernel(key, kernel, true);
+            }
+        }
+
+        gemv_candidates<NumType>()[kernel](mat, vec, dest, alpha, beta, rows, columns, leading_dimension);
+    }
+
+    template<typename NumType>
+    void benchmarked_gemm(
+        const NumType *mat_a,
+        const NumType *mat_b,
+        NumType *dest,
+        const NumType alpha,
+        const NumType beta,
+        size_t const rows,
+        size_t const shared,
         size_t const columns) {
-        gemv_parallel_simd_2(mat, vec, dest, alpha, beta, rows, columns);
+        gemm_parallel_blocked(mat_a, mat_b, dest, alpha, beta, rows, shared, columns);
     }
 #endif
 
-    class StandardMath final : public Math {
+    class StandardMath : public Math {
+    protected:
         void gemv(
             const void *matrix,
             const void *vector,
@@ -183,7 +1530,144 @@ namespace cobraml::core {
             const void *beta,
             size_t rows,
             size_t columns,
+            size_t leading_dimension,
+            bool transpose,
+            Dtype dtype) override;
+
+        void gemm(
+            const void *matrix_a,
+            const void *matrix_b,
+            void *dest,
+            const void *alpha,
+            const void *beta,
+            size_t rows,
+            size_t shared,
+            size_t columns,
+            Dtype dtype) override;
+
+        void gemv_batched(
+            const void *matrix,
+            const void *queries,
+            void *dest,
+            const void *alpha,
+            const void *beta,
+            size_t rows,
+            size_t columns,
+            size_t query_count,
+            Dtype dtype) override;
+
+        void gemv_topk(
+            const void *matrix,
+            const void *vector,
+            int64_t *indices,
+            void *scores,
+            const void *alpha,
+            size_t rows,
+            size_t columns,
+            size_t k,
+            Dtype dtype) override;
+
+        void row_norms(
+            const void *matrix,
+            void *dest,
+            size_t rows,
+            size_t columns,
+            Dtype dtype) override;
+
+        void gemv_cosine(
+            const void *matrix,
+            const void *vector,
+            const void *norms,
+            void *dest,
+            const void *alpha,
+            const void *beta,
+            size_t rows,
+            size_t columns,
+            Dtype dtype) override;
+
+        void quantize_rows(
+            const float *matrix,
+            int8_t *dest,
+            float *scales,
+            int32_t *zero_points,
+            size_t rows,
+            size_t columns) override;
+
+        void dequantize_rows(
+            const int8_t *matrix,
+            const float *scales,
+            const int32_t *zero_points,
+            float *dest,
+            size_t rows,
+            size_t columns) override;
+
+        void quantized_gemv(
+            const int8_t *matrix,
+            const float *scales,
+            const int32_t *zero_points,
+            const float *vector,
+            float *dest,
+            float alpha,
+            float beta,
+            size_t rows,
+            size_t columns) override;
+
+        void sparse_gemv(
+            const int64_t *row_pointers,
+            const int64_t *column_indices,
+            const void *values,
+            const void *vector,
+            void *dest,
+            const void *alpha,
+            const void *beta,
+            size_t rows,
+            Dtype dtype) override;
+
+        void sparse_query_gemv(
+            const void *matrix,
+            const int64_t *indices,
+            const void *values,
+            void *dest,
+            const void *alpha,
+            const void *beta,
+            size_t rows,
+            size_t columns,
+            size_t leading_dimension,
+            size_t nonzeros,
+            bool transpose,
+            Dtype dtype) override;
+
+        void dot(const void *x, const void *y, void *dest, size_t length, Dtype dtype) override;
+
+        void axpy(const void *alpha, const void *x, void *y, size_t length, Dtype dtype) override;
+
+        void scal(const void *alpha, void *x, size_t length, Dtype dtype) override;
+
+        void nrm2(const void *x, void *dest, size_t length, Dtype dtype) override;
+
+        void asum(const void *x, void *dest, size_t length, Dtype dtype) override;
+
+        size_t iamax(const void *x, size_t length, Dtype dtype) override;
+
+        void reduce_rows(
+            const void *matrix,
+            void *dest,
+            size_t rows,
+            size_t columns,
+            size_t leading_dimension,
+            Reduction reduction,
+            Dtype dtype) override;
+
+        void reduce_columns(
+            const void *matrix,
+            void *dest,
+            size_t rows,
+            size_t columns,
+            size_t leading_dimension,
+            Reduction reduction,
             Dtype dtype) override;
+
+        void first_touch(void *dest, size_t rows, size_t row_bytes, Dtype dtype) override;
     };
 }
 
@@ -0,0 +1,175 @@
+//
+// Created by sriram on 2/24/25.
+//
+
+#include "stream.h"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cobraml::core {
+
+    struct Stream::StreamImpl {
+        std::mutex mutex{};
+        std::condition_variable idle{};
+        std::deque<std::packaged_task<void()>> tasks{};
+        // the stream is queued on the pool or one of its tasks is running
+        bool scheduled{false};
+        size_t pending{0};
+    };
+
+    namespace {
+        /**
+         * Runs streams, one task of a stream at a time. A stream with pending work is queued once, after
+         * running its next task a worker puts it back at the end of the queue, so busy streams take turns.
+         */
+        class StreamPool {
+            std::mutex mutex{};
+            std::condition_variable ready{};
+            std::deque<std::shared_ptr<Stream::StreamImpl>> queue{};
+            std::vector<std::thread> workers{};
+            // streams with pending work, the pool grows toward this many workers up to its limit
+            size_t active{0};
+            bool stopping{false};
+
+            /**
+             * one worker per hardware thread, but at least two so a stream never has to wait for every other
+             * stream to drain
+             */
+            static size_t worker_limit() {
+                return std::max<size_t>(2, std::thread::hardware_concurrency());
+            }
+
+            void work() {
+                std::unique_lock lock{mutex};
+
+                while (true) {
+                    ready.wait(lock, [this] { return stopping || !queue.empty(); });
+
+                    if (queue.empty()) {
+                        return;
+                    }
+
+                    std::shared_ptr<Stream::StreamImpl> stream{std::move(queue.front())};
+                    queue.pop_front();
+                    lock.unlock();
+
+                    bool const more{run_next(*stream)};
+
+                    lock.lock();
+                    if (more) {
+                        queue.push_back(std::move(stream));
+                        ready.notify_one();
+                    } else {
+                        --active;
+                    }
+                }
+            }
+
+            /**
+             * @return whether the stream has more tasks
+             */
+            static bool run_next(Stream::StreamImpl &stream) {
+                std::packaged_task<void()> task;
+                {
+                    std::lock_guard guard{stream.mutex};
+                    task = std::move(stream.tasks.front());
+                    stream.tasks.pop_front();
+                }
+
+                task();
+
+                std::lock_guard guard{stream.mutex};
+                --stream.pending;
+
+                if (stream.tasks.empty()) {
+                    stream.scheduled = false;
+                    stream.idle.notify_all();
+                    return false;
+                }
+
+                return true;
+            }
+
+        public:
+            StreamPool() = default;
+
+            size_t worker_count() {
+                std::lock_guard guard{mutex};
+                return workers.size();
+            }
+
+            StreamPool(const StreamPool &other) = delete;
+            StreamPool &operator=(const StreamPool &other) = delete;
+
+            ~StreamPool() {
+                {
+                    std::lock_guard guard{mutex};
+                    stopping = true;
+                }
+
+                ready.notify_all();
+                for (auto &worker: workers) {
+                    worker.join();
+                }
+            }
+
+            void schedule(std::shared_ptr<Stream::StreamImpl> stream) {
+                std::lock_guard guard{mutex};
+                queue.push_back(std::move(stream));
+
+                if (++active > workers.size() && workers.size() < worker_limit()) {
+                    workers.emplace_back(&StreamPool::work, this);
+                }
+
+                ready.notify_one();
+            }
+        };
+
+        StreamPool &stream_pool() {
+            static StreamPool pool;
+            return pool;
+        }
+    }
+
+    Stream::Stream(): impl(std::make_shared<StreamImpl>()) {
+        // the pool has to outlive every stream
+        stream_pool();
+    }
+
+    Stream::~Stream() {
+        synchronize();
+    }
+
+    Event Stream::enqueue(std::function<void()> work) {
+        std::packaged_task<void()> task{std::move(work)};
+        Event event{task.get_future().share()};
+        bool schedule;
+
+        {
+            std::lock_guard guard{impl->mutex};
+            impl->tasks.push_back(std::move(task));
+            ++impl->pending;
+            schedule = !impl->scheduled;
+            impl->scheduled = true;
+        }
+
+        if (schedule) {
+            stream_pool().schedule(impl);
+        }
+
+        return event;
+    }
+
+    size_t stream_workers() {
+        return stream_pool().worker_count();
+    }
+
+    void Stream::synchronize() const {
+        std::unique_lock lock{impl->mutex};
+        impl->idle.wait(lock, [this] { return impl->pending == 0; });
+    }
+}
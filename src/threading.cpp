@@ -0,0 +1,168 @@
+//
+// Created by sriram on 2/16/25.
+//
+
+#include "threading.h"
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <omp.h>
+#include <sched.h>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace cobraml::core {
+
+#define DEFAULT_PARALLEL_THRESHOLD (1 << 15)
+
+    static std::atomic<size_t> configured_threads{0};
+    static std::atomic<size_t> parallel_threshold{DEFAULT_PARALLEL_THRESHOLD};
+    static std::atomic<bool> pinning{false};
+
+    // bumped on every change that affects pinning, each calling thread re-pins its team when it lags behind
+    static std::atomic<unsigned> pinning_generation{0};
+
+    /**
+     * the process affinity mask when the library first needed it
+     */
+    static const cpu_set_t &process_mask() {
+        static const cpu_set_t mask = [] {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+
+            if (sched_getaffinity(0, sizeof(set), &set) != 0) {
+                auto const procs{static_cast<size_t>(omp_get_num_procs())};
+                for (size_t cpu = 0; cpu < procs && cpu < CPU_SETSIZE; ++cpu)
+                    CPU_SET(cpu, &set);
+            }
+
+            return set;
+        }();
+
+        return mask;
+    }
+
+    static const std::vector<size_t> &allowed_cpus() {
+        static const std::vector<size_t> cpus = [] {
+            std::vector<size_t> ret;
+            for (size_t cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &process_mask()))
+                    ret.push_back(cpu);
+            }
+
+            return ret;
+        }();
+
+        return cpus;
+    }
+
+    static bool read_topology(size_t const cpu, const char *name, long &value) {
+        std::ifstream file("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/" + name);
+        return static_cast<bool>(file >> value);
+    }
+
+    /**
+     * counts distinct (package, core) pairs among the allowed cpus, 0 if the topology is not readable
+     */
+    static size_t physical_cores() {
+        std::set<std::pair<long, long> > cores;
+
+        for (size_t const cpu: allowed_cpus()) {
+            long package, core;
+            if (!read_topology(cpu, "physical_package_id", package) || !read_topology(cpu, "core_id", core))
+                return 0;
+
+            cores.emplace(package, core);
+        }
+
+        return cores.size();
+    }
+
+    size_t default_thread_count() {
+        static const size_t count = [] () -> size_t {
+#ifdef NUM_THREADS
+            return NUM_THREADS;
+#else
+            if (const char *env = std::getenv("OMP_NUM_THREADS")) {
+                if (long const parsed = std::strtol(env, nullptr, 10); parsed > 0)
+                    return static_cast<size_t>(parsed);
+            }
+
+            if (size_t const cores = physical_cores(); cores > 0)
+                return cores;
+
+            return allowed_cpus().empty() ? 1 : allowed_cpus().size();
+#endif
+        }();
+
+        return count;
+    }
+
+    void set_thread_count(size_t const count) {
+        configured_threads.store(count);
+        ++pinning_generation;
+    }
+
+    size_t get_thread_count() {
+        size_t const count = configured_threads.load();
+        return count == 0 ? default_thread_count() : count;
+    }
+
+    void set_thread_pinning(bool const enabled) {
+        pinning.store(enabled);
+        ++pinning_generation;
+    }
+
+    bool get_thread_pinning() {
+        return pinning.load();
+    }
+
+    void set_parallel_threshold(size_t const work) {
+        parallel_threshold.store(work);
+    }
+
+    size_t get_parallel_threshold() {
+        return parallel_threshold.load();
+    }
+
+    /**
+     * pins or unpins the team of the calling thread, OpenMP keeps reusing the same team threads so this
+     * only has to happen after the configuration changes
+     */
+    static void apply_pinning(int const threads) {
+        thread_local unsigned applied_generation{0};
+        thread_local bool pinned{false};
+
+        unsigned const generation{pinning_generation.load()};
+        bool const enabled{pinning.load()};
+
+        if (applied_generation == generation || (!enabled && !pinned))
+            return;
+
+        const std::vector<size_t> &cpus{allowed_cpus()};
+        if (cpus.empty())
+            return;
+
+#pragma omp parallel default(none) shared(cpus, enabled) num_threads(threads)
+        {
+            if (enabled) {
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                CPU_SET(cpus[static_cast<size_t>(omp_get_thread_num()) % cpus.size()], &set);
+                sched_setaffinity(0, sizeof(set), &set);
+            } else {
+                sched_setaffinity(0, sizeof(cpu_set_t), &process_mask());
+            }
+        }
+
+        applied_generation = generation;
+        pinned = enabled;
+    }
+
+    void set_num_threads(size_t const work) {
+        int const threads{work < parallel_threshold.load() ? 1 : static_cast<int>(get_thread_count())};
+        apply_pinning(static_cast<int>(get_thread_count()));
+        omp_set_num_threads(threads);
+    }
+}
@@ -0,0 +1,213 @@
+//
+// Created by sriram on 2/14/25.
+//
+
+#include <cmath>
+#include <thread>
+#include <gtest/gtest.h>
+#include "allocation.h"
+#include "matrix.h"
+
+TEST(AllocationTest, test_default_kind) {
+    ASSERT_EQ(cobraml::core::get_allocator_kind(cobraml::core::CPU), cobraml::core::STANDARD);
+
+    const cobraml::core::AllocatorStats before{cobraml::core::get_allocator_stats(cobraml::core::GPU)};
+    { cobraml::core::Matrix const mat(10, 10, cobraml::core::GPU, cobraml::core::FLOAT32); }
+    const cobraml::core::AllocatorStats after{cobraml::core::get_allocator_stats(cobraml::core::GPU)};
+
+    ASSERT_EQ(before.misses, after.misses);
+    ASSERT_EQ(before.hits, after.hits);
+}
+
+TEST(AllocationTest, test_pooled_reuse) {
+    cobraml::core::set_allocator_kind(cobraml::core::CPU, cobraml::core::POOLED);
+    cobraml::core::release_retained_memory(cobraml::core::CPU);
+
+    const cobraml::core::AllocatorStats start{cobraml::core::get_allocator_stats(cobraml::core::CPU)};
+    ASSERT_EQ(start.bytes_retained, 0);
+
+    {
+        cobraml::core::Matrix const mat(1, 1000, cobraml::core::CPU, cobraml::core::FLOAT32);
+        mat[3].set_item(5.0f);
+    }
+
+    const cobraml::core::AllocatorStats first{cobraml::core::get_allocator_stats(cobraml::core::CPU)};
+    ASSERT_EQ(first.misses, start.misses + 1);
+    ASSERT_GE(first.bytes_retained, 4000);
+
+    // steady state, the same block keeps being handed out and comes back zeroed
+    for (int i = 0; i < 100; ++i) {
+        cobraml::core::Matrix const mat(1, 1000, cobraml::core::CPU, cobraml::core::FLOAT32);
+        ASSERT_EQ(mat[3].item<float>(), 0.0f);
+        mat[3].set_item(5.0f);
+    }
+
+    const cobraml::core::AllocatorStats steady{cobraml::core::get_allocator_stats(cobraml::core::CPU)};
+    ASSERT_EQ(steady.misses, first.misses);
+    ASSERT_EQ(steady.hits, first.hits + 100);
+    ASSERT_EQ(steady.bytes_retained, first.bytes_retained);
+
+    cobraml::core::release_retained_memory(cobraml::core::CPU);
+    ASSERT_EQ(cobraml::core::get_allocator_stats(cobraml::core::CPU).bytes_retained, 0);
+
+    cobraml::core::set_allocator_kind(cobraml::core::CPU, cobraml::core::STANDARD);
+}
+
+TEST(AllocationTest, test_pooled_large) {
+    cobraml::core::set_allocator_kind(cobraml::core::CPU, cobraml::core::POOLED);
+    const cobraml::core::AllocatorStats start{cobraml::core::get_allocator_stats(cobraml::core::CPU)};
+
+    // beyond the largest size class, allocated and freed directly
+    { cobraml::core::Matrix const mat(1 << 12, 1 << 12, cobraml::core::CPU, cobraml::core::FLOAT64); }
+
+    // a size that is not a multiple of the block alignment
+    {
+        cobraml::core::Matrix const mat(
+            1, (1 << 26) + 3, cobraml::core::CPU, cobraml::core::INT8, cobraml::core::UNINITIALIZED);
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(cobraml::core::get_buffer<int8_t>(mat)) % 64, 0);
+    }
+
+    const cobraml::core::AllocatorStats end{cobraml::core::get_allocator_stats(cobraml::core::CPU)};
+    ASSERT_EQ(end.misses, start.misses + 2);
+    ASSERT_EQ(end.bytes_retained, start.bytes_retained);
+
+    cobraml::core::set_allocator_kind(cobraml::core::CPU, cobraml::core::STANDARD);
+}
+
+TEST(AllocationTest, test_pooled_threads) {
+    cobraml::core::set_allocator_kind(cobraml::core::CPU_X, cobraml::core::POOLED);
+
+    // buffers allocated on one thread and released on another
+    std::vector<cobraml::core::Matrix> handed_over;
+    for (size_t i = 0; i < 64; ++i) {
+        handed_over.emplace_back(1, 100 + i, cobraml::core::CPU_X, cobraml::core::INT32);
+    }
+
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < 4; ++t) {
+        workers.emplace_back([t, &handed_over] {
+            for (size_t i = t * 16; i < (t + 1) * 16; ++i) {
+                handed_over[i] = cobraml::core::Matrix();
+            }
+
+            for (size_t i = 0; i < 200; ++i) {
+                cobraml::core::Matrix const mat(4, 64 * (i % 5 + 1), cobraml::core::CPU_X, cobraml::core::FLOAT32);
+                mat[0][1].set_item(1.0f);
+            }
+        });
+    }
+
+    for (auto &worker: workers) {
+        worker.join();
+    }
+
+    const cobraml::core::AllocatorStats stats{cobraml::core::get_allocator_stats(cobraml::core::CPU_X)};
+    ASSERT_GT(stats.hits, stats.misses);
+
+    cobraml::core::release_retained_memory(cobraml::core::CPU_X);
+    ASSERT_EQ(cobraml::core::get_allocator_stats(cobraml::core::CPU_X).bytes_retained, 0);
+
+    cobraml::core::set_allocator_kind(cobraml::core::CPU_X, cobraml::core::STANDARD);
+}
+
+TEST(AllocationTest, test_first_touch) {
+    for (const auto device: {cobraml::core::CPU, cobraml::core::CPU_X}) {
+        cobraml::core::Matrix const mat(37, 29, device, cobraml::core::FLOAT64, cobraml::core::FIRST_TOUCH);
+        const double *buff = cobraml::core::get_buffer<double>(mat);
+
+        for (size_t i = 0; i < 37 * 29; ++i) {
+            ASSERT_EQ(buff[i], 0.0);
+        }
+
+        cobraml::core::Matrix const vec(1, 101, device, cobraml::core::INT16, cobraml::core::FIRST_TOUCH);
+        const int16_t *vec_buff = cobraml::core::get_buffer<int16_t>(vec);
+
+        for (size_t i = 0; i < 101; ++i) {
+            ASSERT_EQ(vec_buff[i], 0);
+        }
+
+        cobraml::core::Array const arr(13, device, cobraml::core::INT32, cobraml::core::FIRST_TOUCH);
+        for (size_t i = 0; i < 13; ++i) {
+            ASSERT_EQ(arr[i].item<int32_t>(), 0);
+        }
+    }
+}
+
+TEST(AllocationTest, test_uninitialized_gemv) {
+    const auto mat = cobraml::core::from_vector<float>({{1, 2, 3}, {4, 5, 6}}, cobraml::core::CPU);
+
+    for (const auto device: {cobraml::core::CPU, cobraml::core::CPU_X}) {
+        cobraml::core::Matrix result(1, 2, device, cobraml::core::FLOAT32, cobraml::core::UNINITIALIZED);
+
+        // β = 0 must overwrite y without reading it, even when it holds NaN
+        result[0].set_item(std::nanf(""));
+        result[1].set_item(std::nanf(""));
+
+        const auto mat_d = cobraml::core::from_vector<float>({{1, 2, 3}, {4, 5, 6}}, device);
+        const auto vec_d = cobraml::core::from_vector<float>({{1, 1, 1}}, device);
+        gemv(mat_d, vec_d, result, 2.0f, 0.0f);
+
+        ASSERT_EQ(result[0].item<float>(), 12.0f);
+        ASSERT_EQ(result[1].item<float>(), 30.0f);
+    }
+
+    cobraml::core::Matrix batched(2, 2, cobraml::core::CPU, cobraml::core::FLOAT32, cobraml::core::UNINITIALIZED);
+    batched[0][0].set_item(std::nanf(""));
+    const auto queries = cobraml::core::from_vector<float>({{1, 1, 1}, {1, 0, 0}}, cobraml::core::CPU);
+    gemv_batched(mat, queries, batched, 1.0f, 0.0f);
+    ASSERT_EQ(batched[0][0].item<float>(), 6.0f);
+    ASSERT_EQ(batched[1][1].item<float>(), 4.0f);
+}
+
+TEST(AllocationTest, test_huge_pages) {
+    const cobraml::core::HugePageMode mode{cobraml::core::get_huge_page_mode()};
+    const size_t threshold{cobraml::core::get_huge_page_threshold()};
+
+    cobraml::core::set_huge_page_mode(cobraml::core::TRANSPARENT_HUGE_PAGES, 4 << 20);
+    const cobraml::core::HugePageStats before{cobraml::core::get_huge_page_stats()};
+
+    {
+        // 8 MB, above the threshold
+        cobraml::core::Matrix const mat(1024, 1024, cobraml::core::CPU, cobraml::core::FLOAT64);
+        const double *buff = cobraml::core::get_buffer<double>(mat);
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(buff) % (2 << 20), 0);
+
+        const cobraml::core::HugePageStats during{cobraml::core::get_huge_page_stats()};
+        ASSERT_EQ(during.buffers, before.buffers + 1);
+        ASSERT_EQ(during.bytes, before.bytes + (8 << 20));
+
+        for (size_t i = 0; i < 1024 * 1024; ++i) {
+            ASSERT_EQ(buff[i], 0.0);
+        }
+
+        mat[1023][1023].set_item(4.0);
+        ASSERT_EQ(mat[1023][1023].item<double>(), 4.0);
+        ASSERT_LE(cobraml::core::huge_page_bytes(mat), static_cast<size_t>(8 << 20));
+
+        // below the threshold
+        cobraml::core::Matrix const small(10, 10, cobraml::core::CPU, cobraml::core::FLOAT64);
+        ASSERT_EQ(cobraml::core::get_huge_page_stats().buffers, before.buffers + 1);
+        ASSERT_EQ(cobraml::core::huge_page_bytes(small), 0);
+    }
+
+    ASSERT_EQ(cobraml::core::get_huge_page_stats().buffers, before.buffers);
+
+    // without reserved hugetlbfs pages the request falls back to transparent huge pages
+    cobraml::core::set_huge_page_mode(cobraml::core::HUGETLBFS_PAGES, 4 << 20);
+    {
+        cobraml::core::Matrix const mat(1, 1 << 20, cobraml::core::CPU, cobraml::core::FLOAT32,
+                                        cobraml::core::FIRST_TOUCH);
+        const cobraml::core::HugePageStats during{cobraml::core::get_huge_page_stats()};
+        ASSERT_EQ(during.buffers, before.buffers + 1);
+        ASSERT_EQ(during.hugetlbfs_buffers + during.fallback_buffers,
+                  before.hugetlbfs_buffers + before.fallback_buffers + 1);
+    }
+
+    cobraml::core::set_huge_page_mode(cobraml::core::NO_HUGE_PAGES, 4 << 20);
+    {
+        cobraml::core::Matrix const mat(1024, 1024, cobraml::core::CPU, cobraml::core::FLOAT64);
+        ASSERT_EQ(cobraml::core::get_huge_page_stats().buffers, before.buffers);
+    }
+
+    cobraml::core::set_huge_page_mode(mode, threshold);
+}
@@ -154,3 +154,62 @@ TEST(ArrayTestFunctionals, test_copy_assigment) {
 }
 
 
+
+TEST(ArrayTestFunctionals, test_move) {
+    std::vector const vec{0, 1, 2, 3, 4, 5};
+    cobraml::core::Array arr{from_vector(vec, cobraml::core::Device::CPU, cobraml::core::Dtype::INT32)};
+    const int *data{cobraml::core::get_buffer<int>(arr)};
+
+    static_assert(std::is_nothrow_move_constructible_v<cobraml::core::Array>);
+    static_assert(std::is_nothrow_move_assignable_v<cobraml::core::Array>);
+
+    cobraml::core::Array moved{std::move(arr)};
+    ASSERT_EQ(cobraml::core::get_buffer<int>(moved), data);
+    ASSERT_EQ(moved.len(), vec.size());
+
+    // a moved from array can be assigned again
+    arr = moved;
+    ASSERT_EQ(cobraml::core::get_buffer<int>(arr), data);
+
+    cobraml::core::Array other{from_vector(vec, cobraml::core::Device::CPU, cobraml::core::Dtype::INT32)};
+    other = std::move(moved);
+    ASSERT_EQ(cobraml::core::get_buffer<int>(other), data);
+}
+
+TEST(ArrayTestFunctionals, from_vector_adopt) {
+    std::vector vec{1.5f, 2.22f, 3.33f, 4.26f};
+    const float *storage{vec.data()};
+
+    const cobraml::core::Array arr{
+        from_vector(std::move(vec), cobraml::core::Device::CPU, cobraml::core::Dtype::FLOAT32)};
+
+    ASSERT_EQ(cobraml::core::get_buffer<float>(arr), storage);
+    ASSERT_EQ(arr.len(), 4);
+    ASSERT_EQ(arr[2].item<float>(), 3.33f);
+
+    // a mismatched dtype falls back to the copying overload, which rejects it
+    ASSERT_THROW(
+        from_vector(std::vector{1, 2}, cobraml::core::Device::CPU, cobraml::core::Dtype::INT8), std::runtime_error);
+}
+
+TEST(ArrayTestFunctionals, wrap) {
+    std::vector<double> external{0.5, 1.5, 2.5};
+    size_t released{0};
+
+    {
+        const cobraml::core::Array arr{cobraml::core::wrap(
+            external.data(), external.size(), cobraml::core::Device::CPU, cobraml::core::Dtype::FLOAT64,
+            [&released]() { ++released; })};
+
+        ASSERT_EQ(cobraml::core::get_buffer<double>(arr), external.data());
+        ASSERT_EQ(arr[1].item<double>(), 1.5);
+        ASSERT_EQ(released, 0);
+    }
+
+    ASSERT_EQ(released, 1);
+
+    ASSERT_THROW(
+        cobraml::core::wrap(
+            external.data(), 0, cobraml::core::Device::CPU, cobraml::core::Dtype::FLOAT64, std::function<void()>{}),
+        std::runtime_error);
+}
@@ -0,0 +1,256 @@
+//
+// Created by sriram on 2/27/25.
+//
+
+#include <cstring>
+#include <gtest/gtest.h>
+#include "cml_c_api.h"
+#include "dlpack_exchange.h"
+
+static size_t deleter_calls{0};
+
+static void count_deleter(DLManagedTensor *) {
+    ++deleter_calls;
+}
+
+/**
+ * a tensor owned by another framework, its deleter only counts calls since the memory lives on the test's stack
+ */
+template<typename T>
+struct ForeignTensor {
+    std::vector<T> values;
+    std::vector<int64_t> shape;
+    std::vector<int64_t> strides{};
+    DLManagedTensor tensor{};
+
+    ForeignTensor(std::vector<T> values, std::vector<int64_t> shape, DLDataType const dtype):
+        values(std::move(values)), shape(std::move(shape)) {
+        tensor.dl_tensor.data = this->values.data();
+        tensor.dl_tensor.device = {kDLCPU, 0};
+        tensor.dl_tensor.ndim = static_cast<int32_t>(this->shape.size());
+        tensor.dl_tensor.dtype = dtype;
+        tensor.dl_tensor.shape = this->shape.data();
+        tensor.dl_tensor.strides = nullptr;
+        tensor.dl_tensor.byte_offset = 0;
+        tensor.deleter = count_deleter;
+    }
+};
+
+TEST(DLPackTest, export_shares_buffer) {
+    const std::vector<std::vector<float>> values{{1, 2, 3}, {4, 5, 6}};
+    DLManagedTensor *tensor;
+
+    {
+        const auto matrix = cobraml::core::from_vector(values, cobraml::core::CPU);
+        tensor = cobraml::core::to_dlpack(matrix);
+
+        ASSERT_EQ(tensor->dl_tensor.data, cobraml::core::get_buffer<float>(matrix));
+    }
+
+    // the tensor keeps the buffer alive after the matrix is gone
+    const DLTensor &dl{tensor->dl_tensor};
+    ASSERT_EQ(dl.device.device_type, kDLCPU);
+    ASSERT_EQ(dl.ndim, 2);
+    ASSERT_EQ(dl.dtype.code, kDLFloat);
+    ASSERT_EQ(dl.dtype.bits, 32);
+    ASSERT_EQ(dl.dtype.lanes, 1);
+    ASSERT_EQ(dl.shape[0], 2);
+    ASSERT_EQ(dl.shape[1], 3);
+    ASSERT_EQ(dl.strides[0], 3);
+    ASSERT_EQ(dl.strides[1], 1);
+    ASSERT_EQ(dl.byte_offset, 0);
+
+    const auto *data{static_cast<const float *>(dl.data)};
+    for (size_t i = 0; i < 6; ++i)
+        ASSERT_EQ(data[i], values[i / 3][i % 3]);
+
+    tensor->deleter(tensor);
+}
+
+TEST(DLPackTest, export_view) {
+    std::vector mat(4, std::vector<int32_t>(6));
+    for (size_t i = 0; i < 4; ++i)
+        for (size_t j = 0; j < 6; ++j)
+            mat[i][j] = static_cast<int32_t>(i * 6 + j);
+
+    const auto matrix = cobraml::core::from_vector(mat, cobraml::core::CPU);
+    DLManagedTensor *tensor{cobraml::core::to_dlpack(matrix.slice(1, 3, 2, 5))};
+    const DLTensor &dl{tensor->dl_tensor};
+
+    ASSERT_EQ(dl.shape[0], 2);
+    ASSERT_EQ(dl.shape[1], 3);
+    ASSERT_EQ(dl.strides[0], 6);
+    ASSERT_EQ(dl.dtype.code, kDLInt);
+    ASSERT_EQ(static_cast<const int32_t *>(dl.data), cobraml::core::get_buffer<int32_t>(matrix) + 8);
+
+    // importing our own tensor hands back the view
+    const auto view = cobraml::core::from_dlpack(tensor);
+    ASSERT_EQ(view.get_shape().rows, 2);
+    ASSERT_EQ(view.get_shape().columns, 3);
+
+    for (size_t i = 0; i < 2; ++i)
+        for (size_t j = 0; j < 3; ++j)
+            ASSERT_EQ(view[i][j].item<int32_t>(), mat[i + 1][j + 2]);
+
+    ASSERT_THROW(static_cast<void>(cobraml::core::to_dlpack(cobraml::core::Matrix())), std::runtime_error);
+}
+
+TEST(DLPackTest, round_trip) {
+    auto matrix = cobraml::core::from_vector<double>({{1, 2}, {3, 4}}, cobraml::core::CPU);
+    const double *data{cobraml::core::get_buffer<double>(matrix)};
+
+    const auto same = cobraml::core::from_dlpack(cobraml::core::to_dlpack(matrix));
+    ASSERT_EQ(cobraml::core::get_buffer<double>(same), data);
+
+    // a different device goes through the generic path but still shares the memory
+    const auto accelerated = cobraml::core::from_dlpack(cobraml::core::to_dlpack(matrix), cobraml::core::CPU_X);
+    ASSERT_EQ(accelerated.get_device(), cobraml::core::CPU_X);
+    ASSERT_EQ(cobraml::core::get_buffer<double>(accelerated), data);
+
+    matrix = cobraml::core::Matrix();
+    ASSERT_EQ(accelerated[1][1].item<double>(), 4);
+}
+
+TEST(DLPackTest, import_foreign) {
+    deleter_calls = 0;
+    ForeignTensor<float> foreign{{1, 2, 3, 4, 5, 6}, {3, 2}, {kDLFloat, 32, 1}};
+
+    {
+        const auto matrix = cobraml::core::from_dlpack(&foreign.tensor);
+        ASSERT_EQ(cobraml::core::get_buffer<float>(matrix), foreign.values.data());
+        ASSERT_EQ(matrix.get_shape().rows, 3);
+        ASSERT_EQ(matrix.get_shape().columns, 2);
+        ASSERT_EQ(matrix[2][0].item<float>(), 5);
+
+        const cobraml::core::Matrix copy{matrix};
+        ASSERT_EQ(deleter_calls, 0);
+    }
+
+    ASSERT_EQ(deleter_calls, 1);
+
+    // one dimensional tensors become a single row, unit dimensions may carry any stride
+    ForeignTensor<int16_t> vector{{7, 8, 9}, {3}, {kDLInt, 16, 1}};
+    vector.strides = {1};
+    vector.tensor.dl_tensor.strides = vector.strides.data();
+
+    {
+        const auto matrix = cobraml::core::from_dlpack(&vector.tensor);
+        ASSERT_EQ(matrix.get_shape().rows, 1);
+        ASSERT_EQ(matrix.get_dtype(), cobraml::core::INT16);
+        ASSERT_EQ(matrix[1].item<int16_t>(), 8);
+    }
+
+    ForeignTensor<uint16_t> row{{0x3f80, 0x4000}, {1, 2}, {kDLBfloat, 16, 1}};
+    row.strides = {99, 1};
+    row.tensor.dl_tensor.strides = row.strides.data();
+    ASSERT_EQ(cobraml::core::from_dlpack(&row.tensor).get_dtype(), cobraml::core::BFLOAT16);
+
+    ForeignTensor<uint16_t> half{{0x3c00}, {1, 1}, {kDLFloat, 16, 1}};
+    ASSERT_EQ(cobraml::core::from_dlpack(&half.tensor).get_dtype(), cobraml::core::FLOAT16);
+
+    ASSERT_EQ(deleter_calls, 4);
+}
+
+TEST(DLPackTest, import_misaligned) {
+    deleter_calls = 0;
+    const std::vector<float> values{1.5f, -2.5f};
+
+    ForeignTensor<float> foreign{std::vector<float>(3), {2}, {kDLFloat, 32, 1}};
+    std::memcpy(reinterpret_cast<char *>(foreign.values.data()) + 1, values.data(), 2 * sizeof(float));
+    foreign.tensor.dl_tensor.byte_offset = 1;
+
+    const auto matrix = cobraml::core::from_dlpack(&foreign.tensor);
+    ASSERT_EQ(deleter_calls, 1);
+    ASSERT_EQ(matrix[0].item<float>(), 1.5f);
+    ASSERT_EQ(matrix[1].item<float>(), -2.5f);
+}
+
+TEST(DLPackTest, import_invalid) {
+    deleter_calls = 0;
+
+    ForeignTensor<float> strided{std::vector<float>(8), {2, 2}, {kDLFloat, 32, 1}};
+    strided.strides = {4, 1};
+    strided.tensor.dl_tensor.strides = strided.strides.data();
+    ASSERT_THROW(static_cast<void>(cobraml::core::from_dlpack(&strided.tensor)), std::runtime_error);
+
+    ForeignTensor<float> transposed{std::vector<float>(4), {2, 2}, {kDLFloat, 32, 1}};
+    transposed.strides = {1, 2};
+    transposed.tensor.dl_tensor.strides = transposed.strides.data();
+    ASSERT_THROW(static_cast<void>(cobraml::core::from_dlpack(&transposed.tensor)), std::runtime_error);
+
+    ForeignTensor<float> cube{std::vector<float>(8), {2, 2, 2}, {kDLFloat, 32, 1}};
+    ASSERT_THROW(static_cast<void>(cobraml::core::from_dlpack(&cube.tensor)), std::runtime_error);
+
+    ForeignTensor<float> gpu{std::vector<float>(4), {4}, {kDLFloat, 32, 1}};
+    gpu.tensor.dl_tensor.device = {kDLCUDA, 0};
+    ASSERT_THROW(static_cast<void>(cobraml::core::from_dlpack(&gpu.tensor)), std::runtime_error);
+
+    ForeignTensor<float> lanes{std::vector<float>(4), {2}, {kDLFloat, 32, 2}};
+    ASSERT_THROW(static_cast<void>(cobraml::core::from_dlpack(&lanes.tensor)), std::runtime_error);
+
+    ForeignTensor<uint8_t> unsigned_bytes{std::vector<uint8_t>(4), {4}, {kDLUInt, 8, 1}};
+    ASSERT_THROW(static_cast<void>(cobraml::core::from_dlpack(&unsigned_bytes.tensor)), std::runtime_error);
+
+    ForeignTensor<float> empty{std::vector<float>(1), {0, 4}, {kDLFloat, 32, 1}};
+    ASSERT_THROW(static_cast<void>(cobraml::core::from_dlpack(&empty.tensor)), std::runtime_error);
+
+    // a rejected tensor still belongs to the caller
+    ASSERT_EQ(deleter_calls, 0);
+}
+
+TEST(DLPackTest, consumer_writes) {
+    const auto matrix = cobraml::core::from_vector<float>({{1, 0}, {0, 1}}, cobraml::core::CPU);
+    const auto vec = cobraml::core::from_vector<float>({{1, 0}}, cobraml::core::CPU);
+    cobraml::core::Matrix res(1, 2, cobraml::core::CPU, cobraml::core::FLOAT32);
+
+    gemv_cosine(matrix, vec, res, 1.0f, 0.0f);
+    ASSERT_FLOAT_EQ(res[0].item<float>(), 1);
+
+    // a consumer writing through an exported tensor must not leave stale norms behind
+    DLManagedTensor *tensor{cobraml::core::to_dlpack(matrix)};
+    static_cast<float *>(tensor->dl_tensor.data)[0] = 6;
+    gemv_cosine(matrix, vec, res, 1.0f, 0.0f);
+    ASSERT_FLOAT_EQ(res[0].item<float>(), 1);
+    tensor->deleter(tensor);
+
+    // nor may a producer writing an imported tensor
+    deleter_calls = 0;
+    ForeignTensor<float> foreign{{1, 0, 0, 1}, {2, 2}, {kDLFloat, 32, 1}};
+    const auto imported = cobraml::core::from_dlpack(&foreign.tensor);
+
+    gemv_cosine(imported, vec, res, 1.0f, 0.0f);
+    foreign.values[0] = 6;
+    gemv_cosine(imported, vec, res, 1.0f, 0.0f);
+    ASSERT_FLOAT_EQ(res[0].item<float>(), 1);
+}
+
+TEST(DLPackTest, c_api) {
+    deleter_calls = 0;
+    ForeignTensor<float> foreign{{1, 2, 3, 4}, {2, 2}, {kDLFloat, 32, 1}};
+
+    CmlMatrix *matrix{nullptr};
+    ASSERT_EQ(cml_matrix_from_dlpack(&foreign.tensor, 1, &matrix), 0);
+
+    size_t rows{0}, columns{0};
+    ASSERT_EQ(cml_matrix_shape(matrix, &rows, &columns), 0);
+    ASSERT_EQ(rows, 2);
+    ASSERT_EQ(columns, 2);
+
+    DLManagedTensor *exported{nullptr};
+    ASSERT_EQ(cml_matrix_to_dlpack(matrix, &exported), 0);
+    ASSERT_EQ(exported->dl_tensor.data, foreign.values.data());
+
+    cml_matrix_free(matrix);
+    ASSERT_EQ(deleter_calls, 0);
+    exported->deleter(exported);
+    ASSERT_EQ(deleter_calls, 1);
+
+    ForeignTensor<float> cube{std::vector<float>(8), {2, 2, 2}, {kDLFloat, 32, 1}};
+    matrix = nullptr;
+    ASSERT_EQ(cml_matrix_from_dlpack(&cube.tensor, 0, &matrix), -1);
+    ASSERT_EQ(matrix, nullptr);
+    ASSERT_STREQ(cml_last_error(), "only one and two dimensional tensors can be imported");
+
+    ASSERT_EQ(cml_matrix_shape(nullptr, &rows, &columns), -1);
+    cml_matrix_free(nullptr);
+}
@@ -2,6 +2,7 @@
 // Created by Sriram Govindan on 12/23/24.
 //
 
+#include <cmath>
 #include <gtest/gtest.h>
 
 #include "enums.h"
@@ -22,3 +23,55 @@ TEST(DTYPE, comp_operators) {
     ASSERT_GE(cobraml::core::FLOAT32, cobraml::core::INT64);
     ASSERT_GE(cobraml::core::FLOAT64, cobraml::core::FLOAT32);
 }
+
+TEST(DTYPE, half_precision) {
+    ASSERT_EQ(cobraml::core::dtype_to_bytes(cobraml::core::FLOAT16), 2);
+    ASSERT_EQ(cobraml::core::dtype_to_bytes(cobraml::core::BFLOAT16), 2);
+    ASSERT_EQ(cobraml::core::dtype_to_string(cobraml::core::BFLOAT16), "BFLOAT16");
+    ASSERT_TRUE(cobraml::core::is_half(cobraml::core::FLOAT16));
+    ASSERT_FALSE(cobraml::core::is_half(cobraml::core::FLOAT32));
+    ASSERT_TRUE(cobraml::core::FLOAT16 < cobraml::core::FLOAT32);
+    ASSERT_TRUE(cobraml::core::INT64 < cobraml::core::BFLOAT16);
+    ASSERT_EQ(cobraml::core::compute_dtype(cobraml::core::FLOAT16), cobraml::core::FLOAT32);
+    ASSERT_EQ(cobraml::core::compute_dtype(cobraml::core::INT8), cobraml::core::INT8);
+}
+
+TEST(DTYPE, float16_conversion) {
+    using cobraml::core::to_float;
+    using cobraml::core::to_float16;
+
+    ASSERT_EQ(to_float16(1.0f).bits, 0x3c00);
+    ASSERT_EQ(to_float16(-2.0f).bits, 0xc000);
+    ASSERT_EQ(to_float16(65504.0f).bits, 0x7bff);
+    ASSERT_EQ(to_float16(1e6f).bits, 0x7c00);
+    ASSERT_EQ(to_float16(0.0f).bits, 0x0000);
+
+    // smallest subnormal
+    ASSERT_EQ(to_float16(5.9604645e-8f).bits, 0x0001);
+    ASSERT_FLOAT_EQ(to_float(cobraml::core::float16{0x0001}), 5.9604645e-8f);
+
+    // 1 + 2^-11 sits halfway between 1 and the next half, ties go to even
+    ASSERT_EQ(to_float16(1.00048828125f).bits, 0x3c00);
+
+    ASSERT_TRUE(std::isinf(to_float(cobraml::core::float16{0x7c00})));
+    ASSERT_TRUE(std::isnan(to_float(cobraml::core::float16{0x7e00})));
+
+    for (uint32_t bits = 0; bits < 0x7c00; ++bits) {
+        cobraml::core::float16 const half{static_cast<uint16_t>(bits)};
+        ASSERT_EQ(to_float16(to_float(half)).bits, half.bits);
+    }
+}
+
+TEST(DTYPE, bfloat16_conversion) {
+    using cobraml::core::to_float;
+    using cobraml::core::to_bfloat16;
+
+    ASSERT_EQ(to_bfloat16(1.0f).bits, 0x3f80);
+    ASSERT_FLOAT_EQ(to_float(to_bfloat16(-3.5f)), -3.5f);
+
+    // 1 + 2^-8 sits halfway between 1 and the next bfloat16, ties go to even
+    ASSERT_EQ(to_bfloat16(1.00390625f).bits, 0x3f80);
+    ASSERT_EQ(to_bfloat16(1.01171875f).bits, 0x3f82);
+
+    ASSERT_TRUE(std::isnan(to_float(to_bfloat16(std::nanf("")))));
+}
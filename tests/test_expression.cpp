@@ -0,0 +1,139 @@
+//
+// Created by sriram on 2/22/25.
+//
+
+#include <gtest/gtest.h>
+#include "expression.h"
+#include "test_helpers.h"
+
+template<typename T>
+static void check_blend(cobraml::core::Device const device, size_t const rows, size_t const columns) {
+    auto const x{random_values<T>(rows, columns, 1)};
+    auto const y{random_values<T>(rows, columns, 2)};
+    auto const b{random_values<T>(1, columns, 3)};
+
+    const auto mat_x = cobraml::core::from_vector(x, device);
+    const auto mat_y = cobraml::core::from_vector(y, device);
+    const auto bias = cobraml::core::from_vector(b, device);
+    cobraml::core::Matrix result(rows, columns, device, cobraml::core::get_dtype_from_type<T>::type);
+
+    result = static_cast<T>(3) * mat_x + mat_y * static_cast<T>(2) - bias;
+
+    for (size_t i = 0; i < rows; ++i) {
+        const T *buff{cobraml::core::get_buffer<T>(result[i])};
+        for (size_t j = 0; j < columns; ++j) {
+            ASSERT_EQ(buff[j], static_cast<T>(3 * x[i][j] + y[i][j] * 2 - b[0][j]));
+        }
+    }
+}
+
+TEST(ExpressionTest, test_blend) {
+    for (cobraml::core::Device const device: {cobraml::core::CPU, cobraml::core::CPU_X}) {
+        check_blend<double>(device, 7, 5000);
+        check_blend<float>(device, 1, 9000);
+        check_blend<int8_t>(device, 3, 17);
+        check_blend<int16_t>(device, 33, 4);
+        check_blend<int32_t>(device, 1, 1);
+        check_blend<int64_t>(device, 12, 100);
+    }
+}
+
+TEST(ExpressionTest, test_operators) {
+    const auto x = cobraml::core::from_vector<float>({{-4, -1, 0, 2, 6}}, cobraml::core::CPU);
+    const auto y = cobraml::core::from_vector<float>({{2, 4, 1, 8, 3}}, cobraml::core::CPU);
+    cobraml::core::Matrix result(1, 5, cobraml::core::CPU, cobraml::core::FLOAT32);
+
+    result = x * y;
+    std::vector<float> expected{-8, -4, 0, 16, 18};
+    for (size_t i = 0; i < 5; ++i) ASSERT_EQ(result[i].item<float>(), expected[i]);
+
+    result = x / y - 1.0f;
+    expected = {-3, -1.25f, -1, -0.75f, 1};
+    for (size_t i = 0; i < 5; ++i) ASSERT_EQ(result[i].item<float>(), expected[i]);
+
+    result = -x;
+    expected = {4, 1, 0, -2, -6};
+    for (size_t i = 0; i < 5; ++i) ASSERT_EQ(result[i].item<float>(), expected[i]);
+
+    result = clamp(x * 0.5f, -1.0f, 1.0f);
+    expected = {-1, -0.5f, 0, 1, 1};
+    for (size_t i = 0; i < 5; ++i) ASSERT_EQ(result[i].item<float>(), expected[i]);
+
+    result = maximum(x, y) + minimum(x, 0.0f);
+    expected = {-2, 3, 1, 8, 6};
+    for (size_t i = 0; i < 5; ++i) ASSERT_EQ(result[i].item<float>(), expected[i]);
+
+    // the destination may appear in its own expression
+    result = result * 2.0f + result;
+    expected = {-6, 9, 3, 24, 18};
+    for (size_t i = 0; i < 5; ++i) ASSERT_EQ(result[i].item<float>(), expected[i]);
+}
+
+TEST(ExpressionTest, test_slice) {
+    std::vector mat(4, std::vector<int32_t>(6));
+    for (size_t i = 0; i < 4; ++i)
+        for (size_t j = 0; j < 6; ++j)
+            mat[i][j] = static_cast<int32_t>(i * 6 + j);
+
+    const auto matrix = cobraml::core::from_vector(mat, cobraml::core::CPU);
+    const auto source = matrix.slice(0, 2, 0, 3);
+    auto dest = matrix.slice(2, 4, 3, 6);
+
+    dest = source + 100;
+
+    for (size_t i = 0; i < 4; ++i) {
+        for (size_t j = 0; j < 6; ++j) {
+            int32_t const expected{i >= 2 && j >= 3 ? mat[i - 2][j - 3] + 100 : mat[i][j]};
+            ASSERT_EQ(matrix[i][j].item<int32_t>(), expected);
+        }
+    }
+}
+
+TEST(ExpressionTest, test_overlapping_destination) {
+    auto matrix = cobraml::core::from_vector<float>({{1, 2}, {3, 4}, {5, 6}}, cobraml::core::CPU);
+
+    // the first row is broadcast over the destination it belongs to
+    matrix = matrix + matrix.slice(0, 1, 0, 2);
+    std::vector<std::vector<float>> expected{{2, 4}, {4, 6}, {6, 8}};
+    for (size_t i = 0; i < 3; ++i)
+        for (size_t j = 0; j < 2; ++j)
+            ASSERT_EQ(matrix[i][j].item<float>(), expected[i][j]);
+
+    // a shifted slice of the destination
+    std::vector mat(4, std::vector<int32_t>(3));
+    for (size_t i = 0; i < 4; ++i)
+        for (size_t j = 0; j < 3; ++j)
+            mat[i][j] = static_cast<int32_t>(i * 3 + j);
+
+    const auto source = cobraml::core::from_vector(mat, cobraml::core::CPU_X);
+    auto dest = source.slice(1, 4, 0, 3);
+    dest = source.slice(0, 3, 0, 3) * 2;
+
+    for (size_t j = 0; j < 3; ++j)
+        ASSERT_EQ(source[0][j].item<int32_t>(), mat[0][j]);
+
+    for (size_t i = 1; i < 4; ++i)
+        for (size_t j = 0; j < 3; ++j)
+            ASSERT_EQ(source[i][j].item<int32_t>(), mat[i - 1][j] * 2);
+}
+
+TEST(ExpressionTest, test_invalid) {
+    const cobraml::core::Matrix x(2, 3, cobraml::core::CPU, cobraml::core::FLOAT32);
+    const cobraml::core::Matrix wrong_shape(3, 3, cobraml::core::CPU, cobraml::core::FLOAT32);
+    const cobraml::core::Matrix wrong_dtype(2, 3, cobraml::core::CPU, cobraml::core::FLOAT64);
+    const cobraml::core::Matrix wrong_device(2, 3, cobraml::core::CPU_X, cobraml::core::FLOAT32);
+    cobraml::core::Matrix result(2, 3, cobraml::core::CPU, cobraml::core::FLOAT32);
+    cobraml::core::Matrix half(2, 3, cobraml::core::CPU, cobraml::core::FLOAT16);
+
+    ASSERT_NO_THROW(result = x + 1.0f);
+    ASSERT_THROW(result = x + wrong_shape, std::runtime_error);
+    ASSERT_THROW(result = x + wrong_dtype, std::runtime_error);
+    ASSERT_THROW(result = x + wrong_device, std::runtime_error);
+    ASSERT_THROW(half = x + 1.0f, std::runtime_error);
+    ASSERT_THROW(result = x + 1.0, std::runtime_error);
+    ASSERT_THROW(result = x * 2, std::runtime_error);
+
+    // a float scalar is not silently truncated onto an integer destination
+    cobraml::core::Matrix integers(1, 2, cobraml::core::CPU, cobraml::core::INT32);
+    ASSERT_THROW(integers = integers * 0.5f, std::runtime_error);
+}
@@ -0,0 +1,29 @@
+//
+// Created by sriram on 2/25/25.
+//
+
+#ifndef TEST_HELPERS_H
+#define TEST_HELPERS_H
+
+#include <random>
+#include <vector>
+
+/**
+ * fills a rows x columns table with small integers drawn from [-bound, bound], the same seed always gives the
+ * same values. Small integers are exact in every dtype so results can be compared without a tolerance.
+ */
+template<typename T>
+std::vector<std::vector<T>> random_values(
+    size_t const rows, size_t const columns, unsigned const seed, int const bound = 8) {
+    std::vector mat(rows, std::vector<T>(columns));
+    std::uniform_int_distribution<> unif{-bound, bound};
+    std::default_random_engine gen{seed};
+
+    for (auto &row: mat)
+        for (auto &num: row)
+            num = static_cast<T>(unif(gen));
+
+    return mat;
+}
+
+#endif //TEST_HELPERS_H
@@ -3,10 +3,13 @@
 //
 
 
+#include <cstring>
 #include <random>
 #include <gtest/gtest.h>
 #include "matrix.h"
 #include "enums.h"
+#include "threading.h"
+#include "test_helpers.h"
 
 std::vector<std::vector<double> > create_vector(size_t const rows, size_t const columns) {
     std::vector ret(rows, std::vector(columns, 0.0));
@@ -349,3 +352,1171 @@ TEST_F(MatrixTest, gemv_large) {
 
     ASSERT_EQ(check_dot_product(_vec2, _mat2, res2_buff), true);
 }
+
+/**
+ ************************************* TEST GEMM *************************************************
+ */
+
+TEST(MatrixTestFunc, test_invalid_gemm) {
+    cobraml::core::Matrix const mat_a(10, 20, cobraml::core::CPU, cobraml::core::FLOAT32);
+    cobraml::core::Matrix const mat_b(20, 5, cobraml::core::CPU, cobraml::core::FLOAT32);
+    cobraml::core::Matrix res(10, 5, cobraml::core::CPU, cobraml::core::FLOAT32);
+
+    ASSERT_THROW(gemm(mat_a, mat_a, res, 1.0f, 0.0f), std::runtime_error);
+
+    cobraml::core::Matrix res2(5, 10, cobraml::core::CPU, cobraml::core::FLOAT32);
+    ASSERT_THROW(gemm(mat_a, mat_b, res2, 1.0f, 0.0f), std::runtime_error);
+
+    cobraml::core::Matrix const mat_b2(20, 5, cobraml::core::CPU, cobraml::core::FLOAT64);
+    ASSERT_THROW(gemm(mat_a, mat_b2, res, 1.0f, 0.0f), std::runtime_error);
+
+    cobraml::core::Matrix const mat_b3(20, 5, cobraml::core::CPU_X, cobraml::core::FLOAT32);
+    ASSERT_THROW(gemm(mat_a, mat_b3, res, 1.0f, 0.0f), std::runtime_error);
+
+    ASSERT_THROW(gemm(mat_a, mat_b, res, 1.0, 0.0), std::runtime_error);
+    ASSERT_NO_THROW(gemm(mat_a, mat_b, res, 1.0f, 0.0f));
+}
+
+TEST(MatrixTestFunc, gemm_alpha_beta) {
+    auto const mat_a{
+        std::vector<std::vector<int> >{
+            {1, 2, 3},
+            {4, 5, 6},
+        }
+    };
+
+    auto const mat_b{
+        std::vector<std::vector<int> >{
+            {1, 0},
+            {0, 1},
+            {2, 2},
+        }
+    };
+
+    auto const mat_c{
+        std::vector<std::vector<int> >{
+            {1, 1},
+            {2, 2},
+        }
+    };
+
+    const auto a = cobraml::core::from_vector<int>(mat_a, cobraml::core::CPU);
+    const auto b = cobraml::core::from_vector<int>(mat_b, cobraml::core::CPU);
+    auto c = cobraml::core::from_vector<int>(mat_c, cobraml::core::CPU);
+
+    gemm(a, b, c, 2, -1);
+
+    constexpr int expected[]{
+        13, 15, 30, 32
+    };
+
+    ASSERT_EQ(arr_eq(cobraml::core::get_buffer<int>(c), expected, 4), true);
+}
+
+TEST(MatrixTestFunc, gemm_large) {
+    // odd shapes so every tile dimension has a partial edge
+    constexpr size_t m{131};
+    constexpr size_t k{301};
+    constexpr size_t n{67};
+
+    auto const a_vec{create_vector(m, k)};
+    auto const b_vec{create_vector(k, n)};
+    auto const c_vec{create_vector(m, n)};
+
+    const auto a = cobraml::core::from_vector<double>(a_vec, cobraml::core::CPU);
+    const auto b = cobraml::core::from_vector<double>(b_vec, cobraml::core::CPU);
+    auto c = cobraml::core::from_vector<double>(c_vec, cobraml::core::CPU);
+
+    gemm(a, b, c, 1.0, 1.0);
+    const double *c_buff = cobraml::core::get_buffer<double>(c);
+
+    for (size_t i = 0; i < m; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            double expected = c_vec[i][j];
+            for (size_t p = 0; p < k; ++p) {
+                expected += a_vec[i][p] * b_vec[p][j];
+            }
+
+            ASSERT_EQ(c_buff[i * n + j], expected);
+        }
+    }
+}
+
+/**
+ ************************************* TEST CPU_X *************************************************
+ */
+
+template<typename T>
+void check_accelerated_gemv(size_t const rows, size_t const columns) {
+    auto const mat{random_values<T>(rows, columns, 42)};
+    auto const vec{random_values<T>(1, columns, 43)};
+    auto const res{random_values<T>(1, rows, 44)};
+
+    const auto mat_cpu = cobraml::core::from_vector<T>(mat, cobraml::core::CPU);
+    const auto vec_cpu = cobraml::core::from_vector<T>(vec, cobraml::core::CPU);
+    auto res_cpu = cobraml::core::from_vector<T>(res, cobraml::core::CPU);
+
+    const auto mat_x = cobraml::core::from_vector<T>(mat, cobraml::core::CPU_X);
+    const auto vec_x = cobraml::core::from_vector<T>(vec, cobraml::core::CPU_X);
+    auto res_x = cobraml::core::from_vector<T>(res, cobraml::core::CPU_X);
+
+    gemv(mat_cpu, vec_cpu, res_cpu, static_cast<T>(3), static_cast<T>(-2));
+    gemv(mat_x, vec_x, res_x, static_cast<T>(3), static_cast<T>(-2));
+
+    const T *cpu_buff = cobraml::core::get_buffer<T>(res_cpu);
+    const T *x_buff = cobraml::core::get_buffer<T>(res_x);
+
+    for (size_t i = 0; i < rows; ++i) {
+        ASSERT_EQ(cpu_buff[i], x_buff[i]);
+    }
+}
+
+TEST(MatrixTestFunc, gemv_accelerated) {
+    const cobraml::core::SimdLevel detected{cobraml::core::detected_simd_level()};
+
+    for (int level = cobraml::core::SCALAR; level <= detected; ++level) {
+        cobraml::core::set_simd_level(static_cast<cobraml::core::SimdLevel>(level));
+        check_accelerated_gemv<double>(37, 141);
+        check_accelerated_gemv<float>(37, 141);
+        check_accelerated_gemv<int8_t>(37, 141);
+        check_accelerated_gemv<int16_t>(37, 141);
+        check_accelerated_gemv<int32_t>(37, 141);
+        check_accelerated_gemv<int64_t>(37, 141);
+        check_accelerated_gemv<float>(3, 5);
+    }
+
+    cobraml::core::set_simd_level(detected);
+    ASSERT_EQ(cobraml::core::get_simd_level(), detected);
+
+    if (detected != cobraml::core::AVX512) {
+        ASSERT_THROW(cobraml::core::set_simd_level(cobraml::core::AVX512), std::runtime_error);
+    }
+}
+
+/**
+ ************************************* TEST HALF PRECISION GEMV **********************************
+ */
+
+template<typename Half>
+void check_half_gemv(cobraml::core::Device const device, size_t const rows, size_t const columns, Half (*narrow)(float)) {
+    std::vector mat(rows, std::vector<Half>(columns));
+
+    // small integers are exact in both half formats, so the FLOAT32 reference matches exactly
+    auto const raw{random_values<float>(rows, columns, 42)};
+    auto const vec{random_values<float>(1, columns, 43)};
+    auto const res{random_values<float>(1, rows, 44)};
+    std::vector expected(rows, 0.0f);
+
+    for (size_t i = 0; i < rows; ++i) {
+        float partial = 0;
+        for (size_t j = 0; j < columns; ++j) {
+            mat[i][j] = narrow(raw[i][j]);
+            partial += raw[i][j] * vec[0][j];
+        }
+
+        expected[i] = res[0][i] * -2.0f + partial * 3.0f;
+    }
+
+    const auto matrix = cobraml::core::from_vector<Half>(mat, device);
+    const auto vector = cobraml::core::from_vector<float>(vec, device);
+    auto result = cobraml::core::from_vector<float>(res, device);
+
+    gemv(matrix, vector, result, 3.0f, -2.0f);
+
+    const float *buff = cobraml::core::get_buffer<float>(result);
+    for (size_t i = 0; i < rows; ++i) {
+        ASSERT_EQ(buff[i], expected[i]);
+    }
+}
+
+TEST(MatrixTestFunc, test_invalid_gemv_half) {
+    cobraml::core::Matrix const mat(10, 20, cobraml::core::CPU, cobraml::core::FLOAT16);
+    cobraml::core::Matrix const vec(1, 20, cobraml::core::CPU, cobraml::core::FLOAT32);
+    cobraml::core::Matrix res(1, 10, cobraml::core::CPU, cobraml::core::FLOAT32);
+
+    ASSERT_NO_THROW(gemv(mat, vec, res, 1.0f, 0.0f));
+    ASSERT_THROW(gemv(mat, vec, res, 1.0, 0.0), std::runtime_error);
+
+    cobraml::core::Matrix const vec_half(1, 20, cobraml::core::CPU, cobraml::core::FLOAT16);
+    ASSERT_THROW(gemv(mat, vec_half, res, 1.0f, 0.0f), std::runtime_error);
+
+    cobraml::core::Matrix res_double(1, 10, cobraml::core::CPU, cobraml::core::FLOAT64);
+    ASSERT_THROW(gemv(mat, vec, res_double, 1.0f, 0.0f), std::runtime_error);
+}
+
+TEST(MatrixTestFunc, gemv_half) {
+    const cobraml::core::SimdLevel detected{cobraml::core::detected_simd_level()};
+
+    check_half_gemv<cobraml::core::float16>(cobraml::core::CPU, 37, 141, cobraml::core::to_float16);
+    check_half_gemv<cobraml::core::bfloat16>(cobraml::core::CPU, 37, 141, cobraml::core::to_bfloat16);
+
+    for (int level = cobraml::core::SCALAR; level <= detected; ++level) {
+        cobraml::core::set_simd_level(static_cast<cobraml::core::SimdLevel>(level));
+        check_half_gemv<cobraml::core::float16>(cobraml::core::CPU_X, 37, 141, cobraml::core::to_float16);
+        check_half_gemv<cobraml::core::bfloat16>(cobraml::core::CPU_X, 37, 141, cobraml::core::to_bfloat16);
+        check_half_gemv<cobraml::core::bfloat16>(cobraml::core::CPU_X, 3, 5, cobraml::core::to_bfloat16);
+    }
+
+    cobraml::core::set_simd_level(detected);
+}
+
+/**
+ ************************************* TEST TRANSPOSED GEMV *************************************
+ */
+
+template<typename T>
+void check_transposed_gemv(cobraml::core::Device const device, size_t const rows, size_t const columns) {
+    auto const mat{random_values<T>(rows, columns, 42)};
+    auto const vec{random_values<T>(1, rows, 43)};
+    auto const res{random_values<T>(1, columns, 44)};
+
+    std::vector<T> expected(columns);
+    for (size_t j = 0; j < columns; ++j) {
+        T partial = 0;
+        for (size_t i = 0; i < rows; ++i) {
+            partial = static_cast<T>(partial + mat[i][j] * vec[0][i]);
+        }
+
+        expected[j] = static_cast<T>(res[0][j] * -2 + partial * 3);
+    }
+
+    const auto matrix = cobraml::core::from_vector<T>(mat, device);
+    const auto vector = cobraml::core::from_vector<T>(vec, device);
+    auto result = cobraml::core::from_vector<T>(res, device);
+
+    gemv(matrix, vector, result, static_cast<T>(3), static_cast<T>(-2), true);
+
+    const T *buff = cobraml::core::get_buffer<T>(result);
+    for (size_t j = 0; j < columns; ++j) {
+        ASSERT_EQ(buff[j], expected[j]);
+    }
+}
+
+TEST(MatrixTestFunc, test_invalid_gemv_transposed) {
+    cobraml::core::Matrix const mat(10, 20, cobraml::core::CPU, cobraml::core::FLOAT32);
+    cobraml::core::Matrix const vec(1, 10, cobraml::core::CPU, cobraml::core::FLOAT32);
+    cobraml::core::Matrix res(1, 20, cobraml::core::CPU, cobraml::core::FLOAT32);
+
+    ASSERT_NO_THROW(gemv(mat, vec, res, 1.0f, 0.0f, true));
+    ASSERT_THROW(gemv(mat, vec, res, 1.0f, 0.0f, false), std::runtime_error);
+
+    cobraml::core::Matrix const vec_wide(1, 20, cobraml::core::CPU, cobraml::core::FLOAT32);
+    ASSERT_THROW(gemv(mat, vec_wide, res, 1.0f, 0.0f, true), std::runtime_error);
+
+    cobraml::core::Matrix res_short(1, 10, cobraml::core::CPU, cobraml::core::FLOAT32);
+    ASSERT_THROW(gemv(mat, vec, res_short, 1.0f, 0.0f, true), std::runtime_error);
+}
+
+TEST(MatrixTestFunc, gemv_transposed) {
+    for (cobraml::core::Device const device: {cobraml::core::CPU, cobraml::core::CPU_X}) {
+        check_transposed_gemv<double>(device, 37, 141);
+        check_transposed_gemv<float>(device, 141, 37);
+        check_transposed_gemv<int8_t>(device, 37, 141);
+        check_transposed_gemv<int16_t>(device, 6, 9);
+        check_transposed_gemv<int32_t>(device, 1, 141);
+        check_transposed_gemv<int64_t>(device, 400, 3);
+    }
+}
+
+TEST(MatrixTestFunc, gemv_transposed_half) {
+    std::vector mat(5, std::vector<cobraml::core::bfloat16>(7));
+    std::vector vec(1, std::vector<float>(5));
+
+    for (size_t i = 0; i < 5; ++i) {
+        vec[0][i] = static_cast<float>(i) - 2.0f;
+        for (size_t j = 0; j < 7; ++j) {
+            mat[i][j] = cobraml::core::to_bfloat16(static_cast<float>(i * 7 + j));
+        }
+    }
+
+    const auto matrix = cobraml::core::from_vector(mat, cobraml::core::CPU);
+    const auto vector = cobraml::core::from_vector(vec, cobraml::core::CPU);
+    cobraml::core::Matrix result(1, 7, cobraml::core::CPU, cobraml::core::FLOAT32);
+
+    gemv(matrix, vector, result, 1.0f, 0.0f, true);
+
+    for (size_t j = 0; j < 7; ++j) {
+        float expected = 0;
+        for (size_t i = 0; i < 5; ++i) {
+            expected += (static_cast<float>(i) - 2.0f) * static_cast<float>(i * 7 + j);
+        }
+
+        ASSERT_EQ(result[j].item<float>(), expected);
+    }
+}
+
+/**
+ ************************************* TEST SPARSE QUERY GEMV *************************************
+ */
+
+template<typename T>
+void check_sparse_query_gemv(
+    cobraml::core::Device const device, size_t const rows, size_t const columns, bool const transpose) {
+    size_t const inner{transpose ? rows : columns};
+    size_t const outer{transpose ? columns : rows};
+    auto const mat{random_values<T>(rows, columns, 42)};
+    auto const res{random_values<T>(1, outer, 43)};
+    auto const dense{random_values<T>(1, inner, 44)};
+
+    // every third position, walked backwards so the indices are unsorted
+    std::vector idx(1, std::vector<int64_t>{});
+    std::vector val(1, std::vector<T>{});
+    for (size_t i = inner; i-- > 0;) {
+        if (i % 3 != 0) continue;
+        idx[0].push_back(static_cast<int64_t>(i));
+        val[0].push_back(dense[0][i]);
+    }
+
+    std::vector<T> expected(outer);
+    for (size_t j = 0; j < outer; ++j) {
+        T partial = 0;
+        for (size_t k = 0; k < idx[0].size(); ++k) {
+            auto const i{static_cast<size_t>(idx[0][k])};
+            partial = static_cast<T>(partial + (transpose ? mat[i][j] : mat[j][i]) * val[0][k]);
+        }
+
+        expected[j] = static_cast<T>(res[0][j] * -2 + partial * 3);
+    }
+
+    const auto matrix = cobraml::core::from_vector<T>(mat, device);
+    const auto indices = cobraml::core::from_vector<int64_t>(idx, device);
+    const auto values = cobraml::core::from_vector<T>(val, device);
+    auto result = cobraml::core::from_vector<T>(res, device);
+
+    gemv_sparse_query(matrix, indices, values, result, static_cast<T>(3), static_cast<T>(-2), transpose);
+
+    const T *buff = cobraml::core::get_buffer<T>(result);
+    for (size_t j = 0; j < outer; ++j) {
+        ASSERT_EQ(buff[j], expected[j]);
+    }
+}
+
+TEST(MatrixTestFunc, test_invalid_gemv_sparse_query) {
+    cobraml::core::Matrix const mat(10, 20, cobraml::core::CPU, cobraml::core::FLOAT32);
+    const auto indices = cobraml::core::from_vector<int64_t>({{0, 19}}, cobraml::core::CPU);
+    const auto values = cobraml::core::from_vector<float>({{1, 2}}, cobraml::core::CPU);
+    cobraml::core::Matrix res(1, 10, cobraml::core::CPU, cobraml::core::FLOAT32);
+
+    ASSERT_NO_THROW(gemv_sparse_query(mat, indices, values, res, 1.0f, 0.0f));
+    ASSERT_THROW(gemv_sparse_query(mat, indices, values, res, 1.0f, 0.0f, true), std::runtime_error);
+    ASSERT_THROW(gemv_sparse_query(mat, indices, values, res, 1.0, 0.0), std::runtime_error);
+
+    cobraml::core::Matrix res_t(1, 20, cobraml::core::CPU, cobraml::core::FLOAT32);
+    ASSERT_THROW(gemv_sparse_query(mat, indices, values, res_t, 1.0f, 0.0f, true), std::out_of_range);
+
+    const auto short_values = cobraml::core::from_vector<float>({{1}}, cobraml::core::CPU);
+    ASSERT_THROW(gemv_sparse_query(mat, indices, short_values, res, 1.0f, 0.0f), std::runtime_error);
+
+    const auto int_indices = cobraml::core::from_vector<int32_t>({{0, 19}}, cobraml::core::CPU);
+    ASSERT_THROW(gemv_sparse_query(mat, int_indices, values, res, 1.0f, 0.0f), std::runtime_error);
+
+    const auto negative = cobraml::core::from_vector<int64_t>({{0, -1}}, cobraml::core::CPU);
+    ASSERT_THROW(gemv_sparse_query(mat, negative, values, res, 1.0f, 0.0f), std::out_of_range);
+}
+
+TEST(MatrixTestFunc, gemv_sparse_query) {
+    for (cobraml::core::Device const device: {cobraml::core::CPU, cobraml::core::CPU_X}) {
+        for (bool const transpose: {false, true}) {
+            check_sparse_query_gemv<double>(device, 37, 141, transpose);
+            check_sparse_query_gemv<float>(device, 141, 37, transpose);
+            check_sparse_query_gemv<int8_t>(device, 37, 141, transpose);
+            check_sparse_query_gemv<int16_t>(device, 6, 9, transpose);
+            check_sparse_query_gemv<int32_t>(device, 1, 141, transpose);
+            check_sparse_query_gemv<int64_t>(device, 400, 3, transpose);
+        }
+    }
+}
+
+TEST(MatrixTestFunc, gemv_sparse_query_slice) {
+    std::vector mat(6, std::vector<int32_t>(8));
+    for (size_t i = 0; i < 6; ++i)
+        for (size_t j = 0; j < 8; ++j)
+            mat[i][j] = static_cast<int32_t>(i * 8 + j);
+
+    const auto matrix = cobraml::core::from_vector(mat, cobraml::core::CPU);
+    const auto view = matrix.slice(1, 4, 2, 7);
+    const auto indices = cobraml::core::from_vector<int64_t>({{4, 0}}, cobraml::core::CPU);
+    const auto values = cobraml::core::from_vector<int32_t>({{1, 2}}, cobraml::core::CPU);
+    cobraml::core::Matrix result(1, 3, cobraml::core::CPU, cobraml::core::INT32);
+
+    gemv_sparse_query(view, indices, values, result, 1, 0);
+
+    for (size_t i = 0; i < 3; ++i) {
+        ASSERT_EQ(result[i].item<int32_t>(), mat[i + 1][6] + 2 * mat[i + 1][2]);
+    }
+}
+
+/**
+ ************************************* TEST SLICED VIEWS *****************************************
+ */
+
+TEST(MatrixTestFunc, test_slice) {
+    std::vector mat(4, std::vector<int32_t>(6));
+    for (size_t i = 0; i < 4; ++i)
+        for (size_t j = 0; j < 6; ++j)
+            mat[i][j] = static_cast<int32_t>(i * 10 + j);
+
+    const auto matrix = cobraml::core::from_vector(mat, cobraml::core::CPU);
+    ASSERT_TRUE(matrix.is_contiguous());
+    ASSERT_EQ(matrix.get_leading_dimension(), 6);
+
+    const auto view = matrix.slice(1, 3, 2, 5);
+    ASSERT_EQ(view.get_shape(), (cobraml::core::Matrix::Shape{2, 3}));
+    ASSERT_EQ(view.get_leading_dimension(), 6);
+    ASSERT_FALSE(view.is_contiguous());
+
+    for (size_t i = 0; i < 2; ++i)
+        for (size_t j = 0; j < 3; ++j)
+            ASSERT_EQ(view[i][j].item<int32_t>(), mat[i + 1][j + 2]);
+
+    // nested views keep the stride of the buffer
+    const auto nested = view.slice(1, 2, 1, 3);
+    ASSERT_TRUE(nested.is_vector());
+    ASSERT_TRUE(nested.is_contiguous());
+    ASSERT_EQ(nested[0].item<int32_t>(), 23);
+    ASSERT_EQ(nested[1].item<int32_t>(), 24);
+
+    // full width row ranges stay contiguous
+    ASSERT_TRUE(matrix.slice(1, 3, 0, 6).is_contiguous());
+
+    ASSERT_THROW(auto _ = matrix.slice(2, 2, 0, 6), std::runtime_error);
+    ASSERT_THROW(auto _ = matrix.slice(0, 5, 0, 6), std::out_of_range);
+    ASSERT_THROW(auto _ = matrix.slice(0, 4, 3, 7), std::out_of_range);
+}
+
+TEST(MatrixTestFunc, test_slice_requires_contiguous) {
+    cobraml::core::Matrix const mat(10, 20, cobraml::core::CPU, cobraml::core::FLOAT32);
+    const auto view = mat.slice(0, 10, 0, 10);
+    cobraml::core::Matrix const vec(1, 10, cobraml::core::CPU, cobraml::core::FLOAT32);
+    cobraml::core::Matrix res(1, 10, cobraml::core::CPU, cobraml::core::FLOAT32);
+    cobraml::core::Matrix batch(1, 10, cobraml::core::CPU, cobraml::core::FLOAT32);
+    cobraml::core::Matrix indices(1, 3, cobraml::core::CPU, cobraml::core::INT64);
+    cobraml::core::Matrix scores(1, 3, cobraml::core::CPU, cobraml::core::FLOAT32);
+    cobraml::core::Matrix product(10, 10, cobraml::core::CPU, cobraml::core::FLOAT32);
+
+    ASSERT_NO_THROW(gemv(view, vec, res, 1.0f, 0.0f));
+    ASSERT_THROW(gemv_cosine(view, vec, res, 1.0f, 0.0f), std::runtime_error);
+    ASSERT_THROW(gemv_topk(view, vec, indices, scores, 1.0f), std::runtime_error);
+    ASSERT_THROW(gemv_batched(view, vec, batch, 1.0f, 0.0f), std::runtime_error);
+    ASSERT_THROW(gemm(view, view, product, 1.0f, 0.0f), std::runtime_error);
+}
+
+template<typename T>
+void check_sliced_gemv(cobraml::core::Device const device, bool const transpose) {
+    constexpr size_t rows{41}, columns{67};
+    auto const mat{random_values<T>(rows, columns, 7)};
+
+    // the block of rows [3, 38) and columns [5, 60), once as a view and once as a packed copy
+    std::vector packed(35, std::vector<T>(55));
+    for (size_t i = 0; i < 35; ++i)
+        for (size_t j = 0; j < 55; ++j)
+            packed[i][j] = mat[i + 3][j + 5];
+
+    size_t const in{transpose ? 35UL : 55UL};
+    size_t const out{transpose ? 55UL : 35UL};
+
+    auto const vec{random_values<T>(1, in, 8)};
+
+    const auto full = cobraml::core::from_vector<T>(mat, device);
+    const auto view = full.slice(3, 38, 5, 60);
+    const auto copy = cobraml::core::from_vector<T>(packed, device);
+    const auto vector = cobraml::core::from_vector<T>(vec, device);
+
+    cobraml::core::Matrix expected(1, out, device, cobraml::core::get_dtype_from_type<T>::type);
+    cobraml::core::Matrix result(1, out, device, cobraml::core::get_dtype_from_type<T>::type);
+
+    gemv(copy, vector, expected, static_cast<T>(2), static_cast<T>(0), transpose);
+    gemv(view, vector, result, static_cast<T>(2), static_cast<T>(0), transpose);
+
+    for (size_t i = 0; i < out; ++i) {
+        ASSERT_EQ(result[i].template item<T>(), expected[i].template item<T>());
+    }
+}
+
+TEST(MatrixTestFunc, gemv_sliced) {
+    const cobraml::core::SimdLevel detected{cobraml::core::detected_simd_level()};
+
+    for (bool const transpose: {false, true}) {
+        check_sliced_gemv<float>(cobraml::core::CPU, transpose);
+        check_sliced_gemv<int16_t>(cobraml::core::CPU, transpose);
+
+        for (int level = cobraml::core::SCALAR; level <= detected; ++level) {
+            cobraml::core::set_simd_level(static_cast<cobraml::core::SimdLevel>(level));
+            check_sliced_gemv<double>(cobraml::core::CPU_X, transpose);
+            check_sliced_gemv<float>(cobraml::core::CPU_X, transpose);
+            check_sliced_gemv<int8_t>(cobraml::core::CPU_X, transpose);
+            check_sliced_gemv<int64_t>(cobraml::core::CPU_X, transpose);
+        }
+    }
+
+    cobraml::core::set_simd_level(detected);
+}
+
+TEST(MatrixTestFunc, gemv_sliced_half) {
+    std::vector mat(6, std::vector<cobraml::core::float16>(9));
+    for (size_t i = 0; i < 6; ++i)
+        for (size_t j = 0; j < 9; ++j)
+            mat[i][j] = cobraml::core::to_float16(static_cast<float>(i) - static_cast<float>(j));
+
+    std::vector vec(1, std::vector(4, 1.0f));
+
+    for (cobraml::core::Device const device: {cobraml::core::CPU, cobraml::core::CPU_X}) {
+        const auto view = cobraml::core::from_vector(mat, device).slice(1, 5, 2, 6);
+        const auto vector = cobraml::core::from_vector(vec, device);
+        cobraml::core::Matrix result(1, 4, device, cobraml::core::FLOAT32);
+
+        gemv(view, vector, result, 1.0f, 0.0f);
+
+        // row i of the view sums (i + 1) - j over j in [2, 6)
+        for (size_t i = 0; i < 4; ++i) {
+            ASSERT_EQ(result[i].item<float>(), 4.0f * static_cast<float>(i + 1) - 14.0f);
+        }
+    }
+}
+
+/**
+ ************************************* TEST BATCHED GEMV *****************************************
+ */
+
+TEST(MatrixTestFunc, test_invalid_gemv_batched) {
+    cobraml::core::Matrix const mat(10, 20, cobraml::core::CPU, cobraml::core::FLOAT32);
+    cobraml::core::Matrix const queries(3, 20, cobraml::core::CPU, cobraml::core::FLOAT32);
+    cobraml::core::Matrix res(3, 10, cobraml::core::CPU, cobraml::core::FLOAT32);
+
+    ASSERT_NO_THROW(gemv_batched(mat, queries, res, 1.0f, 0.0f));
+
+    cobraml::core::Matrix const queries2(3, 10, cobraml::core::CPU, cobraml::core::FLOAT32);
+    ASSERT_THROW(gemv_batched(mat, queries2, res, 1.0f, 0.0f), std::runtime_error);
+
+    cobraml::core::Matrix res2(2, 10, cobraml::core::CPU, cobraml::core::FLOAT32);
+    ASSERT_THROW(gemv_batched(mat, queries, res2, 1.0f, 0.0f), std::runtime_error);
+
+    cobraml::core::Matrix res3(3, 10, cobraml::core::CPU, cobraml::core::INT32);
+    ASSERT_THROW(gemv_batched(mat, queries, res3, 1.0f, 0.0f), std::runtime_error);
+
+    ASSERT_THROW(gemv_batched(mat, queries, res, 1.0, 0.0), std::runtime_error);
+}
+
+TEST(MatrixTestFunc, gemv_batched_matches_gemv) {
+    constexpr size_t rows{103};
+    constexpr size_t columns{5000};
+    constexpr size_t query_count{5};
+
+    auto const mat_vec{create_vector(rows, columns)};
+    auto const query_vec{create_vector(query_count, columns)};
+    auto const res_vec{create_vector(query_count, rows)};
+
+    const auto mat = cobraml::core::from_vector<double>(mat_vec, cobraml::core::CPU);
+    const auto queries = cobraml::core::from_vector<double>(query_vec, cobraml::core::CPU);
+    auto res = cobraml::core::from_vector<double>(res_vec, cobraml::core::CPU);
+
+    gemv_batched(mat, queries, res, 2.0, -1.0);
+
+    for (size_t q = 0; q < query_count; ++q) {
+        auto single = cobraml::core::from_vector<double>(
+            std::vector<std::vector<double>>{res_vec[q]}, cobraml::core::CPU);
+
+        gemv(mat, queries[q], single, 2.0, -1.0);
+
+        const double *expected = cobraml::core::get_buffer<double>(single);
+        const double *batched = cobraml::core::get_buffer<double>(res[q]);
+
+        for (size_t i = 0; i < rows; ++i) {
+            ASSERT_EQ(batched[i], expected[i]);
+        }
+    }
+}
+
+/**
+ ************************************* TEST TOP K GEMV *******************************************
+ */
+
+TEST(MatrixTestFunc, test_invalid_gemv_topk) {
+    cobraml::core::Matrix const mat(10, 20, cobraml::core::CPU, cobraml::core::FLOAT32);
+    cobraml::core::Matrix const vec(1, 20, cobraml::core::CPU, cobraml::core::FLOAT32);
+    cobraml::core::Matrix indices(1, 3, cobraml::core::CPU, cobraml::core::INT64);
+    cobraml::core::Matrix scores(1, 3, cobraml::core::CPU, cobraml::core::FLOAT32);
+
+    ASSERT_NO_THROW(gemv_topk(mat, vec, indices, scores, 1.0f));
+
+    cobraml::core::Matrix bad_indices(1, 3, cobraml::core::CPU, cobraml::core::INT32);
+    ASSERT_THROW(gemv_topk(mat, vec, bad_indices, scores, 1.0f), std::runtime_error);
+
+    cobraml::core::Matrix short_scores(1, 2, cobraml::core::CPU, cobraml::core::FLOAT32);
+    ASSERT_THROW(gemv_topk(mat, vec, indices, short_scores, 1.0f), std::runtime_error);
+
+    cobraml::core::Matrix big_indices(1, 11, cobraml::core::CPU, cobraml::core::INT64);
+    cobraml::core::Matrix big_scores(1, 11, cobraml::core::CPU, cobraml::core::FLOAT32);
+    ASSERT_THROW(gemv_topk(mat, vec, big_indices, big_scores, 1.0f), std::runtime_error);
+
+    ASSERT_THROW(gemv_topk(mat, vec, indices, scores, 1.0), std::runtime_error);
+}
+
+TEST(MatrixTestFunc, gemv_topk_matches_sorted_gemv) {
+    constexpr size_t rows{2001};
+    constexpr size_t columns{67};
+    constexpr size_t k{25};
+
+    auto const mat_vec{create_vector(rows, columns)};
+    auto const vec_vec{create_vector(1, columns)};
+
+    const auto mat = cobraml::core::from_vector<double>(mat_vec, cobraml::core::CPU);
+    const auto vec = cobraml::core::from_vector<double>(vec_vec, cobraml::core::CPU);
+
+    cobraml::core::Matrix indices(1, k, cobraml::core::CPU, cobraml::core::INT64);
+    cobraml::core::Matrix scores(1, k, cobraml::core::CPU, cobraml::core::FLOAT64);
+    gemv_topk(mat, vec, indices, scores, 2.0);
+
+    cobraml::core::Matrix full(1, rows, cobraml::core::CPU, cobraml::core::FLOAT64);
+    gemv(mat, vec, full, 2.0, 0.0);
+    const double *full_buff = cobraml::core::get_buffer<double>(full);
+
+    std::vector<int64_t> order(rows);
+    for (size_t i = 0; i < rows; ++i) {
+        order[i] = static_cast<int64_t>(i);
+    }
+
+    std::stable_sort(order.begin(), order.end(), [full_buff](int64_t const lhs, int64_t const rhs) {
+        return full_buff[lhs] > full_buff[rhs];
+    });
+
+    const int64_t *index_buff = cobraml::core::get_buffer<int64_t>(indices);
+    const double *score_buff = cobraml::core::get_buffer<double>(scores);
+
+    for (size_t i = 0; i < k; ++i) {
+        ASSERT_EQ(index_buff[i], order[i]);
+        ASSERT_EQ(score_buff[i], full_buff[order[i]]);
+    }
+}
+
+/**
+ ************************************* TEST COSINE GEMV ******************************************
+ */
+
+void check_cosine(
+    std::vector<std::vector<double> > const &mat,
+    std::vector<double> const &vec,
+    const double *result) {
+    double vec_norm = 0;
+    for (double const x: vec) {
+        vec_norm += x * x;
+    }
+
+    for (size_t i = 0; i < mat.size(); ++i) {
+        double dot = 0;
+        double row_norm = 0;
+
+        for (size_t j = 0; j < vec.size(); ++j) {
+            dot += mat[i][j] * vec[j];
+            row_norm += mat[i][j] * mat[i][j];
+        }
+
+        double const denominator = std::sqrt(row_norm) * std::sqrt(vec_norm);
+        double const expected = denominator == 0 ? 0 : dot / denominator;
+        ASSERT_NEAR(result[i], expected, 1e-12);
+    }
+}
+
+TEST(MatrixTestFunc, test_invalid_gemv_cosine) {
+    cobraml::core::Matrix const mat(10, 20, cobraml::core::CPU, cobraml::core::INT32);
+    cobraml::core::Matrix const vec(1, 20, cobraml::core::CPU, cobraml::core::INT32);
+    cobraml::core::Matrix res(1, 10, cobraml::core::CPU, cobraml::core::INT32);
+
+    ASSERT_THROW(gemv_cosine(mat, vec, res, 1, 0), std::runtime_error);
+
+    cobraml::core::Matrix const mat2(10, 20, cobraml::core::CPU, cobraml::core::FLOAT32);
+    cobraml::core::Matrix const vec2(1, 20, cobraml::core::CPU, cobraml::core::FLOAT32);
+    cobraml::core::Matrix res2(1, 9, cobraml::core::CPU, cobraml::core::FLOAT32);
+
+    ASSERT_THROW(gemv_cosine(mat2, vec2, res2, 1.0f, 0.0f), std::runtime_error);
+}
+
+TEST(MatrixTestFunc, gemv_cosine_invalidates_norms) {
+    constexpr size_t rows{41};
+    constexpr size_t columns{33};
+
+    auto mat_vec{create_vector(rows, columns)};
+    mat_vec[3] = std::vector(columns, 0.0);
+    auto const vec_vec{create_vector(1, columns)};
+
+    const auto mat = cobraml::core::from_vector<double>(mat_vec, cobraml::core::CPU);
+    const auto vec = cobraml::core::from_vector<double>(vec_vec, cobraml::core::CPU);
+    cobraml::core::Matrix res(1, rows, cobraml::core::CPU, cobraml::core::FLOAT64);
+
+    gemv_cosine(mat, vec, res, 1.0, 0.0);
+    check_cosine(mat_vec, vec_vec[0], cobraml::core::get_buffer<double>(res));
+
+    // scoring twice reuses the cached norms
+    gemv_cosine(mat, vec, res, 1.0, 0.0);
+    check_cosine(mat_vec, vec_vec[0], cobraml::core::get_buffer<double>(res));
+
+    // writing through a row view must drop the cached norms
+    mat[5][7].set_item(100.0);
+    mat_vec[5][7] = 100.0;
+    mat[3][0].set_item(2.0);
+    mat_vec[3][0] = 2.0;
+
+    gemv_cosine(mat, vec, res, 1.0, 0.0);
+    check_cosine(mat_vec, vec_vec[0], cobraml::core::get_buffer<double>(res));
+
+    // as must a deep copy into the matrix
+    auto const replacement_vec{create_vector(rows, columns)};
+    auto replacement = cobraml::core::from_vector<double>(replacement_vec, cobraml::core::CPU);
+    cobraml::core::Matrix target = mat;
+    target.deep_copy(replacement);
+
+    gemv_cosine(mat, vec, res, 1.0, 0.0);
+    check_cosine(replacement_vec, vec_vec[0], cobraml::core::get_buffer<double>(res));
+}
+
+/**
+ ************************************* TEST LEVEL 1 *************************************
+ */
+
+template<typename T>
+void check_level1(cobraml::core::Device const device, size_t const rows, size_t const columns) {
+    auto x{random_values<T>(rows, columns, 42, 4)};
+    auto const y{random_values<T>(rows, columns, 43, 4)};
+
+    // a unique largest magnitude, negative so the sign is ignored
+    x[rows / 2][columns / 2] = static_cast<T>(-9);
+
+    T dot{0};
+    T asum{0};
+    double squares{0};
+    for (size_t i = 0; i < rows; ++i) {
+        for (size_t j = 0; j < columns; ++j) {
+            dot = static_cast<T>(dot + x[i][j] * y[i][j]);
+            asum = static_cast<T>(asum + (x[i][j] < 0 ? -x[i][j] : x[i][j]));
+            squares += static_cast<double>(x[i][j]) * static_cast<double>(x[i][j]);
+        }
+    }
+
+    const auto mat_x = cobraml::core::from_vector<T>(x, device);
+    auto mat_y = cobraml::core::from_vector<T>(y, device);
+
+    ASSERT_EQ(cobraml::core::dot<T>(mat_x, mat_y), dot);
+    ASSERT_EQ(cobraml::core::asum<T>(mat_x), asum);
+    ASSERT_EQ(cobraml::core::nrm2<T>(mat_x), static_cast<T>(std::sqrt(squares)));
+    ASSERT_EQ(cobraml::core::iamax(mat_x), rows / 2 * columns + columns / 2);
+
+    cobraml::core::axpy(static_cast<T>(2), mat_x, mat_y);
+    cobraml::core::scal(static_cast<T>(-1), mat_y);
+
+    const T *buff = cobraml::core::get_buffer<T>(mat_y);
+    for (size_t i = 0; i < rows; ++i) {
+        for (size_t j = 0; j < columns; ++j) {
+            ASSERT_EQ(buff[i * columns + j], static_cast<T>(-(2 * x[i][j] + y[i][j])));
+        }
+    }
+}
+
+TEST(MatrixTestFunc, level1) {
+    for (cobraml::core::Device const device: {cobraml::core::CPU, cobraml::core::CPU_X}) {
+        check_level1<double>(device, 37, 141);
+        check_level1<float>(device, 1, 5000);
+        check_level1<int8_t>(device, 3, 7);
+        check_level1<int16_t>(device, 6, 9);
+        check_level1<int32_t>(device, 1, 1);
+        check_level1<int64_t>(device, 400, 3);
+    }
+}
+
+TEST(MatrixTestFunc, level1_parallel) {
+    size_t const threshold{cobraml::core::get_parallel_threshold()};
+    size_t const threads{cobraml::core::get_thread_count()};
+    cobraml::core::set_parallel_threshold(0);
+    cobraml::core::set_thread_count(3);
+
+    check_level1<float>(cobraml::core::CPU, 1, 1000);
+    check_level1<int32_t>(cobraml::core::CPU, 5, 2);
+
+    // ties go to the first index even when another thread holds it
+    const auto ties = cobraml::core::from_vector<int32_t>({{1, -5, 2, 5, 3, -5}}, cobraml::core::CPU);
+    ASSERT_EQ(cobraml::core::iamax(ties), 1);
+
+    cobraml::core::set_parallel_threshold(threshold);
+    cobraml::core::set_thread_count(threads);
+}
+
+TEST(MatrixTestFunc, test_invalid_level1) {
+    const cobraml::core::Matrix x(2, 3, cobraml::core::CPU, cobraml::core::FLOAT32);
+    cobraml::core::Matrix y(3, 2, cobraml::core::CPU, cobraml::core::FLOAT32);
+    cobraml::core::Matrix half(2, 3, cobraml::core::CPU, cobraml::core::FLOAT16);
+    const cobraml::core::Matrix wide(4, 4, cobraml::core::CPU, cobraml::core::FLOAT32);
+
+    ASSERT_THROW(cobraml::core::dot<float>(x, y), std::runtime_error);
+    ASSERT_THROW(cobraml::core::dot<double>(x, x), std::runtime_error);
+    ASSERT_THROW(cobraml::core::axpy(1.0f, x, y), std::runtime_error);
+    ASSERT_THROW(cobraml::core::scal(1.0, y), std::runtime_error);
+    ASSERT_THROW(cobraml::core::nrm2<float>(wide.slice(0, 2, 0, 2)), std::runtime_error);
+    ASSERT_THROW(cobraml::core::iamax(wide.slice(0, 2, 0, 2)), std::runtime_error);
+    ASSERT_THROW(cobraml::core::dot<float>(x, half), std::runtime_error);
+    ASSERT_THROW(cobraml::core::scal(1.0, half), std::runtime_error);
+    ASSERT_THROW(cobraml::core::asum<cobraml::core::float16>(half), std::runtime_error);
+    ASSERT_NO_THROW(cobraml::core::asum<float>(wide.slice(1, 2, 0, 2)));
+}
+
+template<typename Half>
+void check_level1_half(cobraml::core::Device const device, Half (*narrow)(float)) {
+    const std::vector<float> x_values{3, -4, 0.5f, 12, -0.25f};
+    const std::vector<float> y_values{1, 2, -2, 0.5f, 8};
+    std::vector<Half> x_half, y_half;
+
+    for (size_t i = 0; i < x_values.size(); ++i) {
+        x_half.push_back(narrow(x_values[i]));
+        y_half.push_back(narrow(y_values[i]));
+    }
+
+    const auto x = cobraml::core::from_vector(std::vector<std::vector<Half>>{x_half}, device);
+    auto y = cobraml::core::from_vector(std::vector<std::vector<Half>>{y_half}, device);
+
+    // every value above is exact in both half formats, so FLOAT32 arithmetic gives exact results
+    ASSERT_EQ(cobraml::core::dot<float>(x, y), 3 - 8 - 1 + 6 - 2);
+    ASSERT_EQ(cobraml::core::nrm2<float>(x), std::sqrt(9.0f + 16 + 0.25f + 144 + 0.0625f));
+    ASSERT_EQ(cobraml::core::asum<float>(x), 19.75f);
+    ASSERT_EQ(cobraml::core::iamax(x), 3);
+
+    cobraml::core::axpy(2.0f, x, y);
+    cobraml::core::scal(0.5f, y);
+
+    const Half *buff{cobraml::core::get_buffer<Half>(y)};
+    for (size_t i = 0; i < x_values.size(); ++i) {
+        ASSERT_EQ(cobraml::core::to_float(buff[i]), (2 * x_values[i] + y_values[i]) / 2);
+    }
+}
+
+TEST(MatrixTestFunc, test_level1_half) {
+    for (cobraml::core::Device const device: {cobraml::core::CPU, cobraml::core::CPU_X}) {
+        check_level1_half<cobraml::core::float16>(device, cobraml::core::to_float16);
+        check_level1_half<cobraml::core::bfloat16>(device, cobraml::core::to_bfloat16);
+    }
+}
+
+/**
+ ************************************* TEST REDUCTIONS *************************************
+ */
+
+template<typename T>
+void check_reductions(cobraml::core::Device const device, size_t const rows, size_t const columns) {
+    auto const mat{random_values<T>(rows, columns, 42)};
+
+    const auto matrix = cobraml::core::from_vector<T>(mat, device);
+
+    const auto row_sum = reduce_rows(matrix, cobraml::core::SUM);
+    const auto row_max = reduce_rows(matrix, cobraml::core::MAX);
+    const auto row_argmax = reduce_rows(matrix, cobraml::core::ARGMAX);
+    const auto row_mean = reduce_rows(matrix, cobraml::core::MEAN);
+    ASSERT_EQ(row_argmax.get_dtype(), cobraml::core::INT64);
+    ASSERT_EQ(row_sum.get_shape().columns, rows);
+
+    for (size_t i = 0; i < rows; ++i) {
+        T sum{0};
+        double total{0};
+        size_t argmax{0};
+        for (size_t j = 0; j < columns; ++j) {
+            sum = static_cast<T>(sum + mat[i][j]);
+            total += static_cast<double>(mat[i][j]);
+            if (mat[i][j] > mat[i][argmax]) argmax = j;
+        }
+
+        ASSERT_EQ(cobraml::core::get_buffer<T>(row_sum)[i], sum);
+        ASSERT_EQ(cobraml::core::get_buffer<T>(row_max)[i], mat[i][argmax]);
+        ASSERT_EQ(cobraml::core::get_buffer<int64_t>(row_argmax)[i], static_cast<int64_t>(argmax));
+        ASSERT_EQ(cobraml::core::get_buffer<T>(row_mean)[i], static_cast<T>(total / static_cast<double>(columns)));
+    }
+
+    const auto column_sum = reduce_columns(matrix, cobraml::core::SUM);
+    const auto column_max = reduce_columns(matrix, cobraml::core::MAX);
+    const auto column_argmax = reduce_columns(matrix, cobraml::core::ARGMAX);
+    const auto column_mean = reduce_columns(matrix, cobraml::core::MEAN);
+    ASSERT_EQ(column_sum.get_shape().columns, columns);
+
+    for (size_t j = 0; j < columns; ++j) {
+        T sum{0};
+        double total{0};
+        size_t argmax{0};
+        for (size_t i = 0; i < rows; ++i) {
+            sum = static_cast<T>(sum + mat[i][j]);
+            total += static_cast<double>(mat[i][j]);
+            if (mat[i][j] > mat[argmax][j]) argmax = i;
+        }
+
+        ASSERT_EQ(cobraml::core::get_buffer<T>(column_sum)[j], sum);
+        ASSERT_EQ(cobraml::core::get_buffer<T>(column_max)[j], mat[argmax][j]);
+        ASSERT_EQ(cobraml::core::get_buffer<int64_t>(column_argmax)[j], static_cast<int64_t>(argmax));
+        ASSERT_EQ(cobraml::core::get_buffer<T>(column_mean)[j], static_cast<T>(total / static_cast<double>(rows)));
+    }
+}
+
+TEST(MatrixTestFunc, reductions) {
+    for (cobraml::core::Device const device: {cobraml::core::CPU, cobraml::core::CPU_X}) {
+        check_reductions<double>(device, 37, 141);
+        check_reductions<float>(device, 141, 37);
+        check_reductions<int8_t>(device, 3, 7);
+        check_reductions<int16_t>(device, 6, 9);
+        check_reductions<int32_t>(device, 1, 141);
+        check_reductions<int64_t>(device, 400, 3);
+    }
+}
+
+TEST(MatrixTestFunc, reductions_parallel) {
+    size_t const threshold{cobraml::core::get_parallel_threshold()};
+    size_t const threads{cobraml::core::get_thread_count()};
+    cobraml::core::set_parallel_threshold(0);
+    cobraml::core::set_thread_count(3);
+
+    check_reductions<int32_t>(cobraml::core::CPU, 50, 20);
+    check_reductions<float>(cobraml::core::CPU, 2, 9);
+    check_reductions<int16_t>(cobraml::core::CPU, 1, 4);
+
+    cobraml::core::set_parallel_threshold(threshold);
+    cobraml::core::set_thread_count(threads);
+}
+
+TEST(MatrixTestFunc, reductions_slice) {
+    std::vector mat(4, std::vector<int32_t>(5));
+    for (size_t i = 0; i < 4; ++i)
+        for (size_t j = 0; j < 5; ++j)
+            mat[i][j] = static_cast<int32_t>(i * 5 + j);
+
+    const auto matrix = cobraml::core::from_vector(mat, cobraml::core::CPU);
+    const auto view = matrix.slice(1, 3, 1, 4);
+
+    const auto rows = reduce_rows(view, cobraml::core::SUM);
+    ASSERT_EQ(rows[0].item<int32_t>(), 6 + 7 + 8);
+    ASSERT_EQ(rows[1].item<int32_t>(), 11 + 12 + 13);
+
+    const auto columns = reduce_columns(view, cobraml::core::ARGMAX);
+    for (size_t j = 0; j < 3; ++j) {
+        ASSERT_EQ(columns[j].item<int64_t>(), 1);
+    }
+
+    cobraml::core::Matrix half(2, 3, cobraml::core::CPU, cobraml::core::FLOAT16);
+    ASSERT_THROW(reduce_rows(half, cobraml::core::SUM), std::runtime_error);
+    ASSERT_THROW(reduce_columns(half, cobraml::core::MAX), std::runtime_error);
+}
+
+/**
+ ************************************* TEST VIEWS AND MOVES *************************************
+ */
+
+TEST(MatrixTestFunc, row_views) {
+    std::vector mat(4, std::vector<int32_t>(5));
+    for (size_t i = 0; i < 4; ++i)
+        for (size_t j = 0; j < 5; ++j)
+            mat[i][j] = static_cast<int32_t>(i * 5 + j);
+
+    const auto matrix = cobraml::core::from_vector(mat, cobraml::core::CPU);
+
+    const cobraml::core::RowView view{matrix.row(2)};
+    ASSERT_EQ(view.len(), 5);
+    ASSERT_EQ(view.get_dtype(), cobraml::core::INT32);
+    ASSERT_EQ(view.item<int32_t>(3), 13);
+    ASSERT_THROW(static_cast<void>(view.item<int32_t>(5)), std::out_of_range);
+    ASSERT_THROW(static_cast<void>(view.get_buffer<float>()), std::runtime_error);
+    ASSERT_THROW(static_cast<void>(matrix.row(4)), std::out_of_range);
+
+    size_t row{0};
+    for (const cobraml::core::RowView current: matrix) {
+        for (size_t j = 0; j < 5; ++j) {
+            ASSERT_EQ(current.get_buffer<int32_t>()[j], mat[row][j]);
+        }
+        ++row;
+    }
+    ASSERT_EQ(row, 4);
+
+    // rows of a view skip the columns outside it
+    row = 1;
+    for (const cobraml::core::RowView current: matrix.slice(1, 3, 2, 4)) {
+        ASSERT_EQ(current.len(), 2);
+        ASSERT_EQ(current.item<int32_t>(0), mat[row][2]);
+        ASSERT_EQ(current.item<int32_t>(1), mat[row][3]);
+        ++row;
+    }
+    ASSERT_EQ(row, 3);
+
+    const cobraml::core::Matrix empty;
+    ASSERT_TRUE(empty.begin() == empty.end());
+}
+
+TEST(MatrixTestFunc, deep_copy_views) {
+    std::vector mat(3, std::vector<int32_t>(4));
+    std::vector other_mat(3, std::vector<int32_t>(4));
+    for (size_t i = 0; i < 3; ++i)
+        for (size_t j = 0; j < 4; ++j) {
+            mat[i][j] = static_cast<int32_t>(i * 4 + j);
+            other_mat[i][j] = static_cast<int32_t>(100 + i * 4 + j);
+        }
+
+    const auto parent = cobraml::core::from_vector(mat, cobraml::core::CPU);
+    const auto other = cobraml::core::from_vector(other_mat, cobraml::core::CPU);
+
+    // view into view, both strided by their parents
+    auto source = other.slice(1, 3, 1, 3);
+    parent.slice(0, 2, 0, 2).deep_copy(source);
+
+    // packed matrix into view
+    auto packed = cobraml::core::from_vector<int32_t>({{-1, -2}, {-3, -4}}, cobraml::core::CPU);
+    parent.slice(1, 3, 2, 4).deep_copy(packed);
+
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < 4; ++j) {
+            int32_t expected{mat[i][j]};
+            if (i < 2 && j < 2)
+                expected = other_mat[i + 1][j + 1];
+            else if (i >= 1 && j >= 2)
+                expected = -static_cast<int32_t>((i - 1) * 2 + (j - 2) + 1);
+
+            ASSERT_EQ(parent.row(i).item<int32_t>(j), expected);
+        }
+    }
+
+    // view into packed matrix
+    cobraml::core::Matrix target(2, 2, cobraml::core::CPU, cobraml::core::INT32);
+    target.deep_copy(source);
+    ASSERT_EQ(target.row(0).item<int32_t>(0), other_mat[1][1]);
+    ASSERT_EQ(target.row(1).item<int32_t>(1), other_mat[2][2]);
+
+    ASSERT_THROW(parent.slice(0, 2, 0, 3).deep_copy(packed), std::runtime_error);
+}
+
+TEST(MatrixTestFunc, move) {
+    static_assert(std::is_nothrow_move_constructible_v<cobraml::core::Matrix>);
+    static_assert(std::is_nothrow_move_assignable_v<cobraml::core::Matrix>);
+
+    auto matrix = cobraml::core::from_vector<float>({{1, 2, 3}, {4, 5, 6}}, cobraml::core::CPU);
+    const float *data{cobraml::core::get_buffer<float>(matrix)};
+
+    cobraml::core::Matrix moved{std::move(matrix)};
+    ASSERT_EQ(cobraml::core::get_buffer<float>(moved), data);
+    ASSERT_EQ(moved.get_shape().rows, 2);
+    ASSERT_EQ(moved.get_shape().columns, 3);
+
+    // the source is left empty and can still be inspected and copied
+    ASSERT_EQ(matrix.get_shape().rows, 0);
+    ASSERT_EQ(matrix.get_shape().columns, 0);
+    ASSERT_EQ(matrix.len(), 0);
+    ASSERT_EQ(matrix.get_dtype(), cobraml::core::INVALID);
+    const cobraml::core::Matrix copy{matrix};
+    ASSERT_EQ(copy.get_shape().rows, 0);
+    ASSERT_TRUE(copy.begin() == copy.end());
+
+    cobraml::core::Matrix other(5, 5, cobraml::core::CPU, cobraml::core::FLOAT32);
+    other = std::move(moved);
+    ASSERT_EQ(cobraml::core::get_buffer<float>(other), data);
+    ASSERT_EQ(other.get_shape().rows, 2);
+    ASSERT_EQ(moved.get_shape().rows, 0);
+    ASSERT_EQ(moved.len(), 0);
+
+    matrix = other;
+    ASSERT_EQ(cobraml::core::get_buffer<float>(matrix), data);
+    ASSERT_EQ(matrix[1][2].item<float>(), 6);
+}
+
+TEST(MatrixTestFunc, from_vector_adopt) {
+    std::vector<double> values{1, 2, 3, 4, 5, 6};
+    const double *storage{values.data()};
+
+    const auto matrix = cobraml::core::from_vector(std::move(values), 2, 3, cobraml::core::CPU);
+    ASSERT_EQ(cobraml::core::get_buffer<double>(matrix), storage);
+    ASSERT_EQ(matrix.get_shape().rows, 2);
+    ASSERT_EQ(matrix[1][0].item<double>(), 4);
+
+    std::vector<std::vector<int16_t>> single{{7, 8, 9}};
+    const int16_t *row_storage{single[0].data()};
+    const auto vector = cobraml::core::from_vector(std::move(single), cobraml::core::CPU);
+    ASSERT_EQ(cobraml::core::get_buffer<int16_t>(vector), row_storage);
+    ASSERT_EQ(vector[2].item<int16_t>(), 9);
+
+    ASSERT_THROW(
+        cobraml::core::from_vector(std::vector<float>{1, 2, 3}, 2, 2, cobraml::core::CPU), std::runtime_error);
+    ASSERT_THROW(
+        cobraml::core::from_vector(std::vector<float>{}, 0, 2, cobraml::core::CPU), std::runtime_error);
+}
+
+/**
+ ************************************* TEST WRAP *************************************
+ */
+
+TEST(MatrixTestFunc, wrap) {
+    std::vector<float> external{1, 2, 3, 4, 5, 6};
+    size_t released{0};
+
+    {
+        const auto matrix = cobraml::core::wrap(
+            external.data(), 2, 3, cobraml::core::CPU, cobraml::core::FLOAT32, [&released]() { ++released; });
+
+        ASSERT_EQ(cobraml::core::get_buffer<float>(matrix), external.data());
+        ASSERT_EQ(matrix[1][2].item<float>(), 6);
+
+        const cobraml::core::Matrix copy{matrix};
+        ASSERT_EQ(released, 0);
+    }
+
+    ASSERT_EQ(released, 1);
+}
+
+TEST(MatrixTestFunc, wrap_external_writes) {
+    std::vector<float> external{1, 0, 0, 1};
+    const auto matrix = cobraml::core::wrap(
+        external.data(), 2, 2, cobraml::core::CPU, cobraml::core::FLOAT32, std::function<void()>{});
+    const auto vec = cobraml::core::from_vector<float>({{1, 0}}, cobraml::core::CPU);
+    cobraml::core::Matrix res(1, 2, cobraml::core::CPU, cobraml::core::FLOAT32);
+
+    gemv_cosine(matrix, vec, res, 1.0f, 0.0f);
+    ASSERT_FLOAT_EQ(res[0].item<float>(), 1);
+
+    // the owner writes the memory without the library seeing it, no stale norm may be used
+    external[0] = 6;
+    gemv_cosine(matrix, vec, res, 1.0f, 0.0f);
+    ASSERT_FLOAT_EQ(res[0].item<float>(), 1);
+    ASSERT_FLOAT_EQ(res[1].item<float>(), 0);
+}
+
+TEST(MatrixTestFunc, wrap_misaligned) {
+    const std::vector<float> values{1.5f, -2.25f, 3.125f, 4};
+
+    // an odd offset into a float aligned block can never be float aligned
+    std::vector<float> storage(values.size() + 1);
+    auto *bytes{reinterpret_cast<char *>(storage.data()) + 1};
+    std::memcpy(bytes, values.data(), values.size() * sizeof(float));
+    ASSERT_FALSE(cobraml::core::is_aligned(bytes, cobraml::core::FLOAT32));
+    ASSERT_TRUE(cobraml::core::is_aligned(bytes, cobraml::core::INT8));
+
+    size_t released{0};
+    const auto matrix = cobraml::core::wrap(
+        bytes, 2, 2, cobraml::core::CPU, cobraml::core::FLOAT32, [&released]() { ++released; });
+
+    // the data was copied, so the external memory is released straight away
+    ASSERT_EQ(released, 1);
+    ASSERT_NE(static_cast<const void *>(cobraml::core::get_buffer<float>(matrix)), bytes);
+    ASSERT_TRUE(cobraml::core::is_aligned(cobraml::core::get_buffer<float>(matrix), cobraml::core::FLOAT32));
+
+    for (size_t i = 0; i < 2; ++i) {
+        for (size_t j = 0; j < 2; ++j) {
+            ASSERT_EQ(matrix[i][j].item<float>(), values[i * 2 + j]);
+        }
+    }
+}
+
+TEST(MatrixTestFunc, wrap_owner) {
+    auto owner{std::make_shared<std::vector<int64_t>>(std::vector<int64_t>{7, 8, 9})};
+    const std::weak_ptr<std::vector<int64_t>> observer{owner};
+    int64_t *data{owner->data()};
+
+    auto matrix = cobraml::core::wrap(data, 1, 3, cobraml::core::CPU, cobraml::core::INT64, std::move(owner));
+    ASSERT_FALSE(observer.expired());
+    ASSERT_EQ(matrix[2].item<int64_t>(), 9);
+
+    matrix = cobraml::core::Matrix();
+    ASSERT_TRUE(observer.expired());
+
+    ASSERT_THROW(
+        cobraml::core::wrap(nullptr, 1, 1, cobraml::core::CPU, cobraml::core::FLOAT32, std::function<void()>{}),
+        std::runtime_error);
+    float value{0};
+    ASSERT_THROW(
+        cobraml::core::wrap(&value, 0, 1, cobraml::core::CPU, cobraml::core::FLOAT32, std::function<void()>{}),
+        std::runtime_error);
+}
@@ -0,0 +1,138 @@
+//
+// Created by sriram on 2/12/25.
+//
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <gtest/gtest.h>
+#include "matrix_io.h"
+
+std::string temp_matrix_path(const std::string &name) {
+    return (std::filesystem::temp_directory_path() / ("cobraml_" + name + ".cbm")).string();
+}
+
+std::vector<std::vector<double> > create_double_vector(size_t const rows, size_t const columns) {
+    std::vector ret(rows, std::vector(columns, 0.0));
+
+    std::uniform_real_distribution<double> unif{-3.0, 5.0};
+    std::default_random_engine gen{11};
+
+    for (auto &vector: ret) {
+        for (auto &num: vector) {
+            num = unif(gen);
+        }
+    }
+
+    return ret;
+}
+
+TEST(MatrixIOTest, test_round_trip) {
+    const std::string path{temp_matrix_path("round_trip")};
+    const auto mat_vec{create_double_vector(17, 33)};
+    const auto mat = cobraml::core::from_vector(mat_vec, cobraml::core::CPU);
+
+    save(mat, path);
+
+    for (const auto device: {cobraml::core::CPU, cobraml::core::CPU_X}) {
+        const cobraml::core::Matrix loaded = cobraml::core::load(path, device);
+
+        ASSERT_EQ(loaded.get_shape(), mat.get_shape());
+        ASSERT_EQ(loaded.get_dtype(), cobraml::core::FLOAT64);
+        ASSERT_EQ(loaded.get_device(), device);
+
+        const double *buff = cobraml::core::get_buffer<double>(loaded);
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(buff) % 64, 0);
+
+        for (size_t i = 0; i < 17; ++i) {
+            for (size_t j = 0; j < 33; ++j) {
+                ASSERT_EQ(buff[i * 33 + j], mat_vec[i][j]);
+            }
+        }
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST(MatrixIOTest, test_save_view) {
+    const std::string path{temp_matrix_path("view")};
+    const auto mat_vec{create_double_vector(12, 20)};
+    const auto mat = cobraml::core::from_vector(mat_vec, cobraml::core::CPU);
+
+    save(mat.slice(2, 9, 4, 15), path);
+    const cobraml::core::Matrix loaded = cobraml::core::load(path, cobraml::core::CPU);
+
+    ASSERT_EQ(loaded.get_shape(), (cobraml::core::Matrix::Shape{7, 11}));
+    ASSERT_TRUE(loaded.is_contiguous());
+
+    const double *buff = cobraml::core::get_buffer<double>(loaded);
+    for (size_t i = 0; i < 7; ++i) {
+        for (size_t j = 0; j < 11; ++j) {
+            ASSERT_EQ(buff[i * 11 + j], mat_vec[i + 2][j + 4]);
+        }
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST(MatrixIOTest, test_gemv_loaded) {
+    const std::string path{temp_matrix_path("gemv")};
+    const auto mat_vec{create_double_vector(9, 40)};
+    const auto vec_vec{create_double_vector(1, 40)};
+
+    const auto mat = cobraml::core::from_vector(mat_vec, cobraml::core::CPU);
+    const auto vec = cobraml::core::from_vector(vec_vec, cobraml::core::CPU);
+    save(mat, path);
+
+    cobraml::core::Matrix expected(1, 9, cobraml::core::CPU, cobraml::core::FLOAT64);
+    gemv(mat, vec, expected, 1.0, 0.0);
+
+    cobraml::core::Matrix result(1, 9, cobraml::core::CPU, cobraml::core::FLOAT64);
+    gemv(cobraml::core::load(path, cobraml::core::CPU), vec, result, 1.0, 0.0);
+
+    for (size_t i = 0; i < 9; ++i) {
+        ASSERT_EQ(result[i].item<double>(), expected[i].item<double>());
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST(MatrixIOTest, test_private_mapping) {
+    const std::string path{temp_matrix_path("private")};
+    const auto mat = cobraml::core::from_vector<int32_t>({{1, 2, 3}, {4, 5, 6}}, cobraml::core::CPU);
+    save(mat, path);
+
+    {
+        const cobraml::core::Matrix loaded = cobraml::core::load(path, cobraml::core::CPU);
+        loaded[1][2].set_item<int32_t>(60);
+        ASSERT_EQ(loaded[1][2].item<int32_t>(), 60);
+    }
+
+    const cobraml::core::Matrix reloaded = cobraml::core::load(path, cobraml::core::CPU);
+    ASSERT_EQ(reloaded[1][2].item<int32_t>(), 6);
+
+    std::filesystem::remove(path);
+}
+
+TEST(MatrixIOTest, test_invalid_files) {
+    ASSERT_THROW(cobraml::core::load(temp_matrix_path("missing"), cobraml::core::CPU), std::runtime_error);
+
+    const std::string path{temp_matrix_path("invalid")};
+    const auto mat = cobraml::core::from_vector<float>({{1, 2, 3, 4}}, cobraml::core::CPU);
+    save(mat, path);
+
+    ASSERT_THROW(cobraml::core::load(path, cobraml::core::GPU), std::runtime_error);
+
+    // drop the last element
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 4);
+    ASSERT_THROW(cobraml::core::load(path, cobraml::core::CPU), std::runtime_error);
+
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << "definitely not a matrix file, but long enough to hold a header if it were one......";
+    }
+
+    ASSERT_THROW(cobraml::core::load(path, cobraml::core::CPU), std::runtime_error);
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,115 @@
+//
+// Created by sriram on 2/8/25.
+//
+
+#include <random>
+#include <gtest/gtest.h>
+#include "quantized_matrix.h"
+
+std::vector<std::vector<float> > create_float_vector(size_t const rows, size_t const columns) {
+    std::vector ret(rows, std::vector(columns, 0.0f));
+
+    std::uniform_real_distribution<float> unif{-3.0f, 5.0f};
+    std::default_random_engine gen{7};
+
+    for (auto &vector: ret) {
+        for (auto &num: vector) {
+            num = unif(gen);
+        }
+    }
+
+    return ret;
+}
+
+TEST(QuantizedMatrixTest, test_quantize_shape) {
+    const auto mat = cobraml::core::from_vector(create_float_vector(7, 19), cobraml::core::CPU);
+    const cobraml::core::QuantizedMatrix q_mat = quantize(mat);
+
+    ASSERT_EQ(q_mat.get_shape(), mat.get_shape());
+    ASSERT_EQ(q_mat.get_device(), cobraml::core::CPU);
+    ASSERT_EQ(q_mat.get_data().get_dtype(), cobraml::core::INT8);
+    ASSERT_EQ(q_mat.get_scales().get_dtype(), cobraml::core::FLOAT32);
+    ASSERT_EQ(q_mat.get_scales().get_shape().columns, 7);
+    ASSERT_EQ(q_mat.get_zero_points().get_dtype(), cobraml::core::INT32);
+
+    const cobraml::core::Matrix int_mat(3, 3, cobraml::core::CPU, cobraml::core::INT32);
+    ASSERT_THROW(quantize(int_mat), std::runtime_error);
+    ASSERT_THROW(quantize(mat.slice(0, 7, 1, 19)), std::runtime_error);
+}
+
+TEST(QuantizedMatrixTest, test_round_trip) {
+    auto mat_vec{create_float_vector(13, 150)};
+    mat_vec[2] = std::vector(150, 0.0f);
+
+    const auto mat = cobraml::core::from_vector(mat_vec, cobraml::core::CPU);
+    const cobraml::core::Matrix restored = dequantize(quantize(mat));
+    const float *restored_buff = cobraml::core::get_buffer<float>(restored);
+
+    for (size_t i = 0; i < mat_vec.size(); ++i) {
+        for (size_t j = 0; j < mat_vec[i].size(); ++j) {
+            // the quantization step of a row spanning [-3, 5] is 8 / 255
+            ASSERT_NEAR(restored_buff[i * 150 + j], mat_vec[i][j], 8.0f / 255.0f);
+        }
+    }
+}
+
+TEST(QuantizedMatrixTest, test_invalid_gemv) {
+    const auto q_mat = quantize(cobraml::core::from_vector(create_float_vector(10, 20), cobraml::core::CPU));
+    const cobraml::core::Matrix vec(1, 20, cobraml::core::CPU, cobraml::core::FLOAT32);
+    cobraml::core::Matrix res(1, 10, cobraml::core::CPU, cobraml::core::FLOAT32);
+
+    ASSERT_NO_THROW(gemv(q_mat, vec, res, 1.0f, 0.0f));
+
+    const cobraml::core::Matrix vec2(1, 19, cobraml::core::CPU, cobraml::core::FLOAT32);
+    ASSERT_THROW(gemv(q_mat, vec2, res, 1.0f, 0.0f), std::runtime_error);
+
+    const cobraml::core::Matrix vec3(1, 20, cobraml::core::CPU, cobraml::core::FLOAT64);
+    ASSERT_THROW(gemv(q_mat, vec3, res, 1.0f, 0.0f), std::runtime_error);
+
+    cobraml::core::Matrix res2(1, 10, cobraml::core::CPU_X, cobraml::core::FLOAT32);
+    ASSERT_THROW(gemv(q_mat, vec, res2, 1.0f, 0.0f), std::runtime_error);
+}
+
+void check_quantized_gemv(cobraml::core::Device const device) {
+    constexpr size_t rows{37};
+    constexpr size_t columns{523};
+
+    auto const mat_vec{create_float_vector(rows, columns)};
+    auto const vec_vec{create_float_vector(1, columns)};
+
+    const auto q_mat = quantize(cobraml::core::from_vector(mat_vec, device));
+    const auto vec = cobraml::core::from_vector(vec_vec, device);
+    auto res = cobraml::core::from_vector(std::vector(1, std::vector(rows, 1.0f)), device);
+
+    gemv(q_mat, vec, res, 2.0f, 0.5f);
+    const float *res_buff = cobraml::core::get_buffer<float>(res);
+
+    for (size_t i = 0; i < rows; ++i) {
+        float expected = 0;
+        float magnitude = 0;
+        for (size_t j = 0; j < columns; ++j) {
+            expected += mat_vec[i][j] * vec_vec[0][j];
+            magnitude += std::fabs(mat_vec[i][j] * vec_vec[0][j]);
+        }
+
+        expected = expected * 2.0f + 0.5f;
+
+        // quantization error is bounded by about 1% of the summed magnitudes
+        ASSERT_NEAR(res_buff[i], expected, 0.02f * magnitude);
+    }
+}
+
+TEST(QuantizedMatrixTest, test_gemv) {
+    check_quantized_gemv(cobraml::core::CPU);
+}
+
+TEST(QuantizedMatrixTest, test_gemv_accelerated) {
+    const cobraml::core::SimdLevel detected{cobraml::core::detected_simd_level()};
+
+    for (int level = cobraml::core::SCALAR; level <= detected; ++level) {
+        cobraml::core::set_simd_level(static_cast<cobraml::core::SimdLevel>(level));
+        check_quantized_gemv(cobraml::core::CPU_X);
+    }
+
+    cobraml::core::set_simd_level(detected);
+}
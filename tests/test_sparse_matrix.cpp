@@ -0,0 +1,161 @@
+//
+// Created by sriram on 2/20/25.
+//
+
+#include <random>
+#include <gtest/gtest.h>
+#include "sparse_matrix.h"
+#include "threading.h"
+
+template<typename T>
+static std::vector<T> dense_gemv(
+    const std::vector<size_t> &row_indices,
+    const std::vector<size_t> &column_indices,
+    const std::vector<T> &values,
+    const std::vector<T> &vector,
+    std::vector<T> result,
+    T const alpha,
+    T const beta) {
+    std::vector<T> partial(result.size(), 0);
+
+    for (size_t i = 0; i < values.size(); ++i)
+        partial[row_indices[i]] = static_cast<T>(partial[row_indices[i]] + values[i] * vector[column_indices[i]]);
+
+    for (size_t i = 0; i < result.size(); ++i)
+        result[i] = static_cast<T>(alpha * partial[i] + beta * result[i]);
+
+    return result;
+}
+
+template<typename T>
+static void check_gemv(
+    size_t const rows,
+    size_t const columns,
+    const std::vector<size_t> &row_indices,
+    const std::vector<size_t> &column_indices,
+    const std::vector<T> &values,
+    T const alpha,
+    T const beta) {
+    std::vector<T> vector(columns);
+    std::vector<T> result(rows);
+    std::uniform_int_distribution<> unif{-5, 5};
+    std::default_random_engine gen{7};
+
+    for (auto &num: vector) num = static_cast<T>(unif(gen));
+    for (auto &num: result) num = static_cast<T>(unif(gen));
+
+    std::vector<T> const expected{
+        dense_gemv(row_indices, column_indices, values, vector, result, alpha, beta)};
+
+    for (auto const device: {cobraml::core::CPU, cobraml::core::CPU_X}) {
+        const cobraml::core::SparseMatrix matrix{
+            cobraml::core::from_triplets(rows, columns, row_indices, column_indices, values, device)};
+        const cobraml::core::Matrix x{cobraml::core::from_vector(std::vector<std::vector<T>>{vector}, device)};
+        cobraml::core::Matrix y{cobraml::core::from_vector(std::vector<std::vector<T>>{result}, device)};
+
+        cobraml::core::gemv(matrix, x, y, alpha, beta);
+
+        const T *buff{cobraml::core::get_buffer<T>(y)};
+        for (size_t i = 0; i < rows; ++i)
+            ASSERT_EQ(buff[i], expected[i]);
+    }
+}
+
+TEST(SparseMatrixTest, test_from_triplets) {
+    // unsorted, with a duplicate at (2, 1)
+    const cobraml::core::SparseMatrix matrix{
+        cobraml::core::from_triplets<int32_t>(
+            4, 3,
+            {2, 0, 2, 2, 0},
+            {1, 2, 0, 1, 0},
+            {5, 3, 7, 4, 1},
+            cobraml::core::CPU)};
+
+    ASSERT_EQ(matrix.get_shape().rows, 4);
+    ASSERT_EQ(matrix.get_shape().columns, 3);
+    ASSERT_EQ(matrix.get_dtype(), cobraml::core::INT32);
+    ASSERT_EQ(matrix.get_device(), cobraml::core::CPU);
+    ASSERT_EQ(matrix.get_nonzeros(), 4);
+
+    const std::vector<int64_t> pointers{0, 2, 2, 4, 4};
+    const std::vector<int64_t> indices{0, 2, 0, 1};
+    const std::vector<int32_t> values{1, 3, 7, 9};
+
+    const auto *p{cobraml::core::get_buffer<int64_t>(matrix.get_row_pointers())};
+    const auto *c{cobraml::core::get_buffer<int64_t>(matrix.get_column_indices())};
+    const auto *v{cobraml::core::get_buffer<int32_t>(matrix.get_values())};
+
+    for (size_t i = 0; i < pointers.size(); ++i)
+        ASSERT_EQ(p[i], pointers[i]);
+
+    for (size_t i = 0; i < values.size(); ++i) {
+        ASSERT_EQ(c[i], indices[i]);
+        ASSERT_EQ(v[i], values[i]);
+    }
+}
+
+TEST(SparseMatrixTest, test_from_triplets_invalid) {
+    ASSERT_THROW(
+        cobraml::core::from_triplets<float>(0, 3, {}, {}, {}, cobraml::core::CPU), std::runtime_error);
+    ASSERT_THROW(
+        cobraml::core::from_triplets<float>(2, 3, {0, 1}, {0}, {1, 2}, cobraml::core::CPU), std::runtime_error);
+    ASSERT_THROW(
+        cobraml::core::from_triplets<float>(2, 3, {2}, {0}, {1}, cobraml::core::CPU), std::out_of_range);
+    ASSERT_THROW(
+        cobraml::core::from_triplets<float>(2, 3, {0}, {3}, {1}, cobraml::core::CPU), std::out_of_range);
+
+    const cobraml::core::SparseMatrix empty{
+        cobraml::core::from_triplets<float>(2, 3, {}, {}, {}, cobraml::core::CPU)};
+    ASSERT_EQ(empty.get_nonzeros(), 0);
+}
+
+TEST(SparseMatrixTest, test_gemv) {
+    check_gemv<int32_t>(4, 3, {2, 0, 2, 2, 0}, {1, 2, 0, 1, 0}, {5, 3, 7, 4, 1}, 2, 3);
+    check_gemv<int64_t>(4, 3, {3, 1, 0}, {2, 0, 1}, {9, -4, 2}, 1, 0);
+    check_gemv<double>(4, 3, {3, 1, 0}, {2, 0, 1}, {0.5, -4, 2}, 1, 1);
+    check_gemv<float>(2, 3, {}, {}, {}, 1, 2);
+}
+
+TEST(SparseMatrixTest, test_gemv_skewed) {
+    size_t const threshold{cobraml::core::get_parallel_threshold()};
+    size_t const threads{cobraml::core::get_thread_count()};
+    cobraml::core::set_parallel_threshold(0);
+    cobraml::core::set_thread_count(3);
+
+    // one long row spread over every thread, with empty rows around it
+    std::vector<size_t> row_indices;
+    std::vector<size_t> column_indices;
+    std::vector<int32_t> values;
+
+    for (size_t i = 0; i < 200; ++i) {
+        row_indices.push_back(2);
+        column_indices.push_back(i);
+        values.push_back(static_cast<int32_t>(i % 7) - 3);
+    }
+
+    for (size_t i = 0; i < 10; ++i) {
+        row_indices.push_back(5 + i);
+        column_indices.push_back(i * 3);
+        values.push_back(static_cast<int32_t>(i) + 1);
+    }
+
+    check_gemv<int32_t>(20, 200, row_indices, column_indices, values, 1, 2);
+
+    cobraml::core::set_parallel_threshold(threshold);
+    cobraml::core::set_thread_count(threads);
+}
+
+TEST(SparseMatrixTest, test_gemv_invalid) {
+    const cobraml::core::SparseMatrix matrix{
+        cobraml::core::from_triplets<float>(2, 3, {0, 1}, {0, 2}, {1, 2}, cobraml::core::CPU)};
+    const cobraml::core::Matrix x(1, 3, cobraml::core::CPU, cobraml::core::FLOAT32);
+    cobraml::core::Matrix y(1, 2, cobraml::core::CPU, cobraml::core::FLOAT32);
+    cobraml::core::Matrix wrong(1, 3, cobraml::core::CPU, cobraml::core::FLOAT32);
+    cobraml::core::Matrix doubles(1, 2, cobraml::core::CPU, cobraml::core::FLOAT64);
+
+    ASSERT_NO_THROW(cobraml::core::gemv(matrix, x, y, 1.0f, 0.0f));
+    ASSERT_THROW(cobraml::core::gemv(matrix, y, y, 1.0f, 0.0f), std::runtime_error);
+    ASSERT_THROW(cobraml::core::gemv(matrix, x, wrong, 1.0f, 0.0f), std::runtime_error);
+    ASSERT_THROW(cobraml::core::gemv(matrix, x, doubles, 1.0f, 0.0f), std::runtime_error);
+    ASSERT_THROW(cobraml::core::gemv(matrix, x, y, 1.0, 0.0), std::runtime_error);
+}
@@ -0,0 +1,175 @@
+//
+// Created by sriram on 2/24/25.
+//
+
+#include <chrono>
+#include <thread>
+#include <gtest/gtest.h>
+#include "stream.h"
+#include "test_helpers.h"
+
+template<typename T>
+static cobraml::core::Matrix random_matrix(size_t const rows, size_t const columns, unsigned const seed) {
+    return cobraml::core::from_vector(random_values<T>(rows, columns, seed), cobraml::core::CPU);
+}
+
+TEST(StreamTest, test_in_order) {
+    cobraml::core::Stream stream;
+    std::vector<int> order;
+
+    for (int i = 0; i < 100; ++i) {
+        stream.enqueue([&order, i] { order.push_back(i); });
+    }
+
+    stream.synchronize();
+
+    ASSERT_EQ(order.size(), 100);
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_EQ(order[static_cast<size_t>(i)], i);
+    }
+}
+
+TEST(StreamTest, test_concurrent_streams) {
+    cobraml::core::Stream first;
+    cobraml::core::Stream second;
+    std::promise<void> signal;
+    std::shared_future<void> signalled{signal.get_future().share()};
+
+    // only finishes if the second stream runs while the first is blocked
+    const cobraml::core::Event waiting{first.enqueue([signalled] {
+        if (signalled.wait_for(std::chrono::seconds(30)) != std::future_status::ready) {
+            throw std::runtime_error("streams did not run concurrently");
+        }
+    })};
+
+    second.enqueue([&signal] { signal.set_value(); });
+
+    ASSERT_NO_THROW(waiting.get());
+}
+
+TEST(StreamTest, test_exception) {
+    cobraml::core::Stream stream;
+    const cobraml::core::Event failed{stream.enqueue([] { throw std::runtime_error("failed"); })};
+    bool ran{false};
+    const cobraml::core::Event after{stream.enqueue([&ran] { ran = true; })};
+
+    ASSERT_THROW(failed.get(), std::runtime_error);
+    after.get();
+    ASSERT_TRUE(ran);
+}
+
+TEST(StreamTest, test_gemv_async) {
+    const auto matrix{random_matrix<float>(300, 200, 1)};
+    const auto vector{random_matrix<float>(1, 200, 2)};
+    cobraml::core::Matrix expected(1, 300, cobraml::core::CPU, cobraml::core::FLOAT32);
+    cobraml::core::Matrix result(1, 300, cobraml::core::CPU, cobraml::core::FLOAT32);
+
+    gemv(matrix, vector, expected, 2.0f, 0.0f);
+
+    cobraml::core::Stream stream;
+    gemv_async(stream, matrix, vector, result, 1.0f, 0.0f);
+    // ordered after the first gemv, so the result doubles
+    const cobraml::core::Event done{gemv_async(stream, matrix, vector, result, 1.0f, 1.0f)};
+    done.get();
+
+    const float *buff{cobraml::core::get_buffer<float>(result)};
+    const float *expected_buff{cobraml::core::get_buffer<float>(expected)};
+    for (size_t i = 0; i < 300; ++i) {
+        ASSERT_EQ(buff[i], expected_buff[i]);
+    }
+
+    cobraml::core::Matrix wrong(1, 7, cobraml::core::CPU, cobraml::core::FLOAT32);
+    ASSERT_THROW(gemv_async(stream, matrix, vector, wrong, 1.0f, 0.0f).get(), std::runtime_error);
+}
+
+TEST(StreamTest, test_pipeline) {
+    const auto matrix{random_matrix<int32_t>(64, 32, 3)};
+    const auto queries{random_matrix<int32_t>(8, 32, 4)};
+    cobraml::core::Matrix expected(8, 64, cobraml::core::CPU, cobraml::core::INT32);
+    gemv_batched(matrix, queries, expected, 1, 0);
+
+    std::vector<cobraml::core::Matrix> results;
+    for (size_t i = 0; i < 4; ++i) {
+        results.emplace_back(8, 64, cobraml::core::CPU, cobraml::core::INT32);
+    }
+
+    {
+        std::vector<std::unique_ptr<cobraml::core::Stream>> streams;
+        for (size_t i = 0; i < 4; ++i) {
+            streams.push_back(std::make_unique<cobraml::core::Stream>());
+            gemv_batched_async(*streams.back(), matrix, queries, results[i], 1, 0);
+        }
+        // the streams wait for their work when they go out of scope
+    }
+
+    for (const auto &result: results) {
+        const int32_t *buff{cobraml::core::get_buffer<int32_t>(result)};
+        const int32_t *expected_buff{cobraml::core::get_buffer<int32_t>(expected)};
+        for (size_t i = 0; i < 8 * 64; ++i) {
+            ASSERT_EQ(buff[i], expected_buff[i]);
+        }
+    }
+}
+
+TEST(StreamTest, test_worker_limit) {
+    {
+        std::vector<std::unique_ptr<cobraml::core::Stream>> streams;
+        for (size_t i = 0; i < 64; ++i) {
+            streams.push_back(std::make_unique<cobraml::core::Stream>());
+            streams.back()->enqueue([] { std::this_thread::sleep_for(std::chrono::milliseconds(1)); });
+        }
+    }
+
+    // a burst of streams never grows the pool past one worker per hardware thread
+    size_t const limit{std::max<size_t>(2, std::thread::hardware_concurrency())};
+    ASSERT_GE(cobraml::core::stream_workers(), 1);
+    ASSERT_LE(cobraml::core::stream_workers(), limit);
+}
+
+TEST(StreamTest, test_other_async) {
+    auto x = cobraml::core::from_vector<float>({{3, -4, 0}}, cobraml::core::CPU);
+    auto y = cobraml::core::from_vector<float>({{1, 1, 1}}, cobraml::core::CPU);
+    const auto matrix = cobraml::core::from_vector<float>({{1, 2}, {3, 4}}, cobraml::core::CPU);
+    cobraml::core::Stream stream;
+
+    axpy_async(stream, 2.0f, x, y);
+    scal_async(stream, 0.5f, y);
+    const std::shared_future<float> dot{cobraml::core::dot_async<float>(stream, x, y)};
+    const std::shared_future<float> norm{cobraml::core::nrm2_async<float>(stream, x)};
+    const std::shared_future<float> sum{cobraml::core::asum_async<float>(stream, x)};
+    const std::shared_future<size_t> largest{iamax_async(stream, x)};
+    const std::shared_future<cobraml::core::Matrix> rows{reduce_rows_async(stream, matrix, cobraml::core::SUM)};
+    const std::shared_future<cobraml::core::Matrix> columns{
+        reduce_columns_async(stream, matrix, cobraml::core::MAX)};
+
+    // y = (2x + 1) / 2 = {3.5, -3.5, 0.5}
+    ASSERT_EQ(dot.get(), 3 * 3.5f + -4 * -3.5f);
+    ASSERT_EQ(norm.get(), 5);
+    ASSERT_EQ(sum.get(), 7);
+    ASSERT_EQ(largest.get(), 1);
+    ASSERT_EQ(rows.get()[1].item<float>(), 7);
+    ASSERT_EQ(columns.get()[0].item<float>(), 3);
+
+    const auto wrong = cobraml::core::from_vector<float>({{1, 2}}, cobraml::core::CPU);
+    ASSERT_THROW(cobraml::core::dot_async<float>(stream, x, wrong).get(), std::runtime_error);
+}
+
+TEST(StreamTest, test_sparse_async) {
+    const auto sparse = cobraml::core::from_triplets<float>(
+        2, 3, {0, 1, 1}, {2, 0, 1}, {5, 1, 2}, cobraml::core::CPU);
+    const auto dense = cobraml::core::from_vector<float>({{0, 0, 5}, {1, 2, 0}}, cobraml::core::CPU);
+    const auto vector = cobraml::core::from_vector<float>({{1, 2, 3}}, cobraml::core::CPU);
+    const auto indices = cobraml::core::from_vector<int64_t>({{0, 2}}, cobraml::core::CPU);
+    const auto values = cobraml::core::from_vector<float>({{1, 3}}, cobraml::core::CPU);
+    cobraml::core::Matrix sparse_result(1, 2, cobraml::core::CPU, cobraml::core::FLOAT32);
+    cobraml::core::Matrix query_result(1, 2, cobraml::core::CPU, cobraml::core::FLOAT32);
+
+    cobraml::core::Stream stream;
+    gemv_async(stream, sparse, vector, sparse_result, 1.0f, 0.0f);
+    gemv_sparse_query_async(stream, dense, indices, values, query_result, 1.0f, 0.0f).get();
+
+    ASSERT_EQ(sparse_result[0].item<float>(), 15);
+    ASSERT_EQ(sparse_result[1].item<float>(), 5);
+    ASSERT_EQ(query_result[0].item<float>(), 15);
+    ASSERT_EQ(query_result[1].item<float>(), 1);
+}
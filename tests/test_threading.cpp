@@ -0,0 +1,92 @@
+//
+// Created by sriram on 2/16/25.
+//
+
+#include <sched.h>
+#include <gtest/gtest.h>
+#include "matrix.h"
+#include "threading.h"
+#include "test_helpers.h"
+
+static size_t affinity_count() {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    sched_getaffinity(0, sizeof(set), &set);
+    return static_cast<size_t>(CPU_COUNT(&set));
+}
+
+static cobraml::core::Matrix random_matrix(size_t const rows, size_t const columns) {
+    return cobraml::core::from_vector(random_values<float>(rows, columns, 3), cobraml::core::CPU);
+}
+
+TEST(ThreadingTest, test_thread_count) {
+    size_t const available{affinity_count()};
+
+    ASSERT_GE(cobraml::core::default_thread_count(), 1);
+    ASSERT_EQ(cobraml::core::get_thread_count(), cobraml::core::default_thread_count());
+
+    cobraml::core::set_thread_count(3);
+    ASSERT_EQ(cobraml::core::get_thread_count(), 3);
+
+    cobraml::core::set_thread_count(0);
+    ASSERT_EQ(cobraml::core::get_thread_count(), cobraml::core::default_thread_count());
+
+    if (std::getenv("OMP_NUM_THREADS") == nullptr) {
+        ASSERT_LE(cobraml::core::default_thread_count(), available);
+    }
+}
+
+TEST(ThreadingTest, test_results_independent_of_threads) {
+    const auto mat{random_matrix(301, 77)};
+    const auto vec{random_matrix(1, 77)};
+
+    const auto vec_t{random_matrix(1, 301)};
+
+    cobraml::core::Matrix expected(1, 301, cobraml::core::CPU, cobraml::core::FLOAT32);
+    cobraml::core::Matrix expected_t(1, 77, cobraml::core::CPU, cobraml::core::FLOAT32);
+    cobraml::core::set_thread_count(1);
+    gemv(mat, vec, expected, 1.0f, 0.0f);
+    gemv(mat, vec_t, expected_t, 1.0f, 0.0f, true);
+
+    size_t const threshold{cobraml::core::get_parallel_threshold()};
+    cobraml::core::set_parallel_threshold(0);
+
+    for (size_t const threads: {2UL, 3UL, 8UL}) {
+        cobraml::core::set_thread_count(threads);
+        cobraml::core::Matrix result(1, 301, cobraml::core::CPU, cobraml::core::FLOAT32);
+        gemv(mat, vec, result, 1.0f, 0.0f);
+
+        for (size_t i = 0; i < 301; ++i) {
+            ASSERT_EQ(result[i].item<float>(), expected[i].item<float>());
+        }
+
+        // the per thread column buffers are summed in thread order, small integers keep the sums exact
+        cobraml::core::Matrix result_t(1, 77, cobraml::core::CPU, cobraml::core::FLOAT32);
+        gemv(mat, vec_t, result_t, 1.0f, 0.0f, true);
+
+        for (size_t i = 0; i < 77; ++i) {
+            ASSERT_EQ(result_t[i].item<float>(), expected_t[i].item<float>());
+        }
+    }
+
+    cobraml::core::set_parallel_threshold(threshold);
+    cobraml::core::set_thread_count(0);
+}
+
+TEST(ThreadingTest, test_pinning) {
+    size_t const available{affinity_count()};
+    ASSERT_FALSE(cobraml::core::get_thread_pinning());
+
+    const auto mat{random_matrix(64, 64)};
+    const auto vec{random_matrix(1, 64)};
+    cobraml::core::Matrix result(1, 64, cobraml::core::CPU, cobraml::core::FLOAT32);
+
+    cobraml::core::set_thread_pinning(true);
+    gemv(mat, vec, result, 1.0f, 0.0f);
+    ASSERT_TRUE(cobraml::core::get_thread_pinning());
+    ASSERT_EQ(affinity_count(), 1);
+
+    cobraml::core::set_thread_pinning(false);
+    gemv(mat, vec, result, 1.0f, 0.0f);
+    ASSERT_EQ(affinity_count(), available);
+}
@@ -0,0 +1,203 @@
+//
+// Created by sriram on 2/18/25.
+//
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <set>
+#include <gtest/gtest.h>
+#include "matrix.h"
+#include "threading.h"
+#include "tuning.h"
+
+static const std::set<std::string> kernel_names{
+    "gemv_naive",
+    "gemv_parallel",
+    "gemv_parallel_simd",
+    "gemv_blocked_2",
+    "gemv_blocked_4",
+    "gemv_blocked_8",
+    "gemv_blocked_2_tiled",
+    "gemv_blocked_4_tiled",
+    "gemv_blocked_8_tiled",
+};
+
+template<typename T>
+static cobraml::core::Matrix random_matrix(size_t const rows, size_t const columns) {
+    std::vector mat(rows, std::vector<T>(columns));
+    std::uniform_int_distribution<> unif{-8, 8};
+    std::default_random_engine gen{5};
+
+    for (auto &row: mat)
+        for (auto &num: row)
+            num = static_cast<T>(unif(gen));
+
+    return cobraml::core::from_vector(mat, cobraml::core::CPU);
+}
+
+TEST(TuningTest, test_defaults) {
+    cobraml::core::clear_tuning();
+    ASSERT_FALSE(cobraml::core::get_autotuning());
+    ASSERT_EQ(cobraml::core::tuned_gemv_kernel(cobraml::core::FLOAT32, 100, 100), "gemv_blocked_2_tiled");
+}
+
+TEST(TuningTest, test_calibrate) {
+    cobraml::core::clear_tuning();
+    cobraml::core::calibrate_gemv(cobraml::core::INT32, 70, 300);
+
+    ASSERT_TRUE(kernel_names.count(cobraml::core::tuned_gemv_kernel(cobraml::core::INT32, 70, 300)));
+    // same power of two buckets share an entry
+    ASSERT_EQ(
+        cobraml::core::tuned_gemv_kernel(cobraml::core::INT32, 70, 300),
+        cobraml::core::tuned_gemv_kernel(cobraml::core::INT32, 128, 512));
+
+    ASSERT_THROW(cobraml::core::calibrate_gemv(cobraml::core::FLOAT16, 70, 300), std::runtime_error);
+    ASSERT_THROW(cobraml::core::calibrate_gemv(cobraml::core::INVALID, 70, 300), std::runtime_error);
+    ASSERT_THROW(cobraml::core::calibrate_gemv(cobraml::core::FLOAT32, 0, 300), std::runtime_error);
+    cobraml::core::clear_tuning();
+}
+
+TEST(TuningTest, test_autotuned_gemv) {
+    cobraml::core::clear_tuning();
+
+    const auto mat{random_matrix<float>(97, 131)};
+    const auto vec{random_matrix<float>(1, 131)};
+    cobraml::core::Matrix expected(1, 97, cobraml::core::CPU, cobraml::core::FLOAT32);
+    gemv(mat, vec, expected, 1.0f, 0.0f);
+
+    cobraml::core::set_autotuning(true);
+
+    // the tuning run must not leak into the result, beta reads it back
+    cobraml::core::Matrix result(1, 97, cobraml::core::CPU, cobraml::core::FLOAT32);
+    gemv(mat, vec, result, 1.0f, 0.0f);
+    gemv(mat, vec, result, 1.0f, 1.0f);
+
+    cobraml::core::set_autotuning(false);
+
+    ASSERT_TRUE(kernel_names.count(cobraml::core::tuned_gemv_kernel(cobraml::core::FLOAT32, 97, 131)));
+
+    for (size_t i = 0; i < 97; ++i) {
+        ASSERT_EQ(result[i].item<float>(), 2 * expected[i].item<float>());
+    }
+
+    cobraml::core::clear_tuning();
+}
+
+TEST(TuningTest, test_unwritable_tuning_file) {
+    std::string const path{testing::TempDir() + "missing_directory/gemv_tuning.txt"};
+
+    cobraml::core::clear_tuning();
+    cobraml::core::set_tuning_file(path);
+
+    const auto mat{random_matrix<float>(45, 77)};
+    const auto vec{random_matrix<float>(1, 77)};
+    cobraml::core::Matrix result(1, 45, cobraml::core::CPU, cobraml::core::FLOAT32);
+
+    // autotuning still works in memory
+    cobraml::core::set_autotuning(true);
+    ASSERT_NO_THROW(gemv(mat, vec, result, 1.0f, 0.0f));
+    cobraml::core::set_autotuning(false);
+    ASSERT_TRUE(kernel_names.count(cobraml::core::tuned_gemv_kernel(cobraml::core::FLOAT32, 45, 77)));
+
+    // an explicit calibration reports the failure
+    ASSERT_THROW(cobraml::core::calibrate_gemv(cobraml::core::INT16, 45, 77), std::runtime_error);
+
+    cobraml::core::set_tuning_file("");
+    cobraml::core::clear_tuning();
+}
+
+TEST(TuningTest, test_tuning_file) {
+    std::string const path{testing::TempDir() + "gemv_tuning.txt"};
+    std::remove(path.c_str());
+
+    cobraml::core::clear_tuning();
+    cobraml::core::set_tuning_file(path);
+    cobraml::core::calibrate_gemv(cobraml::core::FLOAT64, 33, 65);
+    std::string const tuned{cobraml::core::tuned_gemv_kernel(cobraml::core::FLOAT64, 33, 65)};
+
+    {
+        // entries from other builds are ignored
+        std::ofstream out(path, std::ios::app);
+        out << "FLOAT64 1 1 1 gemv_unknown\n";
+        out << "garbage\n";
+    }
+
+    cobraml::core::set_tuning_file("");
+    cobraml::core::clear_tuning();
+    ASSERT_EQ(cobraml::core::tuned_gemv_kernel(cobraml::core::FLOAT64, 1, 1), "gemv_blocked_2_tiled");
+
+    cobraml::core::set_tuning_file(path);
+    ASSERT_EQ(cobraml::core::tuned_gemv_kernel(cobraml::core::FLOAT64, 33, 65), tuned);
+    ASSERT_EQ(cobraml::core::tuned_gemv_kernel(cobraml::core::FLOAT64, 1, 1), "gemv_blocked_2_tiled");
+
+    cobraml::core::set_tuning_file("");
+    cobraml::core::clear_tuning();
+    std::remove(path.c_str());
+}
+
+template<typename T>
+static void check_every_kernel(size_t const rows, size_t const columns, bool const strided) {
+    std::string const path{testing::TempDir() + "gemv_kernels.txt"};
+    cobraml::core::Dtype const dtype{cobraml::core::get_dtype_from_type<T>::type};
+
+    size_t const threshold{cobraml::core::get_parallel_threshold()};
+    cobraml::core::set_parallel_threshold(0);
+    cobraml::core::set_thread_count(3);
+
+    // a view into a wider matrix, so the kernels have to step rows by the leading dimension
+    const auto wide{random_matrix<T>(rows + 1, columns + 5)};
+    const auto mat{strided ? wide.slice(1, rows + 1, 3, columns + 3) : random_matrix<T>(rows, columns)};
+    const auto vec{random_matrix<T>(1, columns)};
+
+    std::vector<T> expected(rows);
+    for (size_t i = 0; i < rows; ++i) {
+        T dot = 0;
+        for (size_t j = 0; j < columns; ++j) {
+            dot = static_cast<T>(dot + mat[i][j].template item<T>() * vec[j].template item<T>());
+        }
+        expected[i] = static_cast<T>(dot * 2 + 1);
+    }
+
+    size_t rows_bucket{0}, columns_bucket{0};
+    while ((1UL << rows_bucket) < rows) ++rows_bucket;
+    while ((1UL << columns_bucket) < columns) ++columns_bucket;
+
+    for (const auto &name: kernel_names) {
+        {
+            std::ofstream out(path, std::ios::trunc);
+            out << cobraml::core::dtype_to_string(dtype) << ' ' << rows_bucket << ' ' << columns_bucket << " 3 "
+                    << name << '\n';
+        }
+
+        cobraml::core::clear_tuning();
+        cobraml::core::set_tuning_file(path);
+        ASSERT_EQ(cobraml::core::tuned_gemv_kernel(dtype, rows, columns), name);
+
+        std::vector ones(1, std::vector<T>(rows, 1));
+        auto result{cobraml::core::from_vector(ones, cobraml::core::CPU)};
+        gemv(mat, vec, result, static_cast<T>(2), static_cast<T>(1));
+
+        for (size_t i = 0; i < rows; ++i) {
+            ASSERT_EQ(result[i].template item<T>(), expected[i]) << name << " row " << i;
+        }
+    }
+
+    cobraml::core::set_tuning_file("");
+    cobraml::core::clear_tuning();
+    std::remove(path.c_str());
+
+    cobraml::core::set_thread_count(0);
+    cobraml::core::set_parallel_threshold(threshold);
+}
+
+TEST(TuningTest, test_kernels_agree) {
+    // row counts off every block size, and rows wide enough to span several column tiles
+    for (bool const strided: {false, true}) {
+        check_every_kernel<float>(37, 131, strided);
+        check_every_kernel<double>(13, 5000, strided);
+        check_every_kernel<int32_t>(29, 9000, strided);
+        check_every_kernel<int16_t>(7, 300, strided);
+        check_every_kernel<int8_t>(11, 20000, strided);
+    }
+}